@@ -1,17 +1,27 @@
 #include "benchmark/benchmark_engine.hpp"
 #include <iostream>
+#include <string>
 
 int main(int argc, char* argv[]) {
   if (argc < 2) {
     std::cerr << "Usage: " << (argc > 0 ? argv[0] : "benchmark")
-              << " --config <config.json>\n";
+              << " --config <config.json> [--jobs N] [--pin] [--perf]\n";
     return 1;
   }
   std::string config_path;
-  for (int i = 1; i < argc - 1; ++i) {
-    if (std::string(argv[i]) == "--config") {
-      config_path = argv[i + 1];
-      break;
+  int jobs = 1;
+  bool pin = false;
+  bool perf = false;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--config" && i + 1 < argc) {
+      config_path = argv[++i];
+    } else if (arg == "--jobs" && i + 1 < argc) {
+      jobs = std::stoi(argv[++i]);
+    } else if (arg == "--pin") {
+      pin = true;
+    } else if (arg == "--perf") {
+      perf = true;
     }
   }
   if (config_path.empty()) {
@@ -19,6 +29,9 @@ int main(int argc, char* argv[]) {
     return 1;
   }
   pbs::BenchmarkEngine engine;
+  engine.set_jobs(jobs);
+  engine.set_pin_workers(pin);
+  engine.set_perf_counters(perf);
   engine.run(config_path);
   return 0;
 }
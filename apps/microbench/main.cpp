@@ -0,0 +1,698 @@
+// Component micro-benchmarks. Prints one JSON object with a section per bench.
+#include "environment/rasterizer.hpp"
+#include "environment/environment_decorator.hpp"
+#include "environment/free_space.hpp"
+#include "environment/map_generator.hpp"
+#include "environment/se2_environment.hpp"
+#include "planners/csr_graph.hpp"
+#include "planners/fmt_star.hpp"
+#include "planners/prm.hpp"
+#include "planners/roadmap.hpp"
+#include "planners/spars.hpp"
+#include "planners/rrt_star.hpp"
+#include "planners/rrt_tree.hpp"
+#include "planners/sampler.hpp"
+#include "planners/steering.hpp"
+#include "planners/visibility_graph_planner.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <queue>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point t0) {
+  return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// Keeps results observable so the timed loops are not optimized away.
+volatile double g_sink = 0;
+
+nlohmann::json bench_steering(int n) {
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> uxy(0, 50), uth(0, 2 * M_PI);
+  std::vector<pbs::State> from, to;
+  for (int i = 0; i < n; ++i) {
+    from.emplace_back(uxy(rng), uxy(rng), uth(rng));
+    to.emplace_back(uxy(rng), uxy(rng), uth(rng));
+  }
+  const size_t tree_size = 1000;
+  std::vector<double> xs, ys, ths;
+  for (size_t i = 0; i < tree_size; ++i) {
+    xs.push_back(uxy(rng)); ys.push_back(uxy(rng)); ths.push_back(uth(rng));
+  }
+
+  nlohmann::json out = nlohmann::json::object();
+  for (const char* name : {"straight", "dubins", "reeds_shepp"}) {
+    auto steer = pbs::make_steering(name, 2.0);
+    nlohmann::json r;
+
+    auto t0 = Clock::now();
+    double acc = 0;
+    for (int i = 0; i < n; ++i) acc += steer->distance(from[i], to[i]);
+    r["distance_calls_per_s"] = n / seconds_since(t0);
+
+    const int queries = std::max(1, n / 100);
+    std::vector<double> d(tree_size);
+    t0 = Clock::now();
+    for (int i = 0; i < queries; ++i) {
+      steer->distances_to(xs.data(), ys.data(), ths.data(), tree_size, to[i], d.data());
+      acc += d[0];
+    }
+    r["batched_distances_per_s"] = static_cast<double>(queries) * tree_size / seconds_since(t0);
+
+    t0 = Clock::now();
+    for (int i = 0; i < queries; ++i)
+      acc += static_cast<double>(steer->nearest(xs.data(), ys.data(), ths.data(), tree_size, to[i]));
+    r["nearest_queries_per_s"] = queries / seconds_since(t0);
+    r["nearest_tree_size"] = tree_size;
+
+    const int interp = std::max(1, n / 10);
+    t0 = Clock::now();
+    for (int i = 0; i < interp; ++i)
+      acc += static_cast<double>(steer->interpolate(from[i], to[i], 0.1).size());
+    r["interpolate_calls_per_s"] = interp / seconds_since(t0);
+
+    g_sink = acc;
+    out[name] = r;
+  }
+  return out;
+}
+
+// n random triangles in a 100x100 world, rasterized at several resolutions
+// with one thread and with all hardware threads.
+nlohmann::json bench_raster(int n) {
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<double> uc(0, 100), ud(-3, 3);
+  std::vector<pbs::Polygon> obstacles;
+  for (int i = 0; i < n; ++i) {
+    double cx = uc(rng), cy = uc(rng);
+    obstacles.emplace_back(std::vector<pbs::Point2D>{
+        {cx + ud(rng), cy + ud(rng)}, {cx + ud(rng), cy + ud(rng)}, {cx + ud(rng), cy + ud(rng)}});
+  }
+  pbs::ContinuousEnvironment env(0, 100, 0, 100, std::move(obstacles));
+
+  nlohmann::json out = nlohmann::json::array();
+  for (double res : {1.0, 0.25, 0.05}) {
+    for (int threads : {1, 0}) {
+      auto t0 = Clock::now();
+      auto r = pbs::rasterize(env, res, pbs::RasterCoverage::Conservative, threads);
+      double ms = seconds_since(t0) * 1e3;
+      out.push_back({{"resolution", res}, {"threads", threads},
+                     {"cells", r.mapping.width * r.mapping.height}, {"ms", ms},
+                     {"mcells_per_s", r.mapping.width * r.mapping.height / ms * 1e-3}});
+    }
+  }
+  return out;
+}
+
+// SE2 footprint checks: a 3 x 1 car (72 headings) among n random triangles
+// in a 100x100 world; random poses, and random edges about 2 units long
+// with up to 45 degrees of turn, in checks per millisecond.
+nlohmann::json bench_se2(int n) {
+  std::mt19937 rng(13);
+  std::uniform_real_distribution<double> uc(0, 100), ud(-3, 3), uth(0, 2 * M_PI);
+  std::vector<pbs::Polygon> obstacles;
+  for (int i = 0; i < 200; ++i) {
+    double cx = uc(rng), cy = uc(rng);
+    obstacles.emplace_back(std::vector<pbs::Point2D>{
+        {cx + ud(rng), cy + ud(rng)}, {cx + ud(rng), cy + ud(rng)}, {cx + ud(rng), cy + ud(rng)}});
+  }
+  auto base = std::make_shared<pbs::ContinuousEnvironment>(0, 100, 0, 100, std::move(obstacles));
+  pbs::Polygon car({{-1.5, -0.5}, {1.5, -0.5}, {1.5, 0.5}, {-1.5, 0.5}});
+  pbs::SE2Environment env(base, car, 72);
+
+  std::vector<pbs::State> poses, ends;
+  std::uniform_real_distribution<double> step(-1.4, 1.4), turn(-M_PI / 4, M_PI / 4);
+  for (int i = 0; i < n; ++i) {
+    pbs::State a(uc(rng), uc(rng), uth(rng));
+    double th = std::fmod(*a.theta + turn(rng) + 2 * M_PI, 2 * M_PI);
+    poses.push_back(a);
+    ends.emplace_back(a.x + step(rng), a.y + step(rng), th);
+  }
+
+  int valid = 0;
+  auto t0 = Clock::now();
+  for (const auto& p : poses) valid += env.is_valid(p) ? 1 : 0;
+  const double pose_ms = seconds_since(t0) * 1e3;
+  const int edges = std::max(1, n / 10);
+  int free = 0;
+  t0 = Clock::now();
+  for (int i = 0; i < edges; ++i) free += env.collision_free(poses[i], ends[i]) ? 1 : 0;
+  const double edge_ms = seconds_since(t0) * 1e3;
+  g_sink = valid + free;
+  return {{"obstacles", 200},
+          {"headings", env.num_headings()},
+          {"heading_margin", env.heading_margin()},
+          {"pose_checks_per_ms", n / pose_ms},
+          {"valid_fraction", static_cast<double>(valid) / n},
+          {"edge_checks_per_ms", edges / edge_ms},
+          {"free_edge_fraction", static_cast<double>(free) / edges}};
+}
+
+// Visibility graph over n random triangles: sweep construction time and
+// per-query time (start/goal sweeps plus A*).
+nlohmann::json bench_visibility_graph(int n) {
+  std::mt19937 rng(11);
+  const int side = std::max(1, static_cast<int>(std::ceil(std::sqrt(n))));
+  std::uniform_real_distribution<double> ud(-0.3, 0.3);
+  std::vector<pbs::Polygon> obstacles;
+  for (int i = 0; i < n; ++i) {
+    double cx = (i % side) + 0.5, cy = (i / side) + 0.5;
+    obstacles.emplace_back(std::vector<pbs::Point2D>{
+        {cx - 0.35 + ud(rng) * 0.2, cy - 0.3 + ud(rng) * 0.2},
+        {cx + 0.35 + ud(rng) * 0.2, cy - 0.25 + ud(rng) * 0.2},
+        {cx + ud(rng), cy + 0.35 + ud(rng) * 0.2}});
+  }
+  pbs::ContinuousEnvironment env(0, side, 0, side, std::move(obstacles));
+
+  auto t0 = Clock::now();
+  auto graph = pbs::VisibilityGraphPlanner::graph_for(env);
+  double build_ms = seconds_since(t0) * 1e3;
+
+  pbs::VisibilityGraphPlanner planner;
+  const int queries = 20;
+  double acc = 0;
+  t0 = Clock::now();
+  for (int q = 0; q < queries; ++q)
+    acc += planner.solve(env, pbs::State(0.02, 0.02 + q * 0.001),
+                         pbs::State(side - 0.02, side - 0.02)).length;
+  g_sink = acc;
+  return {{"obstacles", n}, {"vertices", graph->num_vertices()},
+          {"edges", graph->num_edges()}, {"build_ms", build_ms},
+          {"query_ms", seconds_since(t0) * 1e3 / queries}};
+}
+
+// RRT* time per iteration as the tree grows, and the cost of a rewire with
+// child-list propagation against the old scan over every node's parent.
+nlohmann::json bench_rrt_tree(int n) {
+  pbs::ContinuousEnvironment env(0, 100, 0, 100, {});
+  nlohmann::json growth = nlohmann::json::array();
+  double prev_ms = 0;
+  int prev_iter = 0;
+  for (int iters : {n / 4, n / 2, n}) {
+    pbs::RRTStarPlanner planner(1.0, 0.05, iters, 10.0);
+    auto t0 = Clock::now();
+    g_sink = planner.solve(env, pbs::State(1.0, 1.0), pbs::State(99.0, 99.0)).length;
+    double ms = seconds_since(t0) * 1e3;
+    growth.push_back({{"iterations", iters}, {"nodes", planner.nodes_expanded()}, {"ms", ms},
+                      {"us_per_iter_marginal", (ms - prev_ms) * 1e3 / (iters - prev_iter)}});
+    prev_ms = ms;
+    prev_iter = iters;
+  }
+
+  nlohmann::json rewire = nlohmann::json::array();
+  std::mt19937 rng(5);
+  for (int size : {n / 4, n / 2, n}) {
+    pbs::RRTTree tree;
+    std::vector<size_t> parent{0};
+    std::vector<double> cost{0.0};
+    tree.add(0, 0, 0, pbs::RRTTree::kNone, 0.0);
+    for (int i = 1; i < size; ++i) {
+      size_t p = std::uniform_int_distribution<size_t>(0, i - 1)(rng);
+      tree.add(0, 0, 0, p, cost[p] + 1.0);
+      parent.push_back(p);
+      cost.push_back(cost[p] + 1.0);
+    }
+    // Rewires (i, new parent) with the new parent outside i's current
+    // subtree; the same sequence is replayed on the parent-scan copy.
+    std::vector<std::pair<size_t, size_t>> ops;
+    std::uniform_int_distribution<size_t> pick(1, size - 1);
+    Clock::duration list_time{};
+    while (ops.size() < 50) {
+      size_t i = pick(rng), np = pick(rng);
+      size_t a = np;
+      while (a != 0 && a != i) a = tree.parent(a);
+      if (a == i) continue;
+      ops.push_back({i, np});
+      auto t0 = Clock::now();
+      tree.rewire(i, np, tree.cost(i) - 0.5);
+      list_time += Clock::now() - t0;
+    }
+    double list_us = std::chrono::duration<double, std::micro>(list_time).count() / ops.size();
+
+    auto t0 = Clock::now();
+    std::vector<size_t> stack;
+    for (auto [i, np] : ops) {
+      const double delta = 0.5;
+      parent[i] = np;
+      cost[i] -= delta;
+      stack.assign(1, i);
+      while (!stack.empty()) {
+        size_t u = stack.back(); stack.pop_back();
+        for (size_t j = 1; j < parent.size(); ++j)
+          if (parent[j] == u) { cost[j] -= delta; stack.push_back(j); }
+      }
+    }
+    double scan_us = seconds_since(t0) * 1e6 / ops.size();
+    g_sink = tree.cost(size - 1) + cost[size - 1];
+    rewire.push_back({{"tree_size", size}, {"child_list_us", list_us},
+                      {"parent_scan_us", scan_us}});
+  }
+  return {{"rrt_star_growth", growth}, {"rewire", rewire}};
+}
+
+// Counts collision queries reaching the wrapped scene.
+class CountingEnvironment : public pbs::EnvironmentDecorator {
+ public:
+  using EnvironmentDecorator::EnvironmentDecorator;
+  bool is_valid(const pbs::State& s) const override {
+    ++point_checks;
+    return inner_->is_valid(s);
+  }
+  bool collision_free(const pbs::State& a, const pbs::State& b) const override {
+    ++edge_checks;
+    return inner_->collision_free(a, b);
+  }
+  mutable long point_checks = 0, edge_checks = 0;
+};
+
+// FMT*, PRM and RRT* at equal sample counts (n samples / iterations) on a
+// field of random triangles: wall time, collision queries and path cost.
+nlohmann::json bench_fmt_star(int n) {
+  std::mt19937 rng(13);
+  std::uniform_real_distribution<double> uc(5, 95), ud(-4, 4);
+  std::vector<pbs::Polygon> obstacles;
+  for (int i = 0; i < 60; ++i) {
+    double cx = uc(rng), cy = uc(rng);
+    obstacles.emplace_back(std::vector<pbs::Point2D>{
+        {cx + ud(rng), cy + ud(rng)}, {cx + ud(rng), cy + ud(rng)}, {cx + ud(rng), cy + ud(rng)}});
+  }
+  auto scene = std::make_shared<pbs::ContinuousEnvironment>(0, 100, 0, 100, std::move(obstacles));
+  const pbs::State start(1.0, 1.0), goal(99.0, 99.0);
+
+  pbs::FMTStarPlanner fmt(n);
+  pbs::PRMPlanner prm(n, 10);
+  pbs::RRTStarPlanner rrt_star(3.0, 0.05, n, 30.0);
+  const std::pair<const char*, pbs::IPlanner*> planners[] = {
+      {"fmt_star", &fmt}, {"prm", &prm}, {"rrt_star", &rrt_star}};
+  nlohmann::json out = nlohmann::json::object();
+  for (const auto& [name, planner] : planners) {
+    CountingEnvironment env(scene);
+    auto t0 = Clock::now();
+    pbs::Path path = planner->solve(env, start, goal);
+    out[name] = {{"samples", n}, {"ms", seconds_since(t0) * 1e3},
+                 {"edge_checks", env.edge_checks}, {"point_checks", env.point_checks},
+                 {"success", path.success}, {"path_length", path.length}};
+  }
+  return out;
+}
+
+// L2-star discrepancy of points in [0, 1)^2 (Warnock's closed form).
+double l2_star_discrepancy(const std::vector<double>& u, const std::vector<double>& v) {
+  const size_t n = u.size();
+  double single = 0, pairs = 0;
+  for (size_t i = 0; i < n; ++i) {
+    single += (1 - u[i] * u[i]) * (1 - v[i] * v[i]);
+    for (size_t j = 0; j < n; ++j)
+      pairs += (1 - std::max(u[i], u[j])) * (1 - std::max(v[i], v[j]));
+  }
+  const double nn = static_cast<double>(n);
+  return std::sqrt(std::max(0.0, 1.0 / 9.0 - single / (2 * nn) + pairs / (nn * nn)));
+}
+
+// Sampler throughput (one point per call vs. next_block) and the uniformity
+// of the first 1024 points of each sequence.
+nlohmann::json bench_samplers(int n) {
+  nlohmann::json out = nlohmann::json::object();
+  for (const char* type : {"mt19937", "xoshiro", "halton", "sobol", "scrambled_sobol"}) {
+    const pbs::SamplerConfig config{type, 42};
+    std::vector<double> u(n), v(n);
+    auto sampler = pbs::make_sampler(config);
+    auto t0 = Clock::now();
+    for (int i = 0; i < n; ++i) sampler->next(u[i], v[i]);
+    double single_s = seconds_since(t0);
+    g_sink = u[n - 1] + v[n - 1];
+
+    sampler = pbs::make_sampler(config);
+    t0 = Clock::now();
+    sampler->next_block(u.data(), v.data(), u.size());
+    double block_s = seconds_since(t0);
+    g_sink = u[n - 1] + v[n - 1];
+
+    const size_t m = std::min<size_t>(1024, u.size());
+    out[type] = {{"points", n},
+                 {"mpoints_per_s", n / std::max(single_s, 1e-12) * 1e-6},
+                 {"block_mpoints_per_s", n / std::max(block_s, 1e-12) * 1e-6},
+                 {"l2_star_discrepancy_1024",
+                  l2_star_discrepancy({u.begin(), u.begin() + m}, {v.begin(), v.begin() + m})}};
+  }
+  return out;
+}
+
+// Collecting 20000 valid samples by rejection vs. free-space sampling on a
+// dense random grid (n x n, 60% blocked) and a scene of n random triangles.
+nlohmann::json bench_free_space(int n) {
+  pbs::MapGeneratorParams mgp;
+  mgp.width = mgp.height = n;
+  mgp.obstacle_density = 0.6;
+  mgp.seed = 5;
+  auto grid = std::make_shared<pbs::GridEnvironment>(pbs::MapGenerator(5).generate(mgp));
+
+  std::mt19937 rng(17);
+  std::uniform_real_distribution<double> uc(5, 95), ud(-8, 8);
+  std::vector<pbs::Polygon> obstacles;
+  for (int i = 0; i < n; ++i) {
+    double cx = uc(rng), cy = uc(rng);
+    obstacles.emplace_back(std::vector<pbs::Point2D>{
+        {cx + ud(rng), cy + ud(rng)}, {cx + ud(rng), cy + ud(rng)}, {cx + ud(rng), cy + ud(rng)}});
+  }
+  auto scene = std::make_shared<pbs::ContinuousEnvironment>(0, 100, 0, 100, std::move(obstacles));
+
+  const int samples = 20000;
+  const std::pair<const char*, std::shared_ptr<const pbs::IEnvironment>> envs[] = {
+      {"grid", grid}, {"polygons", scene}};
+  nlohmann::json out = nlohmann::json::object();
+  for (const auto& [name, env] : envs) {
+    double x_min = 0, x_max = 0, y_min = 0, y_max = 0;
+    env->get_bounds(x_min, x_max, y_min, y_max);
+    auto sampler = pbs::make_sampler({"xoshiro", 42});
+
+    CountingEnvironment counting(env);
+    auto t0 = Clock::now();
+    for (int k = 0; k < samples;) {
+      double u = 0, v = 0;
+      sampler->next(u, v);
+      pbs::State s(x_min + u * (x_max - x_min), y_min + v * (y_max - y_min));
+      if (counting.is_valid(s)) { g_sink = s.x; ++k; }
+    }
+    double rejection_ms = seconds_since(t0) * 1e3;
+
+    t0 = Clock::now();
+    auto free_space = pbs::free_space_sampler(*env);
+    double build_ms = seconds_since(t0) * 1e3;
+    t0 = Clock::now();
+    for (int k = 0; k < samples; ++k) {
+      double u = 0, v = 0, x = 0, y = 0;
+      sampler->next(u, v);
+      free_space->map(u, v, x, y);
+      g_sink = x + y;
+    }
+    double free_ms = seconds_since(t0) * 1e3;
+    out[name] = {{"samples", samples},
+                 {"free_fraction", free_space->free_fraction()},
+                 {"rejection_ms", rejection_ms},
+                 {"rejection_point_checks", counting.point_checks},
+                 {"free_space_build_ms", build_ms},
+                 {"free_space_ms", free_ms}};
+  }
+  return out;
+}
+
+// PRM build vs. query: one n-sample roadmap on a scene of random triangles,
+// then 200 random queries against it, build thread scaling, save/load of the
+// roadmap file, and a SPARS spanner answering the same queries.
+nlohmann::json bench_roadmap(int n) {
+  std::mt19937 rng(23);
+  std::uniform_real_distribution<double> uc(5, 95), ud(-6, 6), uq(0, 100);
+  std::vector<pbs::Polygon> obstacles;
+  for (int i = 0; i < 60; ++i) {
+    double cx = uc(rng), cy = uc(rng);
+    obstacles.emplace_back(std::vector<pbs::Point2D>{
+        {cx + ud(rng), cy + ud(rng)}, {cx + ud(rng), cy + ud(rng)}, {cx + ud(rng), cy + ud(rng)}});
+  }
+  pbs::ContinuousEnvironment scene(0, 100, 0, 100, std::move(obstacles));
+
+  pbs::PRMPlanner prm(n, 10);
+  auto t0 = Clock::now();
+  auto roadmap = prm.roadmap(scene);
+  double build_ms = seconds_since(t0) * 1e3;
+
+  const int queries = 200;
+  std::vector<std::pair<pbs::State, pbs::State>> pairs;
+  while (static_cast<int>(pairs.size()) < queries) {
+    pbs::State s(uq(rng), uq(rng)), g(uq(rng), uq(rng));
+    if (scene.is_valid(s) && scene.is_valid(g)) pairs.push_back({s, g});
+  }
+  int solved = 0;
+  std::vector<double> lengths(queries, -1.0);
+  t0 = Clock::now();
+  for (int q = 0; q < queries; ++q) {
+    pbs::Path path = prm.query(*roadmap, scene, pairs[q].first, pairs[q].second);
+    solved += path.success ? 1 : 0;
+    if (path.success) lengths[q] = path.length;
+  }
+  double query_ms = seconds_since(t0) * 1e3 / queries;
+
+  // Sparse spanner over the same scene and queries.
+  pbs::SPARSPlanner spars(20 * n);
+  t0 = Clock::now();
+  auto sparse = spars.roadmap(scene);
+  double spars_build_ms = seconds_since(t0) * 1e3;
+  int spars_solved = 0;
+  std::vector<double> spars_lengths(queries, -1.0);
+  t0 = Clock::now();
+  for (int q = 0; q < queries; ++q) {
+    pbs::Path path = spars.query(*sparse, scene, pairs[q].first, pairs[q].second);
+    spars_solved += path.success ? 1 : 0;
+    if (path.success) spars_lengths[q] = path.length;
+  }
+  double spars_query_ms = seconds_since(t0) * 1e3 / queries;
+  // Path length relative to PRM over the queries both solved.
+  double ratio_sum = 0;
+  int both = 0;
+  for (int q = 0; q < queries; ++q)
+    if (lengths[q] > 0 && spars_lengths[q] > 0) {
+      ratio_sum += spars_lengths[q] / lengths[q];
+      ++both;
+    }
+
+  // Build scaling; every thread count yields the same roadmap.
+  nlohmann::json scaling = nlohmann::json::array();
+  for (int threads : {1, 2, 4, 8}) {
+    auto sampler = pbs::make_sampler({"mt19937", 42});
+    auto r = pbs::Roadmap::build(scene, n, 10, *sampler, nullptr, threads);
+    const auto& bt = r->timings();
+    scaling.push_back({{"threads", threads}, {"build_ms", r->build_ms()},
+                       {"sample_ms", bt.sample_ms}, {"knn_ms", bt.knn_ms},
+                       {"connect_ms", bt.connect_ms}, {"layout_ms", bt.layout_ms},
+                       {"edges", r->num_edges()}});
+  }
+
+  const std::string file = "microbench_roadmap.bin";
+  roadmap->save(file);
+  t0 = Clock::now();
+  auto loaded = pbs::Roadmap::load(file);
+  double load_ms = seconds_since(t0) * 1e3;
+  std::remove(file.c_str());
+  return {{"samples", n},
+          {"nodes", roadmap->num_nodes()},
+          {"edges", roadmap->num_edges()},
+          {"build_ms", build_ms},
+          {"build_scaling", scaling},
+          {"queries", queries},
+          {"solved", solved},
+          {"query_ms", query_ms},
+          {"file_bytes", roadmap->data_bytes()},
+          {"load_ms", load_ms},
+          {"mapped", loaded && loaded->mapped()},
+          {"spars", {{"nodes", sparse->num_nodes()},
+                     {"edges", sparse->num_edges()},
+                     {"file_bytes", sparse->data_bytes()},
+                     {"build_ms", spars_build_ms},
+                     {"query_ms", spars_query_ms},
+                     {"solved", spars_solved},
+                     {"mean_length_ratio", both > 0 ? ratio_sum / both : 0.0}}}};
+}
+
+// Tree storage in double and float32 at n nodes: arena bytes, insertion,
+// nearest-neighbour and radius scans (the RRT* inner loops) and rewires.
+template <class Tree>
+nlohmann::json tree_storage_run(int n) {
+  std::mt19937 rng(9);
+  std::uniform_real_distribution<double> u(0, 1000);
+  using Real = typename Tree::Scalar;
+  Tree tree;
+  auto t0 = Clock::now();
+  tree.add(u(rng), u(rng), 0, Tree::kNone, 0.0);
+  for (int i = 1; i < n; ++i) {
+    size_t p = std::uniform_int_distribution<size_t>(0, i - 1)(rng);
+    tree.add(u(rng), u(rng), 0, p, tree.cost(p) + 1.0);
+  }
+  const double insert_ms = seconds_since(t0) * 1e3;
+
+  const int scans = 20;
+  t0 = Clock::now();
+  size_t hits = 0;
+  for (int q = 0; q < scans; ++q) {
+    const Real sx = static_cast<Real>(u(rng)), sy = static_cast<Real>(u(rng));
+    const Real* xs = tree.xs();
+    const Real* ys = tree.ys();
+    Real best = std::numeric_limits<Real>::max();
+    size_t best_i = 0;
+    for (size_t i = 0; i < tree.size(); ++i) {
+      Real dx = sx - xs[i], dy = sy - ys[i];
+      Real d2 = dx * dx + dy * dy;
+      if (d2 < best) { best = d2; best_i = i; }
+    }
+    hits += best_i;
+  }
+  const double nn_ms = seconds_since(t0) * 1e3 / scans;
+
+  t0 = Clock::now();
+  for (int q = 0; q < scans; ++q) {
+    const Real sx = static_cast<Real>(u(rng)), sy = static_cast<Real>(u(rng));
+    const Real r2 = 25;
+    const Real* xs = tree.xs();
+    const Real* ys = tree.ys();
+    for (size_t i = 0; i < tree.size(); ++i) {
+      Real dx = sx - xs[i], dy = sy - ys[i];
+      if (dx * dx + dy * dy <= r2) hits += static_cast<size_t>(tree.cost(i) > 0);
+    }
+  }
+  const double radius_ms = seconds_since(t0) * 1e3 / scans;
+
+  // Leaf rewires: reparenting plus the cost write, no subtree walk.
+  std::vector<size_t> leaves;
+  for (size_t i = 1; i < tree.size() && leaves.size() < 10000; ++i)
+    if (tree.first_child(i) == Tree::kNone) leaves.push_back(i);
+  t0 = Clock::now();
+  for (size_t i : leaves) tree.rewire(i, 0, tree.cost(i) * 0.5);
+  const double rewire_ns = seconds_since(t0) * 1e9 / std::max<size_t>(leaves.size(), 1);
+  g_sink = static_cast<double>(hits);
+  return {{"bytes", tree.memory_bytes()},
+          {"bytes_per_node", static_cast<double>(tree.memory_bytes()) / n},
+          {"insert_ms", insert_ms},
+          {"nn_scan_ms", nn_ms},
+          {"radius_scan_ms", radius_ms},
+          {"rewire_ns", rewire_ns}};
+}
+
+nlohmann::json bench_tree_storage(int n) {
+  return {{"nodes", n},
+          {"double", tree_storage_run<pbs::RRTTree>(n)},
+          {"float", tree_storage_run<pbs::CompactRRTTree>(n)}};
+}
+
+// Roadmap graph storage: the former vector-of-vectors adjacency (size_t
+// targets, double weights) against CSRGraph, on a kNN graph of n random
+// points (k = 10). Reports bytes per edge and Dijkstra throughput.
+nlohmann::json bench_csr_graph(int n) {
+  std::mt19937 rng(31);
+  std::uniform_real_distribution<double> u(0, 100);
+  std::vector<pbs::Point2D> pts;
+  for (int i = 0; i < n; ++i) pts.emplace_back(u(rng), u(rng));
+  pbs::KdTree2D tree;
+  tree.build(pts);
+
+  std::vector<std::vector<std::pair<size_t, double>>> nested(pts.size());
+  pbs::CSRGraphBuilder builder(static_cast<uint32_t>(pts.size()));
+  size_t m = 0;
+  for (size_t i = 0; i < pts.size(); ++i)
+    for (size_t j : tree.k_nearest(pts[i], 11)) {
+      if (j == i) continue;
+      const double w = std::hypot(pts[j].x - pts[i].x, pts[j].y - pts[i].y);
+      nested[i].push_back({j, w});
+      builder.add(0, static_cast<uint32_t>(i), static_cast<uint32_t>(j), static_cast<float>(w));
+      ++m;
+    }
+  const pbs::CSRGraph csr = builder.build(false, true);
+  // Heap blocks are counted at their capacity; allocator headers are not.
+  size_t nested_bytes = nested.capacity() * sizeof(nested[0]);
+  for (const auto& row : nested) nested_bytes += row.capacity() * sizeof(row[0]);
+
+  using Item = std::pair<double, size_t>;
+  auto dijkstra = [&](auto&& for_each_edge, size_t source) {
+    std::vector<double> dist(pts.size(), 1e99);
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> pq;
+    dist[source] = 0;
+    pq.push({0, source});
+    size_t relaxed = 0;
+    while (!pq.empty()) {
+      auto [d, v] = pq.top();
+      pq.pop();
+      if (d > dist[v]) continue;
+      for_each_edge(v, [&](size_t t, double w) {
+        ++relaxed;
+        if (d + w < dist[t]) {
+          dist[t] = d + w;
+          pq.push({d + w, t});
+        }
+      });
+    }
+    return relaxed;
+  };
+  const int searches = 20;
+  auto time_searches = [&](auto&& for_each_edge) {
+    size_t relaxed = 0;
+    auto t0 = Clock::now();
+    for (int s = 0; s < searches; ++s)
+      relaxed += dijkstra(for_each_edge, static_cast<size_t>(s) * pts.size() / searches);
+    const double sec = seconds_since(t0);
+    g_sink = static_cast<double>(relaxed);
+    return nlohmann::json{{"searches_per_s", searches / sec}, {"edges_per_s", relaxed / sec}};
+  };
+  nlohmann::json nested_search = time_searches([&](size_t v, auto&& relax) {
+    for (const auto& [t, w] : nested[v]) relax(t, w);
+  });
+  nlohmann::json csr_search = time_searches([&](size_t v, auto&& relax) {
+    const auto u = static_cast<uint32_t>(v);
+    for (uint64_t e = csr.begin(u); e < csr.end(u); ++e) relax(csr.target(e), csr.weight(e));
+  });
+  return {{"nodes", n},
+          {"edges", m},
+          {"nested", {{"bytes_per_edge", static_cast<double>(nested_bytes) / m},
+                      {"dijkstra", nested_search}}},
+          {"csr", {{"bytes_per_edge", static_cast<double>(csr.memory_bytes()) / m},
+                   {"dijkstra", csr_search}}}};
+}
+
+struct Bench {
+  const char* name;
+  nlohmann::json (*run)(int n);
+  int default_n;
+};
+
+const Bench kBenches[] = {
+  {"steering", bench_steering, 100000},
+  {"raster", bench_raster, 500},
+  {"se2", bench_se2, 200000},
+  {"visibility_graph", bench_visibility_graph, 300},
+  {"rrt_tree", bench_rrt_tree, 4000},
+  {"tree_storage", bench_tree_storage, 1000000},
+  {"fmt_star", bench_fmt_star, 2000},
+  {"samplers", bench_samplers, 1000000},
+  {"free_space", bench_free_space, 200},
+  {"roadmap", bench_roadmap, 5000},
+  {"csr_graph", bench_csr_graph, 20000},
+};
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::string which = "all";
+  int n = 0;
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    if (a == "--n" && i + 1 < argc) n = std::stoi(argv[++i]);
+    else if (a == "--help" || a == "-h") {
+      std::cerr << "Usage: " << argv[0] << " [all";
+      for (const auto& b : kBenches) std::cerr << "|" << b.name;
+      std::cerr << "] [--n N]\n";
+      return 0;
+    } else which = a;
+  }
+  nlohmann::json out = nlohmann::json::object();
+  bool found = false;
+  for (const auto& b : kBenches) {
+    if (which != "all" && which != b.name) continue;
+    found = true;
+    out[b.name] = b.run(n > 0 ? n : b.default_n);
+  }
+  if (!found) {
+    std::cerr << "Error: unknown bench " << which << "\n";
+    return 1;
+  }
+  std::cout << out.dump(2) << "\n";
+  return 0;
+}
@@ -6,7 +6,22 @@ namespace pbs {
 
 class BenchmarkEngine {
  public:
+  /// Experiment entries run concurrently on `jobs` workers (1 = in order on
+  /// the calling thread, 0 = one per hardware thread); results are written
+  /// in config order either way.
+  void set_jobs(int jobs) { jobs_ = jobs; }
+  /// Pin each worker to its own core (Linux) while it runs an entry, for
+  /// steadier timings. Entries with planner threads are left unpinned.
+  void set_pin_workers(bool pin) { pin_workers_ = pin; }
+  /// Read hardware counters around every timed solve (Linux perf_event_open)
+  /// unless an entry sets "perf_counters" itself.
+  void set_perf_counters(bool enabled) { perf_counters_ = enabled; }
   void run(const std::string& config_path);
+
+ private:
+  int jobs_ = 1;
+  bool pin_workers_ = false;
+  bool perf_counters_ = false;
 };
 
 }  // namespace pbs
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace pbs {
+
+class IEnvironment;
+
+struct EnvironmentLookup {
+  std::shared_ptr<const IEnvironment> env;
+  /// Time spent generating env in this lookup (0 on a hit).
+  double generation_ms = 0.0;
+  bool hit = false;
+};
+
+/// Environments generated for one benchmark run, keyed by a normalized
+/// description, so experiments on the same map share one instance and with
+/// it the preprocessing cached on the environment (rasterizations, free-space
+/// decompositions, roadmaps, visibility graphs). Entries are immutable once
+/// built and safe to share across worker threads. Each key is generated
+/// exactly once: concurrent lookups of a key wait for its generation, while
+/// different keys are generated in parallel.
+class EnvironmentCache {
+ public:
+  using Generate = std::function<std::shared_ptr<const IEnvironment>()>;
+
+  EnvironmentLookup get_or_generate(const std::string& key, const Generate& generate);
+
+  size_t size() const;
+  uint64_t hits() const;
+  /// Total generation time over all entries.
+  double generation_ms() const;
+
+ private:
+  struct Entry {
+    std::mutex mu;
+    std::shared_ptr<const IEnvironment> env;
+    double generation_ms = 0.0;
+  };
+
+  mutable std::mutex mu_;
+  std::unordered_map<std::string, std::shared_ptr<Entry>> entries_;
+  std::atomic<uint64_t> hits_{0};
+};
+
+}  // namespace pbs
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace pbs {
+
+enum class PerfEvent { Cycles, Instructions, L1dMisses, LlcMisses, BranchMisses };
+inline constexpr size_t kNumPerfEvents = 5;
+
+/// Result key for an event, e.g. "cycles", "llc_misses".
+const char* perf_event_name(PerfEvent event);
+
+/// One reading per event; counts are scaled up when the kernel multiplexed
+/// the group, and events that could not be opened stay invalid.
+struct PerfSample {
+  std::array<double, kNumPerfEvents> counts{};
+  std::array<bool, kNumPerfEvents> valid{};
+
+  double operator[](PerfEvent e) const { return counts[static_cast<size_t>(e)]; }
+  bool has(PerfEvent e) const { return valid[static_cast<size_t>(e)]; }
+};
+
+/// Hardware counters for the calling thread (user space only), opened with
+/// Linux perf_event_open as one group so all events cover the same
+/// interval. Events the CPU or kernel does not offer are dropped from the
+/// group. If none can be opened (no PMU in a VM, perf_event_paranoid,
+/// seccomp, other platforms) available() is false, error() says why, and
+/// start()/stop() do nothing. Threads spawned by the measured code are not
+/// counted.
+class PerfCounters {
+ public:
+  PerfCounters();
+  ~PerfCounters();
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  bool available() const { return leader_ >= 0; }
+  bool has(PerfEvent e) const { return fds_[static_cast<size_t>(e)] >= 0; }
+  const std::string& error() const { return error_; }
+
+  void start();
+  PerfSample stop();
+
+ private:
+  int leader_ = -1;
+  std::array<int, kNumPerfEvents> fds_;
+  std::array<size_t, kNumPerfEvents> slot_{};  // Position in the group read
+  size_t opened_ = 0;
+  std::string error_;
+};
+
+}  // namespace pbs
@@ -22,4 +22,9 @@ inline double std_dev(const std::vector<double>& v) {
 
 std::pair<double, double> confidence_interval_95(const std::vector<double>& v);
 
+double median(std::vector<double> v);
+/// Median absolute deviation from the median; unlike std_dev it ignores a
+/// few outliers (preempted or interrupted repeats).
+double median_abs_deviation(const std::vector<double>& v);
+
 }  // namespace pbs
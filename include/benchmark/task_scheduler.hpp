@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace pbs {
+
+/// Runs tasks 0..n-1 on a fixed set of worker threads with work stealing.
+/// Tasks are dealt round-robin into per-worker deques; a worker takes from
+/// the front of its own deque and, once that is empty, steals from the back
+/// of another's. fn(task, worker) runs on the worker thread, so anything it
+/// times is timed there. The first exception thrown by a task is rethrown
+/// from run() after all workers have stopped.
+class TaskScheduler {
+ public:
+  /// workers <= 0: one per hardware thread. With pin_to_cores, worker w is
+  /// bound to core w modulo the core count while it runs a task (Linux only;
+  /// ignored elsewhere).
+  explicit TaskScheduler(int workers, bool pin_to_cores = false);
+
+  int workers() const { return workers_; }
+  /// Tasks for which pinnable(task) is false run with the worker's unpinned
+  /// mask; use it for tasks that start threads, which would otherwise all
+  /// share the worker's core. Every mask is restored when run() returns.
+  void run(size_t num_tasks, const std::function<void(size_t task, int worker)>& fn,
+           const std::function<bool(size_t task)>& pinnable = nullptr) const;
+
+ private:
+  int workers_;
+  bool pin_;
+};
+
+}  // namespace pbs
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace pbs {
+
+enum class TimerSource { SteadyClock, Tsc };
+enum class CacheMode { Warm, Cold };
+
+std::string to_string(TimerSource source);
+std::string to_string(CacheMode mode);
+
+/// How an experiment times its solves.
+struct TimingOptions {
+  /// Untimed solves before the first timed repeat.
+  int warmup = 0;
+  /// Tsc reads the x86 time-stamp counter (invariant TSC assumed) and falls
+  /// back to the steady clock on other targets.
+  TimerSource timer = TimerSource::SteadyClock;
+  /// Cold: evict the CPU caches before every timed solve.
+  CacheMode cache = CacheMode::Warm;
+  /// Bytes streamed through by a flush; should exceed the last-level cache.
+  size_t flush_bytes = size_t{64} << 20;
+  /// Core the experiment thread is pinned to while it runs (-1 = no pinning).
+  int pin_core = -1;
+};
+
+/// Interval timer with calibrated read overhead. Construction measures the
+/// cost of an empty start/stop pair (the minimum over many trials), which
+/// stop() subtracts; for Tsc it also calibrates ticks per nanosecond
+/// against the steady clock.
+class SolveTimer {
+ public:
+  explicit SolveTimer(TimerSource source);
+
+  void start() { t0_ = now(); }
+  /// Milliseconds since start(), minus the calibrated overhead.
+  double stop_ms() const;
+
+  TimerSource source() const { return source_; }
+  double overhead_ns() const { return overhead_ns_; }
+  /// Tsc ticks per nanosecond (0 for the steady clock).
+  double ticks_per_ns() const { return ticks_per_ns_; }
+
+ private:
+  uint64_t now() const;
+  double to_ns(uint64_t ticks) const;
+
+  TimerSource source_;
+  double ticks_per_ns_ = 0.0;
+  double overhead_ns_ = 0.0;
+  uint64_t t0_ = 0;
+};
+
+/// Evicts data caches by writing and then reading a buffer larger than the
+/// last-level cache.
+class CacheFlusher {
+ public:
+  explicit CacheFlusher(size_t bytes);
+  void flush();
+
+ private:
+  std::unique_ptr<uint64_t[]> buffer_;
+  size_t words_;
+  uint64_t round_ = 0;
+  volatile uint64_t sink_ = 0;
+};
+
+/// Pins the calling thread to cores [core, core + count) (Linux
+/// sched_setaffinity) and restores its previous mask on destruction. Does
+/// nothing for core < 0, on other platforms, or when any of the cores is
+/// unavailable. Threads the pinned thread starts inherit its mask, so a
+/// parallel planner needs count >= its thread count.
+class ScopedAffinity {
+ public:
+  explicit ScopedAffinity(int core, int count = 1);
+  ~ScopedAffinity();
+  ScopedAffinity(const ScopedAffinity&) = delete;
+  ScopedAffinity& operator=(const ScopedAffinity&) = delete;
+
+  /// The first core the thread is pinned to, -1 if it is not.
+  int core() const { return core_; }
+  /// Number of cores in the mask, 0 if the thread is not pinned.
+  int count() const { return core_ < 0 ? 0 : count_; }
+
+ private:
+  int core_ = -1;
+  int count_ = 0;
+  std::unique_ptr<unsigned char[]> saved_;  // previous cpu_set_t
+};
+
+}  // namespace pbs
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "environment_decorator.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace pbs {
+
+struct CollisionCacheStats {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t inserts = 0;
+  uint64_t evictions = 0;
+
+  double hit_rate() const {
+    uint64_t total = hits + misses;
+    return total ? static_cast<double>(hits) / total : 0.0;
+  }
+};
+
+/// Memoizes collision_free() results of the wrapped environment.
+/// Lock-free open-addressing table of 64-bit slots keyed on quantized segment
+/// endpoints (direction-independent, theta included when present). Both free
+/// and blocked results are stored. Memory is fixed at construction; when a
+/// probe window is full the home slot is overwritten.
+class CachedEnvironment : public EnvironmentDecorator {
+ public:
+  /// capacity is rounded up to a power of two (8 bytes per slot).
+  /// quantum is the coordinate resolution under which endpoints are merged.
+  explicit CachedEnvironment(std::shared_ptr<const IEnvironment> inner,
+                             size_t capacity = size_t{1} << 20,
+                             double quantum = 1e-6);
+  bool collision_free(const State& a, const State& b) const override;
+
+  CollisionCacheStats stats() const;
+  void reset_stats();
+  void clear();
+  size_t capacity() const { return mask_ + 1; }
+  size_t memory_bytes() const { return capacity() * sizeof(uint64_t); }
+
+ private:
+  static constexpr size_t kMaxProbe = 8;
+
+  uint64_t segment_hash(const State& a, const State& b) const;
+
+  double inv_quantum_;
+  size_t mask_;
+  std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+  mutable std::atomic<uint64_t> hits_{0};
+  mutable std::atomic<uint64_t> misses_{0};
+  mutable std::atomic<uint64_t> inserts_{0};
+  mutable std::atomic<uint64_t> evictions_{0};
+};
+
+}  // namespace pbs
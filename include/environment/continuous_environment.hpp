@@ -4,6 +4,7 @@
 #include "../environment/ienvironment.hpp"
 #include "../geometry/continuous_collision_checker.hpp"
 #include "../geometry/polygon.hpp"
+#include "../environment/preprocessing_cache.hpp"
 #include <string>
 #include <vector>
 
@@ -18,11 +19,15 @@ class ContinuousEnvironment : public IEnvironment {
   double clearance(const State& s) const override;
   static ContinuousEnvironment from_json(const std::string& json);
   bool get_bounds(double& x_min, double& x_max, double& y_min, double& y_max) const override;
+  const std::vector<Polygon>& obstacles() const { return obstacles_; }
+  /// Derived data (rasterizations, ...) built from this scene on demand.
+  PreprocessingCache& preprocessing_cache() const { return cache_; }
 
  private:
   double x_min_ = 0, x_max_ = 0, y_min_ = 0, y_max_ = 0;
   std::vector<Polygon> obstacles_;
   ContinuousCollisionChecker checker_;
+  mutable PreprocessingCache cache_;
 };
 
 }  // namespace pbs
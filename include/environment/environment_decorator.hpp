@@ -0,0 +1,42 @@
+#pragma once
+
+#include "../core/state.hpp"
+#include "ienvironment.hpp"
+#include <memory>
+
+namespace pbs {
+
+/// Environment that wraps another one and forwards every query to it.
+/// Subclasses override only the queries they intercept.
+class EnvironmentDecorator : public IEnvironment {
+ public:
+  explicit EnvironmentDecorator(std::shared_ptr<const IEnvironment> inner)
+    : inner_(std::move(inner)) {}
+  bool is_valid(const State& s) const override { return inner_->is_valid(s); }
+  bool collision_free(const State& a, const State& b) const override {
+    return inner_->collision_free(a, b);
+  }
+  double clearance(const State& s) const override { return inner_->clearance(s); }
+  bool get_bounds(double& x_min, double& x_max, double& y_min, double& y_max) const override {
+    return inner_->get_bounds(x_min, x_max, y_min, y_max);
+  }
+  const IEnvironment& inner() const { return *inner_; }
+
+ protected:
+  std::shared_ptr<const IEnvironment> inner_;
+};
+
+/// Returns env as T, looking through any decorators; nullptr if none matches.
+template <class T>
+const T* env_cast(const IEnvironment& env) {
+  const IEnvironment* e = &env;
+  while (e) {
+    if (const auto* t = dynamic_cast<const T*>(e))
+      return t;
+    const auto* d = dynamic_cast<const EnvironmentDecorator*>(e);
+    e = d ? &d->inner() : nullptr;
+  }
+  return nullptr;
+}
+
+}  // namespace pbs
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "../geometry/trapezoidal_decomposition.hpp"
+#include "ienvironment.hpp"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace pbs {
+
+/// Maps unit-square points onto the free space of an environment, so a
+/// sampler needs no rejection loop. Every mapped point is valid.
+class FreeSpaceSampler {
+ public:
+  virtual ~FreeSpaceSampler() = default;
+  /// Maps (u, v) in [0, 1)^2 to a free point, uniformly by area.
+  virtual void map(double u, double v, double& x, double& y) const = 0;
+  /// Free area over the bounds area.
+  virtual double free_fraction() const = 0;
+};
+
+/// Compact list of free grid cells; the fractional part of u * cells and v
+/// jitter the point inside the chosen cell.
+class FreeCellSampler : public FreeSpaceSampler {
+ public:
+  FreeCellSampler(std::vector<uint32_t> cells, int width, int height);
+  void map(double u, double v, double& x, double& y) const override;
+  double free_fraction() const override;
+  size_t num_cells() const { return cells_.size(); }
+
+ private:
+  std::vector<uint32_t> cells_;  // row * width + col
+  int width_, height_;
+};
+
+/// Free trapezoids of a polygonal scene, chosen with probability
+/// proportional to area.
+class TrapezoidSampler : public FreeSpaceSampler {
+ public:
+  TrapezoidSampler(std::vector<Trapezoid> trapezoids, double bounds_area);
+  void map(double u, double v, double& x, double& y) const override;
+  double free_fraction() const override;
+  const std::vector<Trapezoid>& trapezoids() const { return trapezoids_; }
+
+ private:
+  std::vector<Trapezoid> trapezoids_;
+  std::vector<double> cumulative_;  // area of trapezoids [0, i]
+  double bounds_area_;
+};
+
+/// Free-space sampler of a grid or continuous scene, looking through
+/// decorators; built once and kept in the environment's preprocessing cache.
+/// nullptr for other environments (e.g. SE2 footprints) and for scenes
+/// without free space, where planners fall back to rejection sampling.
+std::shared_ptr<const FreeSpaceSampler> free_space_sampler(const IEnvironment& env);
+
+}  // namespace pbs
@@ -2,6 +2,7 @@
 
 #include "../core/state.hpp"
 #include "../environment/ienvironment.hpp"
+#include "../environment/preprocessing_cache.hpp"
 #include <string>
 #include <vector>
 
@@ -19,6 +20,8 @@ class GridEnvironment : public IEnvironment {
   int height() const { return height_; }
   bool occupied(int row, int col) const;
   bool get_bounds(double& x_min, double& x_max, double& y_min, double& y_max) const override;
+  /// Derived data (free-cell lists, ...) built from this grid on demand.
+  PreprocessingCache& preprocessing_cache() const { return cache_; }
 
   static GridEnvironment from_json(const std::string& json);
   std::string to_json() const;
@@ -27,6 +30,7 @@ class GridEnvironment : public IEnvironment {
   int width_ = 0;
   int height_ = 0;
   std::vector<std::vector<int>> occupancy_;
+  mutable PreprocessingCache cache_;
 };
 
 }  // namespace pbs
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace pbs {
+
+class IEnvironment;
+
+/// Per-environment store for derived data (rasterizations, roadmaps, ...).
+/// Keys must be unique per stored type, e.g. "raster/0.5/conservative".
+/// Copies start empty so a copied environment never sees stale entries.
+class PreprocessingCache {
+ public:
+  PreprocessingCache() = default;
+  PreprocessingCache(const PreprocessingCache&) {}
+  PreprocessingCache& operator=(const PreprocessingCache&) {
+    clear();
+    return *this;
+  }
+
+  /// Returns the entry for key, calling build() once if it is missing.
+  /// Only callers of the same key wait for a build: the cache is unlocked
+  /// while build() runs, so other keys are served (and build() may use the
+  /// cache for other keys). If build() throws, the key is left missing and
+  /// its waiters see the exception.
+  template <class T, class Build>
+  std::shared_ptr<const T> get_or_build(const std::string& key, Build&& build) {
+    std::promise<std::shared_ptr<const void>> promise;
+    Entry entry;
+    bool owner = false;
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      auto it = entries_.find(key);
+      if (it != entries_.end()) {
+        entry = it->second;
+      } else {
+        entry = promise.get_future().share();
+        entries_.emplace(key, entry);
+        owner = true;
+      }
+    }
+    if (owner) {
+      try {
+        std::shared_ptr<const T> value = build();
+        promise.set_value(value);
+      } catch (...) {
+        {
+          std::lock_guard<std::mutex> lock(mu_);
+          entries_.erase(key);
+        }
+        promise.set_exception(std::current_exception());
+        throw;
+      }
+    }
+    return std::static_pointer_cast<const T>(entry.get());
+  }
+
+  /// Whether key has a finished entry.
+  bool contains(const std::string& key) const {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto it = entries_.find(key);
+    return it != entries_.end() &&
+           it->second.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+  }
+  size_t size() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return entries_.size();
+  }
+  void clear() {
+    std::lock_guard<std::mutex> lock(mu_);
+    entries_.clear();
+  }
+
+ private:
+  using Entry = std::shared_future<std::shared_ptr<const void>>;
+
+  mutable std::mutex mu_;
+  std::unordered_map<std::string, Entry> entries_;
+};
+
+/// Cache of a grid or continuous environment, looking through decorators;
+/// nullptr for environments without one.
+PreprocessingCache* preprocessing_cache_of(const IEnvironment& env);
+
+/// 64-bit FNV-1a of bytes, continuing from h; stable across runs and builds.
+uint64_t hash_bytes(const void* data, size_t bytes, uint64_t h = 14695981039346656037ull);
+/// Content hash of an environment, for preprocessing kept outside it (e.g.
+/// roadmap files). Grids hash their occupancy and continuous scenes their
+/// bounds and obstacle vertices, looking through decorators; any other
+/// environment hashes its bounds and is_valid() on a 256 x 256 lattice.
+uint64_t environment_hash(const IEnvironment& env);
+
+}  // namespace pbs
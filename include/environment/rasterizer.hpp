@@ -0,0 +1,56 @@
+#pragma once
+
+#include "../core/path.hpp"
+#include "../core/state.hpp"
+#include "continuous_environment.hpp"
+#include "grid_environment.hpp"
+#include <memory>
+#include <string>
+
+namespace pbs {
+
+/// Conservative: a cell is blocked if any part of it touches an obstacle, so
+/// free cells are free in the continuous scene. Center: blocked if the cell
+/// center lies inside an obstacle (closer to the true free area).
+enum class RasterCoverage { Conservative, Center };
+
+/// "conservative" or "center"; unknown names map to Conservative.
+RasterCoverage parse_raster_coverage(const std::string& s);
+const char* to_string(RasterCoverage c);
+
+/// Maps between continuous coordinates and cells (row = y, col = x).
+struct GridMapping {
+  double x_min = 0.0;
+  double y_min = 0.0;
+  double resolution = 1.0;
+  int width = 0;
+  int height = 0;
+
+  /// Cell containing s, clamped to the grid.
+  State to_cell(const State& s) const;
+  /// Center of the cell given as a grid state (x = col, y = row).
+  State to_world(const State& cell) const;
+  /// Cell centers of grid_path, with the endpoints replaced by start and goal.
+  Path to_world(const Path& grid_path, const State& start, const State& goal) const;
+};
+
+struct RasterGrid {
+  GridEnvironment grid;
+  GridMapping mapping;
+  RasterCoverage coverage = RasterCoverage::Conservative;
+  double build_ms = 0.0;
+};
+
+/// Scanline rasterization of the obstacles into a grid covering the bounds.
+/// Rows are split across num_threads workers (0 = hardware concurrency).
+RasterGrid rasterize(const ContinuousEnvironment& env, double resolution,
+                     RasterCoverage coverage = RasterCoverage::Conservative,
+                     int num_threads = 0);
+
+/// Like rasterize, but built once per (resolution, coverage) and kept in the
+/// environment's preprocessing cache.
+std::shared_ptr<const RasterGrid> rasterize_cached(
+    const ContinuousEnvironment& env, double resolution,
+    RasterCoverage coverage = RasterCoverage::Conservative, int num_threads = 0);
+
+}  // namespace pbs
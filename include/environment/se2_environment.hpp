@@ -2,21 +2,58 @@
 
 #include "../core/state.hpp"
 #include "../environment/ienvironment.hpp"
+#include "../geometry/convex_sat.hpp"
+#include "../geometry/polygon.hpp"
 #include "continuous_environment.hpp"
 #include <memory>
+#include <vector>
 
 namespace pbs {
 
+/// Position + heading. Without a footprint the robot is a point and theta is
+/// only range-checked. With a footprint (robot frame, origin at the reference
+/// point) poses are checked by rotating it to the nearest of num_headings
+/// precomputed headings, a uniform-grid broadphase over obstacle boxes and SAT
+/// against convex obstacle pieces. The footprint is used as its convex hull,
+/// inflated by heading_margin() so that snapping theta never hides a
+/// collision.
 class SE2Environment : public IEnvironment {
  public:
   explicit SE2Environment(std::shared_ptr<ContinuousEnvironment> base);
+  SE2Environment(std::shared_ptr<ContinuousEnvironment> base,
+                 const Polygon& footprint, int num_headings = 72);
   bool is_valid(const State& s) const override;
+  /// With a footprint, sweeps intermediate poses spaced by sweep_resolution()
+  /// in translation and in the arc travelled by the outermost vertex.
   bool collision_free(const State& a, const State& b) const override;
   double clearance(const State& s) const override;
   bool get_bounds(double& x_min, double& x_max, double& y_min, double& y_max) const override;
 
+  bool has_footprint() const { return !headings_.empty(); }
+  int num_headings() const { return static_cast<int>(headings_.size()); }
+  /// Half the footprint's minimum width.
+  double sweep_resolution() const { return sweep_res_; }
+  /// Footprint inflation covering the heading discretization (the largest
+  /// distance a footprint point moves over pi / num_headings).
+  double heading_margin() const { return heading_margin_; }
+  const std::shared_ptr<ContinuousEnvironment>& base() const { return base_; }
+
  private:
+  bool pose_free(double x, double y, double theta) const;
+
   std::shared_ptr<ContinuousEnvironment> base_;
+  double x_min_ = 0, x_max_ = 0, y_min_ = 0, y_max_ = 0;
+  std::vector<ConvexShape> headings_;  // Footprint at heading k * 2pi / N
+  std::vector<ConvexShape> pieces_;    // Convex obstacle pieces
+  double sweep_res_ = 0.0;
+  double radius_ = 0.0;                // Max vertex distance from origin
+  double heading_margin_ = 0.0;
+
+  // Broadphase: piece ids bucketed by the cells their bounding boxes cover.
+  double cell_ = 1.0;
+  int cols_ = 0, rows_ = 0;
+  std::vector<size_t> cell_start_;
+  std::vector<size_t> cell_items_;
 };
 
 }  // namespace pbs
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "point2d.hpp"
+#include "polygon.hpp"
+#include <vector>
+
+namespace pbs {
+
+/// Convex polygon prepared for separating-axis tests.
+struct ConvexShape {
+  std::vector<Point2D> vertices;
+  std::vector<Point2D> axes;  // Unit edge normals
+  double x_min = 0, y_min = 0, x_max = 0, y_max = 0;
+
+  /// poly must be convex; vertex order may be either orientation.
+  static ConvexShape from_polygon(const Polygon& poly);
+  /// Copy rotated by theta about the origin.
+  ConvexShape rotated(double theta) const;
+  /// Copy with every edge pushed out by delta (mitred corners), which
+  /// contains all points within delta of the shape.
+  ConvexShape inflated(double delta) const;
+  /// Smallest extent over the edge normals (minimum width).
+  double min_width() const;
+};
+
+/// Separating-axis overlap test with `a` translated by (dx, dy).
+/// Touching shapes count as overlapping.
+bool convex_overlap(const ConvexShape& a, double dx, double dy,
+                    const ConvexShape& b);
+
+}  // namespace pbs
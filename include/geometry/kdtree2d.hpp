@@ -5,6 +5,7 @@
 #include <cmath>
 #include <algorithm>
 #include <queue>
+#include <cstddef>
 
 namespace pbs {
 
@@ -22,6 +23,8 @@ class KdTree2D {
   std::vector<Point2D> points_;
   std::vector<size_t> indices_;
   void build_rec(size_t l, size_t r, int axis);
+  void radius_rec(size_t l, size_t r, int axis, const Point2D& p, double r2,
+                  std::vector<size_t>& out) const;
 };
 
 }  // namespace pbs
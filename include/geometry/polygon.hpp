@@ -1,6 +1,7 @@
 #pragma once
 
 #include "point2d.hpp"
+#include <cstddef>
 #include <vector>
 
 namespace pbs {
@@ -12,6 +13,13 @@ class Polygon {
   bool contains(const Point2D& p) const;
   void get_bounding_box(double& x_min, double& y_min,
                         double& x_max, double& y_max) const;
+  bool is_convex() const;
+  /// Counter-clockwise convex hull of the vertices (Andrew's monotone chain).
+  Polygon convex_hull() const;
+  /// Splits a simple polygon into triangles by ear clipping. The pieces
+  /// always cover the polygon: self-intersecting input comes back as its
+  /// convex hull, and so does any part that clipping cannot split.
+  std::vector<Polygon> triangulate() const;
   const std::vector<Point2D>& vertices() const { return vertices_; }
   size_t size() const { return vertices_.size(); }
 
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "polygon.hpp"
+#include <vector>
+
+namespace pbs {
+
+/// Trapezoid with vertical sides at x0 < x1; the bottom and top edges run
+/// from (x0, bottom0) to (x1, bottom1) and from (x0, top0) to (x1, top1).
+struct Trapezoid {
+  double x0 = 0, x1 = 0;
+  double bottom0 = 0, bottom1 = 0;
+  double top0 = 0, top1 = 0;
+
+  double area() const { return 0.5 * (x1 - x0) * ((top0 - bottom0) + (top1 - bottom1)); }
+  /// Maps (u, v) in [0, 1)^2 uniformly onto the trapezoid (u picks x by
+  /// inverting the area CDF, v the height).
+  void map(double u, double v, double& x, double& y) const;
+};
+
+/// Vertical (slab) decomposition of the free part of the bounds: slabs are
+/// cut at every vertex and edge crossing, so no two edges cross inside a
+/// slab and each gap between consecutive edges is entirely free or entirely
+/// blocked. Obstacles may be non-convex, overlap or leave the bounds.
+/// O(s * e log e) for s slabs and e edges.
+std::vector<Trapezoid> trapezoidal_decomposition(double x_min, double x_max, double y_min,
+                                                 double y_max,
+                                                 const std::vector<Polygon>& obstacles);
+
+}  // namespace pbs
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "point2d.hpp"
+#include "polygon.hpp"
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace pbs {
+
+/// Visibility graph over the convex obstacle vertices. Segments may touch
+/// obstacle boundaries (grazing a vertex or running along an edge) but not
+/// cross an edge or pass through an interior, so shortest paths in the graph
+/// are the infimum of collision-free path lengths.
+///
+/// Edges are found with Lee's rotational plane sweep: one angular sweep per
+/// vertex with a distance-ordered set of the edges cut by the ray, giving
+/// O(n^2 log n) construction instead of O(n^3) pairwise segment tests.
+class VisibilityGraph {
+ public:
+  explicit VisibilityGraph(const std::vector<Polygon>& obstacles);
+  /// Only vertices strictly inside the workspace become graph vertices, so
+  /// paths cannot squeeze between an obstacle and the boundary it touches.
+  VisibilityGraph(const std::vector<Polygon>& obstacles, double x_min, double x_max,
+                  double y_min, double y_max);
+
+  /// Vertices visible from p, and indices of the `extra` points visible from
+  /// p, from a single sweep around p (p itself need not be a vertex).
+  struct Visible {
+    std::vector<size_t> vertices;
+    std::vector<size_t> extra;
+  };
+  Visible visible_from(const Point2D& p, const std::vector<Point2D>& extra = {}) const;
+
+  size_t num_vertices() const { return node_.size(); }
+  size_t num_edges() const { return num_edges_; }
+  const Point2D& vertex(size_t i) const { return pts_[node_[i]]; }
+  /// (neighbour vertex, edge length) pairs.
+  const std::vector<std::pair<size_t, double>>& neighbors(size_t i) const { return adj_[i]; }
+
+ private:
+  Visible sweep(const Point2D& p, size_t self, const std::vector<Point2D>& extra) const;
+  bool into_interior(size_t v, double dx, double dy) const;
+
+  // All obstacle vertices with their polygon neighbours; graph vertices are
+  // the convex ones (node_ maps graph index -> pts_ index).
+  std::vector<Point2D> pts_;
+  std::vector<size_t> prev_, next_;
+  std::vector<bool> ccw_;
+  std::vector<size_t> node_;
+  std::vector<size_t> node_of_;  // pts_ index -> graph index or SIZE_MAX
+  std::vector<std::vector<std::pair<size_t, double>>> adj_;
+  size_t num_edges_ = 0;
+};
+
+}  // namespace pbs
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "../core/iplanner.hpp"
+#include "../core/state.hpp"
+#include "../core/path.hpp"
+#include "convergence.hpp"
+#include "deadline.hpp"
+#include "sampler.hpp"
+
+namespace pbs {
+
+/// Batch Informed Trees (Gammell et al.). Each batch adds batch_size samples
+/// from the informed set and treats samples plus tree vertices as an
+/// implicit random geometric graph. Edges are queued by the estimated
+/// solution cost through them and collision-checked only when popped, so
+/// edges that cannot beat the current solution are never checked. Before
+/// each batch, samples that cannot improve the solution are dropped and tree
+/// vertices that cannot either leave the tree with their subtrees.
+/// Convergence is recorded once per batch against the samples accepted so
+/// far (rejected draws are not counted).
+class BITStarPlanner : public IPlanner, public SamplingPlanner, public AnytimePlanner {
+ public:
+  BITStarPlanner(int batch_size = 100, int max_batches = 20, double rewire_factor = 1.1);
+  Path solve(const IEnvironment& env, const State& start,
+             const State& goal) override;
+  /// Vertices expanded over all batches.
+  int nodes_expanded() const { return nodes_expanded_; }
+  /// Edges collision-checked in the last solve.
+  int edges_checked() const { return edges_checked_; }
+  const ConvergenceData& convergence_data() const { return conv_data_; }
+  void set_optimal_cost(double c) { optimal_cost_ = c; }
+
+ private:
+  int batch_size_;
+  int max_batches_;
+  double rewire_factor_;
+  double optimal_cost_ = -1.0;
+  int nodes_expanded_ = 0;
+  int edges_checked_ = 0;
+  ConvergenceData conv_data_;
+};
+
+}  // namespace pbs
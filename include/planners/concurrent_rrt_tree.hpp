@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace pbs {
+
+/// Bounded RRT tree grown by several threads at once, with straight
+/// (Euclidean) edges. Slots are claimed with an atomic counter and become
+/// visible once pushed onto a lock-free cell list of a uniform grid, which
+/// also serves nearest and radius queries. Node storage is allocated in
+/// blocks of kBlockSize slots when the first slot of a block is claimed (the
+/// block pointer is published with a CAS), so a large capacity, e.g. the
+/// iteration cap of a time-budgeted run, costs only a pointer per block.
+///
+/// Parent and cost of a node change only under that node's spin lock and only
+/// to a lower cost, so stored costs strictly increase from parent to child. A
+/// rewire that lowers cost(i) can therefore never hang i below one of its own
+/// descendants, even while other threads rewire concurrently.
+class ConcurrentRRTTree {
+ public:
+  static constexpr uint32_t kNone = UINT32_MAX;
+  static constexpr size_t kBlockShift = 10;
+  static constexpr size_t kBlockSize = size_t{1} << kBlockShift;
+
+  /// `cell` is the grid pitch (enlarged if the grid would need more than a
+  /// few cells per slot, counting at most 64k slots).
+  ConcurrentRRTTree(size_t capacity, double x_min, double x_max, double y_min,
+                    double y_max, double cell);
+  ~ConcurrentRRTTree();
+  ConcurrentRRTTree(const ConcurrentRRTTree&) = delete;
+  ConcurrentRRTTree& operator=(const ConcurrentRRTTree&) = delete;
+
+  size_t capacity() const { return capacity_; }
+  /// Claimed slots; a slot being written is not yet returned by queries.
+  size_t size() const;
+  /// Blocks allocated so far.
+  size_t blocks_allocated() const;
+
+  /// Adds a node below parent (kNone for the root); kNone when full.
+  uint32_t add(double x, double y, uint32_t parent, double cost);
+  /// Nearest published node to (x, y), or kNone if there is none.
+  uint32_t nearest(double x, double y) const;
+  /// Appends the published nodes within distance r of (x, y) to out.
+  void near(double x, double y, double r, std::vector<uint32_t>& out) const;
+
+  /// Moves i below new_parent if cost(new_parent) + edge is lower than
+  /// cost(i), then lowers the costs in its subtree. False if no improvement.
+  bool rewire(uint32_t i, uint32_t new_parent, double edge);
+
+  double x(size_t i) const { return node(i).x; }
+  double y(size_t i) const { return node(i).y; }
+  uint32_t parent(size_t i) const { return node(i).parent.load(std::memory_order_acquire); }
+  double cost(size_t i) const { return node(i).cost.load(std::memory_order_acquire); }
+
+  /// Node indices from the root down to i (call once writers have stopped).
+  std::vector<size_t> path_to_root(size_t i) const;
+
+ private:
+  struct Node {
+    double x = 0, y = 0;
+    std::atomic<uint32_t> parent{kNone};
+    std::atomic<double> cost{0.0};
+    std::atomic<uint8_t> ready{0};
+    std::atomic<uint8_t> node_lock{0};   // Guards parent and cost
+    std::atomic<uint8_t> child_lock{0};  // Guards children
+    uint32_t next_in_cell = kNone;       // Per-cell singly linked list
+    std::vector<uint32_t> children;
+  };
+  struct Block {
+    Node nodes[kBlockSize];
+  };
+
+  /// Node i; its block must be allocated (true for any published node).
+  Node& node(size_t i) const {
+    return blocks_[i >> kBlockShift].load(std::memory_order_acquire)
+        ->nodes[i & (kBlockSize - 1)];
+  }
+  /// Node i, or nullptr if its block is not allocated yet.
+  Node* find(size_t i) const {
+    Block* b = blocks_[i >> kBlockShift].load(std::memory_order_acquire);
+    return b ? &b->nodes[i & (kBlockSize - 1)] : nullptr;
+  }
+  Node& claim(size_t i);
+  void cell_coords(double x, double y, int& cx, int& cy) const;
+  void link_child(uint32_t parent, uint32_t child);
+  void unlink_child(uint32_t parent, uint32_t child);
+  void propagate(uint32_t root);
+
+  size_t capacity_;
+  double x_min_, y_min_, cell_;
+  int nx_ = 1, ny_ = 1;
+  std::atomic<uint32_t> next_{0};
+  std::unique_ptr<std::atomic<Block*>[]> blocks_;
+  size_t num_blocks_ = 0;
+  std::vector<std::atomic<uint32_t>> heads_;  // First node per grid cell
+};
+
+}  // namespace pbs
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+namespace pbs {
+
+/// Best solution cost over the iterations of an anytime planner, and each
+/// improvement against elapsed wall-clock time in ms. The gap is filled only
+/// when the planner was given the optimal cost. Planners that prune their
+/// tree also log its node count against elapsed time.
+struct ConvergenceData {
+  std::vector<std::pair<int, double>> cost_vs_iteration;
+  std::vector<std::pair<double, double>> cost_vs_time;
+  std::vector<std::pair<double, int>> tree_size_vs_time;
+  double final_cost = 0.0;
+  double gap_to_optimal = 0.0;
+};
+
+}  // namespace pbs
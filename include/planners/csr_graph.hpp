@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace pbs {
+
+/// Compressed-sparse-row graph for roadmaps: the edges of node u are
+/// [begin(u), end(u)), with uint32 targets and float weights (8 bytes per
+/// edge plus 8 per node), and two bits per edge recording whether it was
+/// collision-checked and whether it is valid.
+///
+/// The arrays are shared and may point into external storage (a mapped
+/// roadmap file); copies share them but get their own edge bits.
+class CSRGraph {
+ public:
+  CSRGraph() = default;
+  /// View over arrays kept alive by owner. Edges start checked and valid
+  /// when prevalidated, else unchecked.
+  CSRGraph(std::shared_ptr<const void> owner, uint32_t num_nodes, size_t num_edges,
+           const uint64_t* offsets, const uint32_t* targets, const float* weights,
+           bool prevalidated);
+
+  uint32_t num_nodes() const { return num_nodes_; }
+  size_t num_edges() const { return num_edges_; }
+  uint64_t begin(uint32_t u) const { return offsets_[u]; }
+  uint64_t end(uint32_t u) const { return offsets_[u + 1]; }
+  uint32_t target(uint64_t e) const { return targets_[e]; }
+  float weight(uint64_t e) const { return weights_[e]; }
+  const uint64_t* offsets() const { return offsets_; }
+  const uint32_t* targets() const { return targets_; }
+  const float* weights() const { return weights_; }
+
+  bool checked(uint64_t e) const { return (checked_[e >> 6] >> (e & 63)) & 1; }
+  /// False only for edges checked and found in collision.
+  bool valid(uint64_t e) const { return (valid_[e >> 6] >> (e & 63)) & 1; }
+  void set_checked(uint64_t e, bool valid);
+  /// Edge u -> v, or end(u) if there is none.
+  uint64_t find_edge(uint32_t u, uint32_t v) const;
+
+  /// Bytes of offsets, targets, weights and edge bits.
+  size_t memory_bytes() const;
+
+ private:
+  std::shared_ptr<const void> owner_;
+  uint32_t num_nodes_ = 0;
+  size_t num_edges_ = 0;
+  const uint64_t* offsets_ = nullptr;
+  const uint32_t* targets_ = nullptr;
+  const float* weights_ = nullptr;
+  std::vector<uint64_t> checked_, valid_;
+};
+
+/// Collects edges from several threads and packs them into a CSRGraph.
+/// Thread t appends only to add(t, ...), so no locking is needed; rows are
+/// sorted by target, so the graph does not depend on which thread added
+/// which edge.
+class CSRGraphBuilder {
+ public:
+  CSRGraphBuilder(uint32_t num_nodes, int num_buffers = 1);
+  void add(int buffer, uint32_t from, uint32_t to, float weight) {
+    buffers_[buffer].push_back({from, to, weight});
+  }
+  /// With symmetric set every edge is also added reversed; duplicate
+  /// (from, to) pairs are dropped either way.
+  CSRGraph build(bool symmetric, bool prevalidated) const;
+
+ private:
+  struct Edge {
+    uint32_t from, to;
+    float weight;
+  };
+  uint32_t num_nodes_;
+  std::vector<std::vector<Edge>> buffers_;
+};
+
+}  // namespace pbs
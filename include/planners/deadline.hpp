@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+
+namespace pbs {
+
+/// Wall-clock budget for an iteration loop. expired() reads the steady clock
+/// only on every kStride-th call, so checking it once per iteration is
+/// cheap; the loop may overrun the budget by up to kStride - 1 iterations.
+/// Copies share the end time, so each worker thread can check its own copy.
+class Deadline {
+ public:
+  using Clock = std::chrono::steady_clock;
+  static constexpr unsigned kStride = 8;
+
+  /// budget_ms <= 0: never expires.
+  explicit Deadline(double budget_ms)
+    : start_(Clock::now()), armed_(budget_ms > 0),
+      end_(start_ + std::chrono::duration_cast<Clock::duration>(
+                        std::chrono::duration<double, std::milli>(armed_ ? budget_ms : 0))) {}
+
+  bool expired() {
+    if (!armed_ || expired_) return expired_;
+    if (++calls_ % kStride != 0) return false;
+    return expired_ = Clock::now() >= end_;
+  }
+  double elapsed_ms() const {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start_).count();
+  }
+
+ private:
+  Clock::time_point start_;
+  bool armed_;
+  Clock::time_point end_;
+  unsigned calls_ = 0;
+  bool expired_ = false;
+};
+
+/// Mixin for anytime planners. With a time budget, solve stops at the first
+/// deadline check after it (max_iter still applies) and returns the best
+/// solution found so far.
+class AnytimePlanner {
+ public:
+  virtual ~AnytimePlanner() = default;
+  /// Wall-clock budget per solve in milliseconds (<= 0: none).
+  void set_time_budget_ms(double ms) { time_budget_ms_ = ms; }
+  double time_budget_ms() const { return time_budget_ms_; }
+
+ protected:
+  double time_budget_ms_ = 0.0;
+};
+
+}  // namespace pbs
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "../core/iplanner.hpp"
+#include "../core/state.hpp"
+#include "../core/path.hpp"
+#include "sampler.hpp"
+
+namespace pbs {
+
+/// Fast Marching Tree (Janson et al.). Draws num_samples valid samples up
+/// front and marches a cost-ordered wavefront over their r-disc graph
+/// (KdTree2D radius search, neighborhoods built on first use; r shrinks with
+/// the free area when free-space sampling is in use). Each
+/// unvisited neighbor of the frontier node is connected to its locally
+/// optimal open parent with a single lazy collision check; if that fails the
+/// node stays unvisited and may be tried again from a later frontier node.
+class FMTStarPlanner : public IPlanner, public SamplingPlanner {
+ public:
+  FMTStarPlanner(int num_samples = 1000, double radius_factor = 1.1);
+  Path solve(const IEnvironment& env, const State& start,
+             const State& goal) override;
+  /// Frontier nodes expanded.
+  int nodes_expanded() const { return nodes_expanded_; }
+  /// Edges collision-checked in the last solve.
+  int edges_checked() const { return edges_checked_; }
+
+ private:
+  int num_samples_;
+  double radius_factor_;
+  int nodes_expanded_ = 0;
+  int edges_checked_ = 0;
+};
+
+}  // namespace pbs
@@ -3,18 +3,18 @@
 #include "../core/iplanner.hpp"
 #include "../core/state.hpp"
 #include "../core/path.hpp"
-#include <vector>
-#include <utility>
+#include "convergence.hpp"
+#include "deadline.hpp"
+#include "sampler.hpp"
 
 namespace pbs {
 
-struct ConvergenceData {
-  std::vector<std::pair<int, double>> cost_vs_iteration;
-  double final_cost = 0.0;
-  double gap_to_optimal = 0.0;
-};
-
-class InformedRRTStarPlanner : public IPlanner {
+/// Informed RRT*: once a solution of cost c is known, samples are drawn from
+/// the ellipse of points that could lie on a cheaper path. With pruning on
+/// (the default) every improvement also removes the nodes whose cost-to-come
+/// plus straight-line distance to the goal exceeds c, with their subtrees,
+/// and compacts the tree so the neighbour scans only visit useful nodes.
+class InformedRRTStarPlanner : public IPlanner, public SamplingPlanner, public AnytimePlanner {
  public:
   InformedRRTStarPlanner(double step_size = 1.0, double goal_bias = 0.1,
                          int max_iter = 5000, double rewiring_radius_factor = 10.0);
@@ -23,6 +23,9 @@ class InformedRRTStarPlanner : public IPlanner {
   int nodes_expanded() const { return nodes_expanded_; }
   const ConvergenceData& convergence_data() const { return conv_data_; }
   void set_optimal_cost(double c) { optimal_cost_ = c; }
+  void set_pruning(bool on) { pruning_ = on; }
+  /// Nodes removed by pruning in the last solve.
+  int nodes_pruned() const { return nodes_pruned_; }
 
  private:
   double step_size_;
@@ -30,7 +33,9 @@ class InformedRRTStarPlanner : public IPlanner {
   int max_iter_;
   double gamma_;
   double optimal_cost_ = -1.0;
+  bool pruning_ = true;
   mutable int nodes_expanded_ = 0;
+  int nodes_pruned_ = 0;
   mutable ConvergenceData conv_data_;
 };
 
@@ -0,0 +1,15 @@
+#pragma once
+
+namespace pbs {
+
+/// Maps (u, v) in the unit square uniformly onto the 2D informed set
+/// {p : |p - s| + |p - g| <= c_best}, the prolate ellipse that contains every
+/// point able to improve a solution of cost c_best (u picks the angle, v the
+/// radius). Returns s when c_best does not exceed |g - s|.
+void sample_ellipse(double sx, double sy, double gx, double gy, double c_best,
+                    double u, double v, double& x, double& y);
+
+/// Area of the informed set (0 when c_best <= |g - s|).
+double ellipse_area(double sx, double sy, double gx, double gy, double c_best);
+
+}  // namespace pbs
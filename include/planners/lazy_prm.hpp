@@ -3,20 +3,30 @@
 #include "../core/iplanner.hpp"
 #include "../core/state.hpp"
 #include "../core/path.hpp"
+#include "sampler.hpp"
 
 namespace pbs {
 
-class LazyPRMPlanner : public IPlanner {
+/// Lazy PRM (Bohlin & Kavraki): the k-nearest-neighbour graph is built
+/// without collision checks. Each round finds a shortest path with LPA*
+/// over the edges not yet known to collide, then checks that path's
+/// unverified edges longest first. A colliding edge is removed and LPA*
+/// repairs the previous search instead of restarting it; the loop ends when
+/// a path checks out or none is left.
+class LazyPRMPlanner : public IPlanner, public SamplingPlanner {
  public:
   LazyPRMPlanner(int num_samples = 500, int k_neighbors = 10);
   Path solve(const IEnvironment& env, const State& start,
              const State& goal) override;
   int nodes_expanded() const { return nodes_expanded_; }
+  /// Edges collision-checked in the last solve.
+  int edges_checked() const { return edges_checked_; }
 
  private:
   int num_samples_;
   int k_neighbors_;
   mutable int nodes_expanded_ = 0;
+  int edges_checked_ = 0;
 };
 
 }  // namespace pbs
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "../core/path.hpp"
+#include <cstdint>
+
+namespace pbs {
+
+class IEnvironment;
+
+enum class ShortcutMode { None, Greedy, Random };
+
+struct PathPostprocessOptions {
+  ShortcutMode shortcut = ShortcutMode::None;
+  /// Random mode: candidate batches drawn.
+  int iterations = 50;
+  /// Random mode: candidates per batch. A batch is checked best gain first,
+  /// and candidates overlapping an accepted one are skipped unchecked.
+  int batch_size = 16;
+  /// Random mode: half of the candidates move only x or only y along the
+  /// subpath (partial shortcuts), which straightens paths whose vertices
+  /// cannot see each other.
+  bool partial = false;
+  /// Fit a cubic B-spline through the shortcut path afterwards.
+  bool bspline = false;
+  int samples_per_span = 8;
+  uint64_t seed = 1;
+};
+
+struct PathPostprocessStats {
+  double shortcut_ms = 0.0;
+  double bspline_ms = 0.0;
+  int collision_checks = 0;
+  int shortcuts = 0;
+};
+
+/// Post-processing for planner output: shortcutting (greedy farthest-visible
+/// or randomized with optional partial shortcuts), then B-spline smoothing.
+/// Every segment of the result is collision-free in env: where the spline
+/// is not, its control polygon is refined towards the shortcut path, and if
+/// that does not settle it the shortcut path is kept. Paths with headings (steered paths) are
+/// returned unchanged, since straight shortcuts would break their kinematics.
+class PathPostprocessor {
+ public:
+  explicit PathPostprocessor(const PathPostprocessOptions& options);
+
+  Path process(const IEnvironment& env, const Path& path);
+  const PathPostprocessStats& stats() const { return stats_; }
+
+ private:
+  void greedy_shortcut(const IEnvironment& env, Path& path);
+  void random_shortcut(const IEnvironment& env, Path& path);
+  void bspline(const IEnvironment& env, Path& path);
+  bool segment_free(const IEnvironment& env, const State& a, const State& b);
+
+  PathPostprocessOptions options_;
+  PathPostprocessStats stats_;
+};
+
+}  // namespace pbs
@@ -3,19 +3,73 @@
 #include "../core/iplanner.hpp"
 #include "../core/state.hpp"
 #include "../core/path.hpp"
+#include "roadmap.hpp"
+#include "sampler.hpp"
+#include <memory>
+#include <string>
 
 namespace pbs {
 
-class PRMPlanner : public IPlanner {
+class FreeSpaceSampler;
+
+/// Probabilistic roadmap, split into a build phase (roadmap()) and a query
+/// phase (query()). solve() reuses the roadmap cached on the environment for
+/// the same sample count, k, sampler and seed, so repeated queries pay only
+/// for connecting start and goal and one Dijkstra search.
+class PRMPlanner : public IPlanner, public SamplingPlanner {
  public:
   PRMPlanner(int num_samples = 500, int k_neighbors = 10);
   Path solve(const IEnvironment& env, const State& start,
              const State& goal) override;
   int nodes_expanded() const { return nodes_expanded_; }
 
- private:
+  /// The roadmap set with set_roadmap(), else the one cached on env for
+  /// these settings, built on first use (environments without a cache
+  /// build a new one every time).
+  std::shared_ptr<const Roadmap> roadmap(const IEnvironment& env);
+  /// Connects start to its k nearest roadmap nodes and the goal from its k
+  /// nearest (collision-checked), then runs Dijkstra.
+  Path query(const Roadmap& roadmap, const IEnvironment& env, const State& start,
+             const State& goal);
+  /// Identity of the roadmap roadmap(env) would build, for Roadmap::save()
+  /// and Roadmap::load(): env contents, settings, sampler and seed.
+  RoadmapProvenance roadmap_provenance(const IEnvironment& env) const;
+  /// Uses a prebuilt (e.g. loaded) roadmap for every solve; nullptr resets.
+  void set_roadmap(std::shared_ptr<const Roadmap> roadmap) { roadmap_ = std::move(roadmap); }
+
+  /// Threads for building roadmaps (default 1, 0 = all cores). The roadmap
+  /// does not depend on it, so cached roadmaps are shared across counts.
+  void set_num_threads(int n) { num_threads_ = n; }
+  int num_threads() const { return num_threads_; }
+  /// With caching off every solve builds a fresh roadmap (for timing builds).
+  void set_cache_roadmap(bool on) { cache_roadmap_ = on; }
+
+  /// Roadmap build time in the last solve (0 when it was reused).
+  double last_build_ms() const { return last_build_ms_; }
+  /// Stage timings of the roadmap built in the last solve (zero if reused).
+  const Roadmap::BuildTimings& last_build_timings() const { return last_build_timings_; }
+  /// Roadmap used by the last solve.
+  const Roadmap* last_roadmap() const { return last_roadmap_.get(); }
+  /// Time of the last solve spent in query().
+  double last_query_ms() const { return last_query_ms_; }
+
+ protected:
+  /// Builds the roadmap that solve() caches; subclasses replace the builder.
+  virtual std::shared_ptr<const Roadmap> build_roadmap(const IEnvironment& env,
+                                                       ISampler& sampler,
+                                                       const FreeSpaceSampler* free_space);
+  /// Cache key of the builder settings (sampler and seed are appended).
+  virtual std::string roadmap_key() const;
+
   int num_samples_;
   int k_neighbors_;
+  int num_threads_ = 1;
+  bool cache_roadmap_ = true;
+  std::shared_ptr<const Roadmap> roadmap_;
+  std::shared_ptr<const Roadmap> last_roadmap_;
+  double last_build_ms_ = 0.0;
+  Roadmap::BuildTimings last_build_timings_;
+  double last_query_ms_ = 0.0;
   mutable int nodes_expanded_ = 0;
 };
 
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "../core/path.hpp"
+#include "../core/state.hpp"
+#include "../geometry/kdtree2d.hpp"
+#include "csr_graph.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pbs {
+
+class IEnvironment;
+class ISampler;
+class FreeSpaceSampler;
+
+/// Appends up to n valid points to out, drawn from sampler in blocks of n:
+/// mapped onto free space when free_space is given, else scaled to the
+/// bounds of env and rejected if invalid, with at most 10 * n draws. The
+/// points keep draw order, so mapping and validating each block on
+/// num_threads threads does not change them.
+void sample_valid_points(const IEnvironment& env, ISampler& sampler,
+                         const FreeSpaceSampler* free_space, int n,
+                         std::vector<Point2D>& out, int num_threads = 1);
+
+/// What a saved roadmap was built from, kept in its file header: a file
+/// loads only for the same environment and builder settings.
+struct RoadmapProvenance {
+  uint64_t environment = 0;  ///< environment_hash() of the map
+  uint64_t num_samples = 0;
+  uint64_t settings = 0;     ///< hash of builder parameters and sampler type
+  uint64_t seed = 0;
+  bool operator==(const RoadmapProvenance& o) const {
+    return environment == o.environment && num_samples == o.num_samples &&
+           settings == o.settings && seed == o.seed;
+  }
+};
+
+/// PRM roadmap: valid sample points and the collision-free directed edges
+/// to each point's k nearest neighbours, stored as compressed rows. It does
+/// not depend on any query, so one roadmap answers any number of them.
+///
+/// The in-memory layout is the file layout (64-byte header, then xs, ys,
+/// row offsets, uint32 edge targets and float edge weights, each 8-byte
+/// aligned), so save() is one write and load() maps the file without
+/// parsing it; graph() is a CSRGraph view over those arrays.
+class Roadmap {
+ public:
+  /// Wall time of each build stage; all zero for a loaded roadmap.
+  struct BuildTimings {
+    double sample_ms = 0.0;   ///< drawing and validating samples
+    double knn_ms = 0.0;      ///< k-d tree and neighbour queries
+    double connect_ms = 0.0;  ///< edge collision checks
+    double layout_ms = 0.0;   ///< packing the compressed rows
+    int threads = 0;
+  };
+
+  /// Samples num_samples valid points (from free space when given, else by
+  /// rejection with at most 10 * num_samples attempts) and connects each to
+  /// its k nearest neighbours. Validation, neighbour queries and edge checks
+  /// run on num_threads threads (0 = all cores); the result is the same for
+  /// any thread count.
+  static std::shared_ptr<const Roadmap> build(const IEnvironment& env, int num_samples,
+                                              int k_neighbors, ISampler& sampler,
+                                              const FreeSpaceSampler* free_space,
+                                              int num_threads = 1);
+  /// Packs nodes and their graph, for builders other than build() (e.g.
+  /// sparse spanners). The packing time is added to timings.layout_ms, and
+  /// build_ms() is the sum of the stages.
+  static std::shared_ptr<const Roadmap> from_graph(const std::vector<Point2D>& points,
+                                                   const CSRGraph& graph, int k_neighbors,
+                                                   const BuildTimings& timings);
+  /// Memory-maps a file written by save(); nullptr if it cannot be read, is
+  /// not a well-formed roadmap (offsets must be monotone and targets in
+  /// range) or was saved with a different provenance.
+  static std::shared_ptr<const Roadmap> load(const std::string& path,
+                                             const RoadmapProvenance& expected = {});
+  /// Writes the roadmap with provenance stamped into the header.
+  bool save(const std::string& path, const RoadmapProvenance& provenance = {}) const;
+
+  /// Connects start to its k nearest nodes and the goal from its k nearest
+  /// (collision-checked), then runs Dijkstra over the roadmap.
+  Path query(const IEnvironment& env, const State& start, const State& goal, size_t k,
+             int* nodes_expanded = nullptr) const;
+
+  size_t num_nodes() const { return graph_.num_nodes(); }
+  size_t num_edges() const { return graph_.num_edges(); }
+  int k_neighbors() const { return k_neighbors_; }
+  const double* xs() const { return xs_; }
+  const double* ys() const { return ys_; }
+  /// Collision-free directed edges, all marked checked and valid.
+  const CSRGraph& graph() const { return graph_; }
+  /// Nearest-neighbour index over the nodes, for connecting queries.
+  const KdTree2D& kdtree() const { return kdtree_; }
+
+  /// Bytes of node and edge data (the file size).
+  size_t data_bytes() const { return bytes_; }
+  /// Whether the data is a mapping of a file rather than heap memory.
+  bool mapped() const { return mapped_; }
+  double build_ms() const { return build_ms_; }
+  const BuildTimings& timings() const { return timings_; }
+  /// Provenance from the file header (zero for roadmaps built in memory).
+  const RoadmapProvenance& provenance() const { return provenance_; }
+
+ private:
+  Roadmap() = default;
+  /// Points the typed arrays into data_; false if the header is invalid.
+  bool attach(std::shared_ptr<const unsigned char> data, size_t bytes);
+
+  std::shared_ptr<const unsigned char> data_;
+  size_t bytes_ = 0;
+  bool mapped_ = false;
+  int k_neighbors_ = 0;
+  const double* xs_ = nullptr;
+  const double* ys_ = nullptr;
+  CSRGraph graph_;
+  KdTree2D kdtree_;
+  double build_ms_ = 0.0;
+  BuildTimings timings_;
+  RoadmapProvenance provenance_;
+};
+
+}  // namespace pbs
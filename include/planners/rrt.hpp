@@ -3,20 +3,37 @@
 #include "../core/iplanner.hpp"
 #include "../core/state.hpp"
 #include "../core/path.hpp"
+#include "deadline.hpp"
+#include "sampler.hpp"
+#include "steering.hpp"
+#include <memory>
 
 namespace pbs {
 
-class RRTPlanner : public IPlanner {
+class RRTPlanner : public IPlanner, public SamplingPlanner, public AnytimePlanner {
  public:
   RRTPlanner(double step_size = 1.0, double goal_bias = 0.1, int max_iter = 5000);
   Path solve(const IEnvironment& env, const State& start,
              const State& goal) override;
   int nodes_expanded() const { return nodes_expanded_; }
+  /// Local planner for extension and edge checks (nullptr = straight segments).
+  /// Curved edges are checked at `resolution` (0 = step_size / 4).
+  void set_steering(std::shared_ptr<const ISteering> steering, double resolution = 0.0);
+  /// Worker threads growing one shared tree (1 = serial, 0 = hardware
+  /// concurrency). Straight-line edges only; with steering solve stays serial.
+  void set_num_threads(int n) { num_threads_ = n; }
+  int num_threads() const { return num_threads_; }
 
  private:
+  Path solve_parallel(const IEnvironment& env, const State& start, const State& goal,
+                      int threads);
+
   double step_size_;
   double goal_bias_;
   int max_iter_;
+  std::shared_ptr<const ISteering> steering_;
+  double steer_res_ = 0.0;
+  int num_threads_ = 1;
   mutable int nodes_expanded_ = 0;
 };
 
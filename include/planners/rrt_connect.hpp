@@ -0,0 +1,29 @@
+#pragma once
+
+#include "../core/iplanner.hpp"
+#include "../core/state.hpp"
+#include "../core/path.hpp"
+#include "deadline.hpp"
+#include "sampler.hpp"
+
+namespace pbs {
+
+/// Bidirectional RRT (Kuffner & LaValle): trees grow from start and goal in
+/// turn; after each EXTEND of one tree the other greedily CONNECTs towards
+/// the new node with repeated steps until it reaches it or is blocked.
+/// goal_bias is the probability of sampling the other tree's root.
+class RRTConnectPlanner : public IPlanner, public SamplingPlanner, public AnytimePlanner {
+ public:
+  RRTConnectPlanner(double step_size = 1.0, double goal_bias = 0.1, int max_iter = 5000);
+  Path solve(const IEnvironment& env, const State& start,
+             const State& goal) override;
+  int nodes_expanded() const { return nodes_expanded_; }
+
+ private:
+  double step_size_;
+  double goal_bias_;
+  int max_iter_;
+  mutable int nodes_expanded_ = 0;
+};
+
+}  // namespace pbs
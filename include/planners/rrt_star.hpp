@@ -3,23 +3,54 @@
 #include "../core/iplanner.hpp"
 #include "../core/state.hpp"
 #include "../core/path.hpp"
+#include "convergence.hpp"
+#include "deadline.hpp"
+#include "sampler.hpp"
+#include "steering.hpp"
+#include <memory>
 
 namespace pbs {
 
-class RRTStarPlanner : public IPlanner {
+class RRTStarPlanner : public IPlanner, public SamplingPlanner, public AnytimePlanner {
  public:
   RRTStarPlanner(double step_size = 1.0, double goal_bias = 0.1,
                  int max_iter = 5000, double rewiring_radius_factor = 10.0);
   Path solve(const IEnvironment& env, const State& start,
              const State& goal) override;
   int nodes_expanded() const { return nodes_expanded_; }
+  /// Local planner for extension, rewiring cost and edge checks
+  /// (nullptr = straight segments). Curved edges are checked at `resolution`
+  /// (0 = step_size / 4).
+  void set_steering(std::shared_ptr<const ISteering> steering, double resolution = 0.0);
+  /// Worker threads growing one shared tree (1 = serial, 0 = hardware
+  /// concurrency). Straight-line edges only; with steering solve stays serial.
+  void set_num_threads(int n) { num_threads_ = n; }
+  int num_threads() const { return num_threads_; }
+  /// Grow the serial, straight-line tree in float32 (CompactRRTTree): about
+  /// two thirds of the memory and half the bytes per neighbour scan, with
+  /// positions and costs rounded to float.
+  void set_compact_storage(bool on) { compact_storage_ = on; }
+  bool compact_storage() const { return compact_storage_; }
+  const ConvergenceData& convergence_data() const { return conv_data_; }
+  void set_optimal_cost(double c) { optimal_cost_ = c; }
 
  private:
+  template <class Tree>
+  Path solve_serial(const IEnvironment& env, const State& start, const State& goal);
+  Path solve_parallel(const IEnvironment& env, const State& start, const State& goal,
+                      int threads);
+
   double step_size_;
   double goal_bias_;
   int max_iter_;
   double gamma_;
+  std::shared_ptr<const ISteering> steering_;
+  double steer_res_ = 0.0;
+  int num_threads_ = 1;
+  bool compact_storage_ = false;
+  double optimal_cost_ = -1.0;
   mutable int nodes_expanded_ = 0;
+  mutable ConvergenceData conv_data_;
 };
 
 }  // namespace pbs
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace pbs {
+
+/// Tree storage shared by the RRT family. Node data is kept as parallel
+/// arrays (x, y, theta, parent, cost) and children as intrusive doubly linked
+/// sibling lists, so reparenting is O(1) and cost propagation walks only the
+/// affected subtree.
+///
+/// All arrays live in one arena, each 64-byte aligned; reserve() sizes the
+/// arena up front and growth doubles it. Real is the coordinate and cost
+/// type: RRTTree uses double, CompactRRTTree float, which with the uint32
+/// links takes 32 instead of 48 bytes per node.
+template <class Real>
+class BasicRRTTree {
+ public:
+  using Scalar = Real;
+  static constexpr uint32_t kNone = UINT32_MAX;
+
+  void clear() { size_ = 0; }
+  void reserve(size_t n);
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  /// Bytes allocated for node storage.
+  size_t memory_bytes() const { return arena_bytes(capacity_); }
+
+  /// Adds a node below parent (kNone for the root) and returns its index.
+  size_t add(double x, double y, double theta, size_t parent, double cost);
+  /// Moves node i below new_parent with cost new_cost and shifts the cost of
+  /// its whole subtree by the same amount.
+  void rewire(size_t i, size_t new_parent, double new_cost);
+
+  Real x(size_t i) const { return xs_[i]; }
+  Real y(size_t i) const { return ys_[i]; }
+  Real theta(size_t i) const { return ths_[i]; }
+  Real cost(size_t i) const { return cost_[i]; }
+  size_t parent(size_t i) const { return parent_[i]; }
+  size_t first_child(size_t i) const { return first_child_[i]; }
+  size_t next_sibling(size_t i) const { return next_sibling_[i]; }
+  const Real* xs() const { return xs_; }
+  const Real* ys() const { return ys_; }
+  const Real* thetas() const { return ths_; }
+
+  /// Removes every node with keep[i] == 0 together with its subtree and
+  /// packs the survivors to the front in their original order, so scans
+  /// over xs()/ys() stay dense. Returns the old-to-new index map (kNone for
+  /// removed nodes).
+  std::vector<uint32_t> prune(const std::vector<char>& keep);
+
+  /// Node indices from the root down to i.
+  std::vector<size_t> path_to_root(size_t i) const;
+
+ private:
+  struct ArenaDelete {
+    void operator()(unsigned char* p) const;
+  };
+  static size_t arena_bytes(size_t capacity);
+  void grow(size_t capacity);
+  void unlink(size_t i);
+  void link(size_t i, size_t parent);
+
+  std::unique_ptr<unsigned char[], ArenaDelete> arena_;
+  size_t size_ = 0, capacity_ = 0;
+  Real* xs_ = nullptr;
+  Real* ys_ = nullptr;
+  Real* ths_ = nullptr;
+  Real* cost_ = nullptr;
+  uint32_t* parent_ = nullptr;
+  uint32_t* first_child_ = nullptr;
+  uint32_t* next_sibling_ = nullptr;
+  uint32_t* prev_sibling_ = nullptr;
+  std::vector<uint32_t> stack_;  // Scratch for subtree walks
+};
+
+using RRTTree = BasicRRTTree<double>;
+using CompactRRTTree = BasicRRTTree<float>;
+
+extern template class BasicRRTTree<double>;
+extern template class BasicRRTTree<float>;
+
+}  // namespace pbs
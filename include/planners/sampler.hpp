@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+
+namespace pbs {
+
+/// Source of sample points in the unit square; planners scale them to their
+/// bounds. Scalar decisions (goal bias, headings) use uniform(), which is a
+/// pseudo-random stream even for low-discrepancy point sets.
+class ISampler {
+ public:
+  virtual ~ISampler() = default;
+  /// Next point in [0, 1)^2.
+  virtual void next(double& u, double& v) = 0;
+  /// The next n points, as if from n calls to next().
+  virtual void next_block(double* u, double* v, size_t n);
+  /// Uniform value in [0, 1).
+  virtual double uniform() = 0;
+};
+
+/// std::mt19937 with canonical doubles. Points and uniform() share one
+/// engine, so a planner drawing in the same order as before reproduces the
+/// legacy `std::mt19937 rng(42)` sequences exactly.
+class MersenneSampler : public ISampler {
+ public:
+  explicit MersenneSampler(uint64_t seed) : rng_(static_cast<uint32_t>(seed)) {}
+  void next(double& u, double& v) override;
+  double uniform() override { return u01_(rng_); }
+
+ private:
+  std::mt19937 rng_;
+  std::uniform_real_distribution<double> u01_{0.0, 1.0};
+};
+
+/// xoshiro256** (Blackman & Vigna), seeded through splitmix64.
+class XoshiroSampler : public ISampler {
+ public:
+  explicit XoshiroSampler(uint64_t seed);
+  void next(double& u, double& v) override;
+  void next_block(double* u, double* v, size_t n) override;
+  double uniform() override { return to_unit(next_u64()); }
+
+  uint64_t next_u64();
+  static double to_unit(uint64_t x) { return static_cast<double>(x >> 11) * 0x1.0p-53; }
+
+ private:
+  uint64_t s_[4];
+};
+
+/// Halton sequence in bases 2 and 3 with a Cranley-Patterson rotation drawn
+/// from the seed, so every stream is a different randomized QMC set.
+class HaltonSampler : public ISampler {
+ public:
+  explicit HaltonSampler(uint64_t seed);
+  void next(double& u, double& v) override;
+  double uniform() override { return rng_.uniform(); }
+
+ private:
+  XoshiroSampler rng_;
+  double shift_u_, shift_v_;
+  uint64_t index_ = 1;
+};
+
+/// 2D Sobol sequence (Gray-code order, 32-bit direction numbers). Plain mode
+/// applies a random digital shift per seed; scrambled mode applies Owen
+/// nested uniform scrambling (Burley's hash-based variant) per seed.
+class SobolSampler : public ISampler {
+ public:
+  SobolSampler(uint64_t seed, bool scrambled);
+  void next(double& u, double& v) override;
+  void next_block(double* u, double* v, size_t n) override;
+  double uniform() override { return rng_.uniform(); }
+
+ private:
+  void point(uint32_t& a, uint32_t& b);
+
+  XoshiroSampler rng_;
+  bool scrambled_;
+  uint32_t seed_u_, seed_v_;
+  uint32_t x_ = 0, y_ = 0;
+  uint32_t index_ = 0;
+};
+
+/// Sampler type and seed. Planners build a fresh sampler from it on every
+/// solve, so equal configs give equal results.
+struct SamplerConfig {
+  std::string type = "mt19937";
+  uint64_t seed = 42;
+};
+
+/// Seed of stream `stream` derived from `base` (stream 0 is base itself).
+/// Used for per-repeat and per-thread streams.
+uint64_t stream_seed(uint64_t base, uint64_t stream);
+
+/// "mt19937" | "xoshiro" | "halton" | "sobol" | "scrambled_sobol"; nullptr if
+/// the type is unknown.
+std::unique_ptr<ISampler> make_sampler(const SamplerConfig& config, uint64_t stream = 0);
+
+/// Mixin for planners that draw from a sampler.
+class SamplingPlanner {
+ public:
+  virtual ~SamplingPlanner() = default;
+  void set_sampler(SamplerConfig config) { sampler_config_ = std::move(config); }
+  const SamplerConfig& sampler_config() const { return sampler_config_; }
+  /// Planners that need valid samples map them onto the environment's free
+  /// space when it has a decomposition (default) instead of rejecting them.
+  void set_free_space_sampling(bool on) { free_space_sampling_ = on; }
+  bool free_space_sampling() const { return free_space_sampling_; }
+
+ protected:
+  /// Sampler for this solve (or worker stream); falls back to mt19937.
+  std::unique_ptr<ISampler> new_sampler(uint64_t stream = 0) const;
+
+  SamplerConfig sampler_config_;
+  bool free_space_sampling_ = true;
+};
+
+}  // namespace pbs
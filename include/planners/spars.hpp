@@ -0,0 +1,39 @@
+#pragma once
+
+#include "prm.hpp"
+#include <memory>
+#include <string>
+
+namespace pbs {
+
+/// Sparse roadmap spanner in the style of SPARS2 (Dobson & Bekris), built
+/// without the dense graph. Samples are kept only when they
+///  - cover free space no guard within sparse_delta can see (coverage),
+///  - join two connected components (connectivity), or
+///  - shortcut two visible guards whose roadmap distance exceeds stretch
+///    times their best known free distance (interface/quality); the edge is
+///    added directly when the guards see each other, else through the
+///    sample.
+/// Building stops after max_failures consecutive samples that add nothing
+/// (or num_samples attempts). Queries are answered as in PRM.
+class SPARSPlanner : public PRMPlanner {
+ public:
+  /// sparse_delta is the visibility range as a fraction of the bounds
+  /// diagonal; stretch (>= 1) bounds roadmap path length between guards.
+  SPARSPlanner(int num_samples = 20000, double sparse_delta = 0.1,
+               double stretch = 2.0, int max_failures = 1000, int k_neighbors = 10);
+
+  double stretch() const { return stretch_; }
+
+ protected:
+  std::shared_ptr<const Roadmap> build_roadmap(const IEnvironment& env, ISampler& sampler,
+                                               const FreeSpaceSampler* free_space) override;
+  std::string roadmap_key() const override;
+
+ private:
+  double sparse_delta_;
+  double stretch_;
+  int max_failures_;
+};
+
+}  // namespace pbs
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "../core/state.hpp"
+#include "../environment/ienvironment.hpp"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pbs {
+
+/// Local planner connecting two states. Sampling planners use it for
+/// nearest-neighbour cost, extension and edge checking. A missing theta is
+/// treated as heading 0.
+class ISteering {
+ public:
+  virtual ~ISteering() = default;
+  /// Length of the local path from a to b (not necessarily symmetric).
+  virtual double distance(const State& a, const State& b) const = 0;
+  /// out[i] = distance(node i, to) for SoA nodes (xs, ys, ths).
+  virtual void distances_to(const double* xs, const double* ys, const double* ths,
+                            size_t n, const State& to, double* out) const;
+  /// out[i] = distance(from, node i).
+  virtual void distances_from(const State& from, const double* xs, const double* ys,
+                              const double* ths, size_t n, double* out) const;
+  /// Index of the node closest to `to`; n must be > 0.
+  virtual size_t nearest(const double* xs, const double* ys, const double* ths,
+                         size_t n, const State& to) const;
+  /// State reached after travelling at most max_length from a towards b.
+  virtual State extend(const State& a, const State& b, double max_length) const = 0;
+  /// States along the local path from a to b (both included), spaced at most
+  /// `resolution` apart. Headings are normalized to [0, 2pi).
+  virtual std::vector<State> interpolate(const State& a, const State& b,
+                                         double resolution) const = 0;
+  /// Whether the local path depends on heading (planners then sample theta).
+  virtual bool uses_heading() const { return false; }
+
+  /// True if all interpolated states are valid and each consecutive pair is
+  /// collision-free in env.
+  bool collision_free(const IEnvironment& env, const State& a, const State& b,
+                      double resolution) const;
+};
+
+/// Straight segments in the plane; theta is carried over from the target.
+class StraightLineSteering : public ISteering {
+ public:
+  double distance(const State& a, const State& b) const override;
+  void distances_to(const double* xs, const double* ys, const double* ths,
+                    size_t n, const State& to, double* out) const override;
+  State extend(const State& a, const State& b, double max_length) const override;
+  std::vector<State> interpolate(const State& a, const State& b,
+                                 double resolution) const override;
+};
+
+/// Forward-only car with minimum turning radius (shortest of the six
+/// CSC/CCC Dubins words).
+class DubinsSteering : public ISteering {
+ public:
+  explicit DubinsSteering(double turning_radius = 1.0);
+  double distance(const State& a, const State& b) const override;
+  size_t nearest(const double* xs, const double* ys, const double* ths,
+                 size_t n, const State& to) const override;
+  State extend(const State& a, const State& b, double max_length) const override;
+  std::vector<State> interpolate(const State& a, const State& b,
+                                 double resolution) const override;
+  bool uses_heading() const override { return true; }
+  double turning_radius() const { return rho_; }
+
+ private:
+  double rho_;
+};
+
+/// Car that may reverse: shortest Reeds-Shepp word over the CSC, CCC, CCCC,
+/// CCSC and CCSCC families with time-flip and reflection symmetries.
+class ReedsSheppSteering : public ISteering {
+ public:
+  explicit ReedsSheppSteering(double turning_radius = 1.0);
+  double distance(const State& a, const State& b) const override;
+  size_t nearest(const double* xs, const double* ys, const double* ths,
+                 size_t n, const State& to) const override;
+  State extend(const State& a, const State& b, double max_length) const override;
+  std::vector<State> interpolate(const State& a, const State& b,
+                                 double resolution) const override;
+  bool uses_heading() const override { return true; }
+  double turning_radius() const { return rho_; }
+
+ private:
+  double rho_;
+};
+
+/// "straight", "dubins" or "reeds_shepp"; nullptr for unknown names.
+std::shared_ptr<ISteering> make_steering(const std::string& name,
+                                         double turning_radius = 1.0);
+
+}  // namespace pbs
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "../core/iplanner.hpp"
+#include "../core/state.hpp"
+#include "../core/path.hpp"
+#include "../environment/continuous_environment.hpp"
+#include "../geometry/visibility_graph.hpp"
+#include <memory>
+
+namespace pbs {
+
+/// Exact shortest paths in polygon worlds (ContinuousEnvironment, possibly
+/// behind decorators). The obstacle graph is built once per environment and
+/// kept in its preprocessing cache; each query sweeps only start and goal.
+/// Paths may touch obstacle vertices, so their length is the optimal cost
+/// that sampling planners converge to.
+class VisibilityGraphPlanner : public IPlanner {
+ public:
+  Path solve(const IEnvironment& env, const State& start,
+             const State& goal) override;
+  int nodes_expanded() const { return nodes_expanded_; }
+
+  /// Graph for env, built on first use.
+  static std::shared_ptr<const VisibilityGraph> graph_for(const ContinuousEnvironment& env);
+
+ private:
+  int nodes_expanded_ = 0;
+};
+
+}  // namespace pbs
@@ -1,28 +1,89 @@
 #include "benchmark/benchmark_engine.hpp"
+#include "benchmark/environment_cache.hpp"
+#include "benchmark/perf_counters.hpp"
 #include "benchmark/statistics.hpp"
+#include "benchmark/task_scheduler.hpp"
+#include "benchmark/timing.hpp"
 #include "metrics/metrics_collector.hpp"
+#include "environment/cached_environment.hpp"
+#include "environment/continuous_environment.hpp"
 #include "environment/grid_environment.hpp"
 #include "environment/map_generator.hpp"
+#include "environment/rasterizer.hpp"
 #include "planners/dijkstra.hpp"
 #include "planners/astar.hpp"
 #include "planners/weighted_astar.hpp"
 #include "planners/thetastar.hpp"
 #include "planners/prm.hpp"
+#include "planners/spars.hpp"
 #include "planners/lazy_prm.hpp"
+#include "planners/fmt_star.hpp"
 #include "planners/rrt.hpp"
 #include "planners/rrt_star.hpp"
+#include "planners/rrt_connect.hpp"
 #include "planners/informed_rrt_star.hpp"
+#include "planners/bit_star.hpp"
+#include "planners/deadline.hpp"
+#include "planners/path_postprocessor.hpp"
+#include "planners/sampler.hpp"
+#include "planners/steering.hpp"
+#include "planners/visibility_graph_planner.hpp"
 #include <nlohmann/json.hpp>
 #include <fstream>
 #include <iostream>
-#include <chrono>
+#include <array>
+#include <cstdio>
 #include <memory>
 #include <sstream>
+#include <thread>
 
 namespace pbs {
 
 namespace {
 
+// "steering": "straight" | "dubins" | "reeds_shepp", with "turning_radius"
+// and "steering_resolution" (0 = step_size / 4).
+template <class Planner>
+std::unique_ptr<Planner> with_steering(std::unique_ptr<Planner> planner,
+                                       const nlohmann::json& params) {
+  std::string name = params.value("steering", "straight");
+  if (name != "straight") {
+    auto steering = make_steering(name, params.value("turning_radius", 1.0));
+    if (!steering)
+      std::cerr << "Warning: unknown steering " << name << ", using straight\n";
+    planner->set_steering(std::move(steering), params.value("steering_resolution", 0.0));
+  }
+  return planner;
+}
+
+// "num_threads": worker threads for tree growth or roadmap construction
+// (default 1, 0 = all cores).
+template <class Planner>
+std::unique_ptr<Planner> with_threads(std::unique_ptr<Planner> planner,
+                                      const nlohmann::json& params) {
+  planner->set_num_threads(params.value("num_threads", 1));
+  return planner;
+}
+
+// "sampler": "mt19937" | "xoshiro" | "halton" | "sobol" | "scrambled_sobol",
+// with "seed" (default 42).
+SamplerConfig sampler_from_json(const nlohmann::json& params) {
+  SamplerConfig config;
+  config.type = params.value("sampler", config.type);
+  config.seed = params.value("seed", config.seed);
+  if (!make_sampler(config)) {
+    std::cerr << "Warning: unknown sampler " << config.type << ", using mt19937\n";
+    config.type = "mt19937";
+  }
+  return config;
+}
+
+// "max_iter" defaults to 5000, or to 200000 with a "time_budget_ms" so that
+// the budget rather than the iteration cap ends the search.
+int max_iter_param(const nlohmann::json& params) {
+  return params.value("max_iter", params.value("time_budget_ms", 0.0) > 0 ? 200000 : 5000);
+}
+
 std::unique_ptr<IPlanner> create_planner(const std::string& name,
                                          const nlohmann::json& params) {
   if (name == "dijkstra") return std::make_unique<DijkstraPlanner>();
@@ -35,36 +96,106 @@ std::unique_ptr<IPlanner> create_planner(const std::string& name,
   if (name == "prm") {
     int n = params.value("num_samples", 500);
     int k = params.value("k_neighbors", 10);
-    return std::make_unique<PRMPlanner>(n, k);
+    return with_threads(std::make_unique<PRMPlanner>(n, k), params);
+  }
+  if (name == "spars") {
+    int n = params.value("num_samples", 20000);
+    double delta = params.value("sparse_delta", 0.1);
+    double stretch = params.value("stretch", 2.0);
+    int failures = params.value("max_failures", 1000);
+    int k = params.value("k_neighbors", 10);
+    return std::make_unique<SPARSPlanner>(n, delta, stretch, failures, k);
   }
   if (name == "lazy_prm") {
     int n = params.value("num_samples", 500);
     int k = params.value("k_neighbors", 10);
     return std::make_unique<LazyPRMPlanner>(n, k);
   }
+  if (name == "fmt_star") {
+    int n = params.value("num_samples", 1000);
+    double eta = params.value("radius_factor", 1.1);
+    return std::make_unique<FMTStarPlanner>(n, eta);
+  }
   if (name == "rrt") {
     double step = params.value("step_size", 1.0);
     double bias = params.value("goal_bias", 0.1);
-    int max_i = params.value("max_iter", 5000);
-    return std::make_unique<RRTPlanner>(step, bias, max_i);
+    int max_i = max_iter_param(params);
+    return with_threads(with_steering(std::make_unique<RRTPlanner>(step, bias, max_i), params),
+                        params);
+  }
+  if (name == "rrt_connect") {
+    double step = params.value("step_size", 1.0);
+    double bias = params.value("goal_bias", 0.1);
+    int max_i = max_iter_param(params);
+    return std::make_unique<RRTConnectPlanner>(step, bias, max_i);
   }
   if (name == "rrt_star") {
     double step = params.value("step_size", 1.0);
     double bias = params.value("goal_bias", 0.1);
-    int max_i = params.value("max_iter", 5000);
+    int max_i = max_iter_param(params);
     double gamma = params.value("rewiring_radius_factor", 10.0);
-    return std::make_unique<RRTStarPlanner>(step, bias, max_i, gamma);
+    auto rrt_star = std::make_unique<RRTStarPlanner>(step, bias, max_i, gamma);
+    rrt_star->set_compact_storage(params.value("compact_storage", false));
+    return with_threads(with_steering(std::move(rrt_star), params), params);
   }
   if (name == "informed_rrt_star") {
     double step = params.value("step_size", 1.0);
     double bias = params.value("goal_bias", 0.1);
-    int max_i = params.value("max_iter", 5000);
+    int max_i = max_iter_param(params);
     double gamma = params.value("rewiring_radius_factor", 10.0);
-    return std::make_unique<InformedRRTStarPlanner>(step, bias, max_i, gamma);
+    auto irrt = std::make_unique<InformedRRTStarPlanner>(step, bias, max_i, gamma);
+    irrt->set_pruning(params.value("prune", true));
+    return irrt;
   }
+  if (name == "bit_star") {
+    int batch = params.value("batch_size", 100);
+    int batches = params.value("max_batches", params.value("time_budget_ms", 0.0) > 0 ? 1000 : 20);
+    double eta = params.value("rewire_factor", 1.1);
+    return std::make_unique<BITStarPlanner>(batch, batches, eta);
+  }
+  if (name == "visibility_graph") return std::make_unique<VisibilityGraphPlanner>();
   return nullptr;
 }
 
+// "postprocess": {"shortcut": "greedy" | "random" | "none", "iterations",
+// "batch_size", "partial", "bspline", "samples_per_span", "seed"}.
+// Returns false if absent.
+bool postprocess_from_json(const nlohmann::json& exp, PathPostprocessOptions& o) {
+  if (!exp.contains("postprocess")) return false;
+  const auto& pj = exp["postprocess"];
+  const std::string mode = pj.value("shortcut", "greedy");
+  o.shortcut = mode == "random" ? ShortcutMode::Random
+             : mode == "none"   ? ShortcutMode::None
+                                : ShortcutMode::Greedy;
+  o.iterations = pj.value("iterations", o.iterations);
+  o.batch_size = pj.value("batch_size", o.batch_size);
+  o.partial = pj.value("partial", o.partial);
+  o.bspline = pj.value("bspline", o.bspline);
+  o.samples_per_span = pj.value("samples_per_span", o.samples_per_span);
+  o.seed = pj.value("seed", o.seed);
+  return true;
+}
+
+// "timing": {"warmup", "timer": "steady_clock" | "tsc", "cache": "warm" |
+// "cold", "flush_bytes", "pin_core"}; absent keys keep the defaults.
+TimingOptions timing_from_json(const nlohmann::json& exp) {
+  TimingOptions o;
+  if (!exp.contains("timing")) return o;
+  const auto& tj = exp["timing"];
+  o.warmup = std::max(0, tj.value("warmup", o.warmup));
+  o.timer = tj.value("timer", "steady_clock") == "tsc" ? TimerSource::Tsc
+                                                       : TimerSource::SteadyClock;
+  o.cache = tj.value("cache", "warm") == "cold" ? CacheMode::Cold : CacheMode::Warm;
+  o.flush_bytes = tj.value("flush_bytes", o.flush_bytes);
+  o.pin_core = tj.value("pin_core", o.pin_core);
+  return o;
+}
+
+bool is_grid_planner(const std::string& name) {
+  return name == "dijkstra" || name == "astar" || name == "weighted_astar" ||
+         name == "thetastar";
+}
+
 MapGeneratorType parse_generator_type(const std::string& s) {
   if (s == "maze") return MapGeneratorType::Maze;
   if (s == "random_uniform" || s == "random") return MapGeneratorType::RandomUniform;
@@ -81,6 +212,21 @@ MapGeneratorParams params_from_json(const nlohmann::json& env_j) {
   return MapGeneratorParams{w, h, density, 0, 0.0, seed, type};
 }
 
+// "collision_cache": true | {"capacity": N, "quantum": q}. Returns nullptr if absent.
+std::shared_ptr<CachedEnvironment> make_collision_cache(
+    const nlohmann::json& exp, std::shared_ptr<const IEnvironment> env) {
+  if (!exp.contains("collision_cache")) return nullptr;
+  const auto& cj = exp["collision_cache"];
+  if (cj.is_boolean() && !cj.get<bool>()) return nullptr;
+  size_t capacity = size_t{1} << 20;
+  double quantum = 1e-6;
+  if (cj.is_object()) {
+    capacity = cj.value("capacity", capacity);
+    quantum = cj.value("quantum", quantum);
+  }
+  return std::make_shared<CachedEnvironment>(std::move(env), capacity, quantum);
+}
+
 int get_nodes(const IPlanner* p) {
   if (auto* d = dynamic_cast<const DijkstraPlanner*>(p))
     return d->nodes_expanded();
@@ -94,15 +240,482 @@ int get_nodes(const IPlanner* p) {
     return prm->nodes_expanded();
   if (auto* lprm = dynamic_cast<const LazyPRMPlanner*>(p))
     return lprm->nodes_expanded();
+  if (auto* fmt = dynamic_cast<const FMTStarPlanner*>(p))
+    return fmt->nodes_expanded();
   if (auto* rrt = dynamic_cast<const RRTPlanner*>(p))
     return rrt->nodes_expanded();
+  if (auto* rrtc = dynamic_cast<const RRTConnectPlanner*>(p))
+    return rrtc->nodes_expanded();
   if (auto* rrtstar = dynamic_cast<const RRTStarPlanner*>(p))
     return rrtstar->nodes_expanded();
   if (auto* irrt = dynamic_cast<const InformedRRTStarPlanner*>(p))
     return irrt->nodes_expanded();
+  if (auto* bit = dynamic_cast<const BITStarPlanner*>(p))
+    return bit->nodes_expanded();
+  if (auto* vg = dynamic_cast<const VisibilityGraphPlanner*>(p))
+    return vg->nodes_expanded();
   return 0;
 }
 
+// Edges collision-checked in the last solve by planners that check edges
+// lazily; -1 for other planners.
+int get_edges_checked(const IPlanner* p) {
+  if (auto* lprm = dynamic_cast<const LazyPRMPlanner*>(p))
+    return lprm->edges_checked();
+  if (auto* fmt = dynamic_cast<const FMTStarPlanner*>(p))
+    return fmt->edges_checked();
+  if (auto* bit = dynamic_cast<const BITStarPlanner*>(p))
+    return bit->edges_checked();
+  return -1;
+}
+
+// Passes the optimal cost to planners that report convergence. Returns false
+// if the planner does not support it.
+bool set_optimal_cost(IPlanner* p, double cost) {
+  if (auto* rrtstar = dynamic_cast<RRTStarPlanner*>(p)) {
+    rrtstar->set_optimal_cost(cost);
+    return true;
+  }
+  if (auto* irrt = dynamic_cast<InformedRRTStarPlanner*>(p)) {
+    irrt->set_optimal_cost(cost);
+    return true;
+  }
+  if (auto* bit = dynamic_cast<BITStarPlanner*>(p)) {
+    bit->set_optimal_cost(cost);
+    return true;
+  }
+  return false;
+}
+
+// Sets the worker thread count on planners that grow in parallel. Returns
+// false if the planner is single-threaded.
+bool set_num_threads(IPlanner* p, int n) {
+  if (auto* prm = dynamic_cast<PRMPlanner*>(p)) {
+    prm->set_num_threads(n);
+    return true;
+  }
+  if (auto* rrt = dynamic_cast<RRTPlanner*>(p)) {
+    rrt->set_num_threads(n);
+    return true;
+  }
+  if (auto* rrtstar = dynamic_cast<RRTStarPlanner*>(p)) {
+    rrtstar->set_num_threads(n);
+    return true;
+  }
+  return false;
+}
+
+const ConvergenceData* get_convergence(const IPlanner* p) {
+  if (auto* rrtstar = dynamic_cast<const RRTStarPlanner*>(p))
+    return &rrtstar->convergence_data();
+  if (auto* irrt = dynamic_cast<const InformedRRTStarPlanner*>(p))
+    return &irrt->convergence_data();
+  if (auto* bit = dynamic_cast<const BITStarPlanner*>(p))
+    return &bit->convergence_data();
+  return nullptr;
+}
+
+// Cache key for an "environment" object. Grid keys come from the parsed
+// generator parameters (defaults filled in); continuous keys are the scene
+// JSON without the rasterization options, which are cached on the scene.
+// nlohmann objects dump with sorted keys, so key order does not matter.
+std::string environment_key(const nlohmann::json& env_j) {
+  if (env_j.value("type", "grid") == "continuous") {
+    nlohmann::json scene = env_j;
+    scene.erase("resolution");
+    scene.erase("coverage");
+    return "continuous/" + scene.dump();
+  }
+  MapGeneratorParams p = params_from_json(env_j);
+  char key[128];
+  std::snprintf(key, sizeof(key), "grid/%d/%d/%.17g/%llu/%d", p.width, p.height,
+                p.obstacle_density, static_cast<unsigned long long>(p.seed),
+                static_cast<int>(p.type));
+  return key;
+}
+
+// Runs one experiment entry and returns its result (null if it cannot run).
+// Everything it touches is created here, except the environment, which comes
+// from the run's shared cache; entries can run concurrently. perf_counters
+// is the default for entries without a "perf_counters" key.
+nlohmann::json run_experiment(const nlohmann::json& exp, EnvironmentCache& environments,
+                              bool perf_counters) {
+  MetricsCollector collector;
+  auto env_j = exp["environment"];
+  std::string planner_name = exp.value("planner", "astar");
+  auto planner = create_planner(planner_name, exp.value("planner_params", nlohmann::json::object()));
+  if (!planner) {
+    std::cerr << "Error: unknown planner " << planner_name << "\n";
+    return nullptr;
+  }
+
+  std::shared_ptr<const IEnvironment> env;
+  // Continuous scenes: sampling planners use them directly, grid planners
+  // plan on a rasterization and their paths are mapped back (start/goal
+  // are [x, y] in world coordinates).
+  std::shared_ptr<const ContinuousEnvironment> scene;
+  std::shared_ptr<const RasterGrid> raster;
+  State start, goal, world_start, world_goal;
+  const bool continuous = env_j.value("type", "grid") == "continuous";
+  EnvironmentLookup lookup = environments.get_or_generate(
+      environment_key(env_j), [&]() -> std::shared_ptr<const IEnvironment> {
+        if (continuous)
+          return std::make_shared<ContinuousEnvironment>(
+              ContinuousEnvironment::from_json(env_j.dump()));
+        MapGenerator gen;
+        return std::make_shared<GridEnvironment>(gen.generate(params_from_json(env_j)));
+      });
+  if (continuous) {
+    scene = std::static_pointer_cast<const ContinuousEnvironment>(lookup.env);
+    world_start = State(exp["start"][0].get<double>(), exp["start"][1].get<double>());
+    world_goal = State(exp["goal"][0].get<double>(), exp["goal"][1].get<double>());
+    if (is_grid_planner(planner_name)) {
+      raster = rasterize_cached(*scene, env_j.value("resolution", 1.0),
+                                parse_raster_coverage(env_j.value("coverage", "conservative")));
+      env = std::shared_ptr<const IEnvironment>(raster, &raster->grid);
+      start = raster->mapping.to_cell(world_start);
+      goal = raster->mapping.to_cell(world_goal);
+    } else {
+      env = scene;
+      start = world_start;
+      goal = world_goal;
+    }
+  } else {
+    env = lookup.env;
+    start = State(exp["start"][1].get<int>(), exp["start"][0].get<int>());
+    goal = State(exp["goal"][1].get<int>(), exp["goal"][0].get<int>());
+  }
+  auto cache = make_collision_cache(exp, env);
+  if (cache) env = cache;
+  const IEnvironment* metrics_env = scene ? scene.get() : env.get();
+
+  // Exact optimum from the visibility graph, for straight-line RRT* variants.
+  // Only planners that record convergence use it, so others skip the solve.
+  double optimal_cost = -1.0;
+  const auto params = exp.value("planner_params", nlohmann::json::object());
+  if (scene && get_convergence(planner.get()) &&
+      params.value("steering", "straight") == "straight") {
+    VisibilityGraphPlanner vg;
+    Path opt = vg.solve(*scene, world_start, world_goal);
+    if (opt.success && set_optimal_cost(planner.get(), opt.length))
+      optimal_cost = opt.length;
+  }
+
+  int repeats = exp.value("repeats", 30);
+
+  // "num_threads" for planners that grow in parallel (0 = all cores).
+  int max_threads = params.value("num_threads", 1);
+  if (max_threads <= 0)
+    max_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+  const int planner_threads = set_num_threads(planner.get(), max_threads) ? max_threads : 1;
+
+  // Timing harness: pinning holds for the whole entry, warmup solves are
+  // discarded, and cold mode flushes the caches before each timed solve.
+  // Planner threads inherit the pin, so a parallel planner gets one core per
+  // thread starting at pin_core, or no pin if those cores are not all there.
+  const TimingOptions timing = timing_from_json(exp);
+  ScopedAffinity affinity(timing.pin_core, planner_threads);
+  if (timing.pin_core >= 0 && affinity.core() < 0)
+    std::cerr << "Warning: cannot pin " << planner_threads << " thread(s) from core "
+              << timing.pin_core << ", running unpinned\n";
+  SolveTimer timer(timing.timer);
+  std::unique_ptr<CacheFlusher> flusher;
+  if (timing.cache == CacheMode::Cold) flusher = std::make_unique<CacheFlusher>(timing.flush_bytes);
+  // Hardware counters around each timed solve, on this thread only.
+  std::unique_ptr<PerfCounters> perf;
+  if (exp.value("perf_counters", perf_counters)) perf = std::make_unique<PerfCounters>();
+  std::array<std::vector<double>, kNumPerfEvents> perf_counts;
+
+  // Sampling planners draw repeat r from seed stream r ("seed_per_repeat",
+  // default true), so repeats are independent runs rather than replays.
+  auto* sampling = dynamic_cast<SamplingPlanner*>(planner.get());
+  const SamplerConfig sampler = sampler_from_json(params);
+  const bool seed_per_repeat = params.value("seed_per_repeat", true);
+  if (sampling) sampling->set_free_space_sampling(params.value("free_space_sampling", true));
+
+  // "time_budget_ms": equal-time experiments for anytime planners.
+  auto* anytime = dynamic_cast<AnytimePlanner*>(planner.get());
+  const double time_budget_ms = params.value("time_budget_ms", 0.0);
+  if (anytime)
+    anytime->set_time_budget_ms(time_budget_ms);
+  else if (time_budget_ms > 0)
+    std::cerr << "Warning: " << planner_name << " has no time budget, ignoring it\n";
+  // Roadmap planners (prm, spars) build from one seed per entry: their query
+  // is deterministic, and a stream per repeat would build and cache a
+  // roadmap per repeat that is never used again.
+  const bool roadmap_planner = dynamic_cast<PRMPlanner*>(planner.get()) != nullptr;
+  auto use_stream = [&](int r) {
+    if (!sampling) return;
+    SamplerConfig c = sampler;
+    if (seed_per_repeat && !roadmap_planner)
+      c.seed = stream_seed(sampler.seed, static_cast<uint64_t>(r));
+    sampling->set_sampler(c);
+  };
+
+  // PRM builds its roadmap once per environment and sampler seed and then
+  // only answers queries; "roadmap_file" loads a saved roadmap, or builds
+  // and saves one, so repeats (and later runs) skip the build entirely.
+  auto* prm = dynamic_cast<PRMPlanner*>(planner.get());
+  double roadmap_build_ms = 0.0, roadmap_load_ms = -1.0;
+  int roadmap_builds = 0;
+  Roadmap::BuildTimings stage_ms;  // summed over builds
+  auto count_build = [&] {
+    if (prm->last_build_ms() <= 0) return;
+    const auto& bt = prm->last_build_timings();
+    roadmap_build_ms += prm->last_build_ms();
+    ++roadmap_builds;
+    stage_ms.sample_ms += bt.sample_ms;
+    stage_ms.knn_ms += bt.knn_ms;
+    stage_ms.connect_ms += bt.connect_ms;
+    stage_ms.layout_ms += bt.layout_ms;
+  };
+  if (prm && params.contains("roadmap_file")) {
+    const std::string roadmap_file = params["roadmap_file"].get<std::string>();
+    // Files saved for another map or other settings are rejected and rebuilt.
+    use_stream(0);
+    const RoadmapProvenance provenance = prm->roadmap_provenance(*env);
+    timer.start();
+    auto roadmap = Roadmap::load(roadmap_file, provenance);
+    if (roadmap) {
+      roadmap_load_ms = timer.stop_ms();
+    } else {
+      roadmap = prm->roadmap(*env);
+      count_build();
+      if (!roadmap->save(roadmap_file, provenance))
+        std::cerr << "Warning: could not write roadmap to " << roadmap_file << "\n";
+    }
+    prm->set_roadmap(roadmap);
+  }
+
+  std::vector<double> path_lengths, times, nodes_vec, gaps, first_solution_ms;
+  std::vector<double> query_ms, edges_checked, tree_sizes, peak_tree_sizes;
+
+  // Optional post-processing of every path, timed apart from the planner;
+  // the metrics describe the processed path, the raw ones are kept too.
+  PathPostprocessOptions pp_options;
+  const bool postprocess = postprocess_from_json(exp, pp_options);
+  PathPostprocessor postprocessor(pp_options);
+  std::vector<double> pp_ms, pp_checks, raw_lengths, raw_smoothness, raw_energy;
+  std::vector<double> pp_lengths, pp_smoothness, pp_energy;
+  int successes = 0;
+
+  for (int w = 0; w < timing.warmup; ++w) {
+    use_stream(w);
+    planner->solve(*env, start, goal);
+    if (prm) count_build();
+  }
+
+  for (int r = 0; r < repeats; ++r) {
+    use_stream(r);
+    if (flusher) flusher->flush();
+    if (perf) perf->start();
+    timer.start();
+    Path path = planner->solve(*env, start, goal);
+    double ms = timer.stop_ms();
+    if (perf) {
+      const PerfSample sample = perf->stop();
+      for (size_t e = 0; e < kNumPerfEvents; ++e)
+        if (sample.valid[e]) perf_counts[e].push_back(sample.counts[e]);
+    }
+    if (raster && path.success)
+      path = raster->mapping.to_world(path, world_start, world_goal);
+
+    if (postprocess && path.success) {
+      Metrics raw = collector.collect(path, ms, 0, nullptr);
+      raw_lengths.push_back(raw.path_length);
+      raw_smoothness.push_back(raw.smoothness);
+      raw_energy.push_back(raw.energy);
+      path = postprocessor.process(*metrics_env, path);
+      const PathPostprocessStats& ps = postprocessor.stats();
+      pp_ms.push_back(ps.shortcut_ms + ps.bspline_ms);
+      pp_checks.push_back(ps.collision_checks);
+    }
+
+    Metrics m = collector.collect(path, ms, get_nodes(planner.get()), metrics_env);
+    if (postprocess && m.success) {
+      pp_lengths.push_back(m.path_length);
+      pp_smoothness.push_back(m.smoothness);
+      pp_energy.push_back(m.energy);
+    }
+    if (optimal_cost > 0 && m.success) {
+      m.gap_to_optimal = get_convergence(planner.get())->gap_to_optimal;
+      gaps.push_back(m.gap_to_optimal);
+    }
+    if (m.success) successes++;
+    const ConvergenceData* conv = get_convergence(planner.get());
+    if (conv && !conv->cost_vs_time.empty())
+      first_solution_ms.push_back(conv->cost_vs_time.front().first);
+    if (conv && !conv->tree_size_vs_time.empty()) {
+      int peak = 0;
+      for (const auto& [t, n] : conv->tree_size_vs_time) peak = std::max(peak, n);
+      tree_sizes.push_back(conv->tree_size_vs_time.back().second);
+      peak_tree_sizes.push_back(peak);
+    }
+    if (int checked = get_edges_checked(planner.get()); checked >= 0)
+      edges_checked.push_back(checked);
+    if (prm) {
+      count_build();
+      query_ms.push_back(prm->last_query_ms());
+    }
+    path_lengths.push_back(m.path_length);
+    times.push_back(ms);
+    nodes_vec.push_back(static_cast<double>(m.nodes_expanded));
+  }
+
+  // Parallel planners: re-time the query at 1, 2, 4, ... threads up to
+  // num_threads for a speedup curve relative to one thread. PRM rebuilds
+  // its roadmap on every sweep solve, since the build is what is parallel.
+  nlohmann::json speedup = nlohmann::json::array();
+  if (max_threads > 1 && set_num_threads(planner.get(), 1)) {
+    const int sweep_repeats = std::max(1, exp.value("speedup_repeats", std::min(repeats, 5)));
+    std::shared_ptr<const Roadmap> fixed_roadmap;
+    if (prm) {
+      if (params.contains("roadmap_file")) fixed_roadmap = prm->roadmap(*env);
+      prm->set_roadmap(nullptr);
+      prm->set_cache_roadmap(false);
+    }
+    double base_ms = 0;
+    for (int t = 1;; t = std::min(t * 2, max_threads)) {
+      set_num_threads(planner.get(), t);
+      double total_ms = 0, build_ms = 0;
+      int ok = 0;
+      for (int r = 0; r < sweep_repeats; ++r) {
+        use_stream(r);
+        timer.start();
+        ok += planner->solve(*env, start, goal).success ? 1 : 0;
+        total_ms += timer.stop_ms();
+        if (prm) build_ms += prm->last_build_ms();
+      }
+      double ms = total_ms / sweep_repeats;
+      if (t == 1) base_ms = ms;
+      nlohmann::json point = {{"threads", t}, {"mean_time_ms", ms},
+                              {"speedup", ms > 0 ? base_ms / ms : 0.0},
+                              {"success_rate", static_cast<double>(ok) / sweep_repeats}};
+      if (prm) point["roadmap_build_ms"] = build_ms / sweep_repeats;
+      speedup.push_back(point);
+      if (t == max_threads) break;
+    }
+    set_num_threads(planner.get(), max_threads);
+    if (prm) {
+      prm->set_cache_roadmap(true);
+      prm->set_roadmap(fixed_roadmap);
+    }
+  }
+
+  auto [ci_pl_l, ci_pl_h] = confidence_interval_95(path_lengths);
+  auto [ci_t_l, ci_t_h] = confidence_interval_95(times);
+  auto [ci_n_l, ci_n_h] = confidence_interval_95(nodes_vec);
+
+  nlohmann::json res;
+  res["planner"] = planner_name;
+  res["mean_path_length"] = mean(path_lengths);
+  res["std_path_length"] = std_dev(path_lengths);
+  res["mean_time_ms"] = mean(times);
+  res["std_time_ms"] = std_dev(times);
+  res["median_time_ms"] = median(times);
+  res["mad_time_ms"] = median_abs_deviation(times);
+  res["mean_nodes"] = mean(nodes_vec);
+  res["success_rate"] = static_cast<double>(successes) / repeats;
+  res["ci_path_length"] = {ci_pl_l, ci_pl_h};
+  res["ci_time_ms"] = {ci_t_l, ci_t_h};
+  res["repeats"] = repeats;
+  if (anytime && time_budget_ms > 0) {
+    res["time_budget_ms"] = time_budget_ms;
+    if (!first_solution_ms.empty())
+      res["mean_first_solution_ms"] = mean(first_solution_ms);
+  }
+  if (!edges_checked.empty()) res["mean_edges_checked"] = mean(edges_checked);
+  if (postprocess && !pp_ms.empty()) {
+    // Improvements are raw minus processed means over successful repeats.
+    res["postprocess"] = {
+        {"mean_ms", mean(pp_ms)},
+        {"mean_collision_checks", mean(pp_checks)},
+        {"raw_mean_path_length", mean(raw_lengths)},
+        {"raw_mean_smoothness", mean(raw_smoothness)},
+        {"raw_mean_energy", mean(raw_energy)},
+        {"length_reduction", mean(raw_lengths) - mean(pp_lengths)},
+        {"smoothness_reduction", mean(raw_smoothness) - mean(pp_smoothness)},
+        {"energy_reduction", mean(raw_energy) - mean(pp_energy)}};
+  }
+  if (!tree_sizes.empty()) {
+    res["mean_final_tree_size"] = mean(tree_sizes);
+    res["mean_peak_tree_size"] = mean(peak_tree_sizes);
+  }
+  if (prm) {
+    if (const Roadmap* roadmap = prm->last_roadmap()) {
+      res["roadmap_nodes"] = roadmap->num_nodes();
+      res["roadmap_edges"] = roadmap->num_edges();
+      res["roadmap_bytes"] = roadmap->data_bytes();
+      res["graph_bytes_per_edge"] = roadmap->num_edges() > 0
+          ? static_cast<double>(roadmap->graph().memory_bytes()) / roadmap->num_edges()
+          : 0.0;
+    }
+    res["roadmap_builds"] = roadmap_builds;
+    res["roadmap_build_ms"] = roadmap_build_ms;
+    if (roadmap_load_ms >= 0) res["roadmap_load_ms"] = roadmap_load_ms;
+    if (roadmap_builds > 0) {
+      const double b = roadmap_builds;
+      res["roadmap_stage_ms"] = {{"sample", stage_ms.sample_ms / b},
+                                 {"knn", stage_ms.knn_ms / b},
+                                 {"connect", stage_ms.connect_ms / b},
+                                 {"layout", stage_ms.layout_ms / b}};
+    }
+    res["mean_query_ms"] = mean(query_ms);
+    // Build cost spread over every query answered from the roadmaps.
+    res["amortized_query_ms"] = mean(query_ms) + roadmap_build_ms / repeats;
+  }
+  if (sampling) {
+    res["sampler"] = sampler.type;
+    res["seed"] = sampler.seed;
+  }
+  if (optimal_cost > 0) {
+    res["optimal_cost"] = optimal_cost;
+    res["mean_gap_to_optimal"] = gaps.empty() ? 0.0 : mean(gaps);
+    res["mean_relative_gap"] = gaps.empty() ? 0.0 : mean(gaps) / optimal_cost;
+  }
+  if (!speedup.empty()) {
+    res["num_threads"] = max_threads;
+    res["speedup"] = speedup;
+  }
+  res["timing"] = {{"timer", to_string(timer.source())},
+                   {"timer_overhead_ns", timer.overhead_ns()},
+                   {"warmup", timing.warmup},
+                   {"cache", to_string(timing.cache)},
+                   {"pinned_core", affinity.core()},
+                   {"pinned_cores", affinity.count()}};
+  if (timer.source() == TimerSource::Tsc) res["timing"]["tsc_ghz"] = timer.ticks_per_ns();
+  if (flusher) res["timing"]["flush_bytes"] = timing.flush_bytes;
+  if (perf) {
+    nlohmann::json pj = {{"available", perf->available()}};
+    if (!perf->available()) pj["error"] = perf->error();
+    for (size_t e = 0; e < kNumPerfEvents; ++e)
+      if (!perf_counts[e].empty())
+        pj[std::string("mean_") + perf_event_name(static_cast<PerfEvent>(e))] =
+            mean(perf_counts[e]);
+    if (pj.contains("mean_cycles") && pj.contains("mean_instructions") &&
+        pj["mean_cycles"].get<double>() > 0)
+      pj["ipc"] = pj["mean_instructions"].get<double>() / pj["mean_cycles"].get<double>();
+    res["perf"] = pj;
+  }
+  res["env_generation_ms"] = lookup.generation_ms;
+  res["env_cache_hit"] = lookup.hit;
+  if (raster) {
+    res["raster_resolution"] = raster->mapping.resolution;
+    res["raster_coverage"] = to_string(raster->coverage);
+    res["raster_cells"] = raster->mapping.width * raster->mapping.height;
+    res["raster_build_ms"] = raster->build_ms;
+  }
+  if (cache) {
+    CollisionCacheStats cs = cache->stats();
+    res["cache_hits"] = cs.hits;
+    res["cache_misses"] = cs.misses;
+    res["cache_hit_rate"] = cs.hit_rate();
+    res["cache_evictions"] = cs.evictions;
+    res["cache_memory_bytes"] = cache->memory_bytes();
+  }
+  return res;
+}
+
 }  // namespace
 
 void BenchmarkEngine::run(const std::string& config_path) {
@@ -124,76 +737,51 @@ void BenchmarkEngine::run(const std::string& config_path) {
     return;
   }
 
-  MetricsCollector collector;
+  // Entries run as independent tasks; results keep the config order.
+  const auto& experiments = config["experiments"];
+  std::vector<nlohmann::json> slots(experiments.size());
+  EnvironmentCache environments;
+  TaskScheduler scheduler(jobs_, pin_workers_);
+  // Entries with planner threads are not pinned to their worker's core.
+  scheduler.run(experiments.size(), [&](size_t i, int) {
+    slots[i] = run_experiment(experiments[i], environments, perf_counters_);
+  }, [&](size_t i) {
+    const auto params = experiments[i].value("planner_params", nlohmann::json::object());
+    return params.value("num_threads", 1) == 1;
+  });
   nlohmann::json results = nlohmann::json::array();
-
-  for (const auto& exp : config["experiments"]) {
-    auto env_j = exp["environment"];
-    MapGeneratorParams mgp = params_from_json(env_j);
-    MapGenerator gen;
-    GridEnvironment env = gen.generate(mgp);
-
-    std::string planner_name = exp.value("planner", "astar");
-    auto planner = create_planner(planner_name, exp.value("planner_params", nlohmann::json::object()));
-    if (!planner) {
-      std::cerr << "Error: unknown planner " << planner_name << "\n";
-      continue;
-    }
-
-    State start(exp["start"][1].get<int>(), exp["start"][0].get<int>());
-    State goal(exp["goal"][1].get<int>(), exp["goal"][0].get<int>());
-    int repeats = exp.value("repeats", 30);
-
-    std::vector<double> path_lengths, times, nodes_vec;
-    int successes = 0;
-
-    for (int r = 0; r < repeats; ++r) {
-      auto t0 = std::chrono::high_resolution_clock::now();
-      Path path = planner->solve(env, start, goal);
-      auto t1 = std::chrono::high_resolution_clock::now();
-      double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
-
-      Metrics m = collector.collect(path, ms, get_nodes(planner.get()), &env);
-      if (m.success) successes++;
-      path_lengths.push_back(m.path_length);
-      times.push_back(ms);
-      nodes_vec.push_back(static_cast<double>(m.nodes_expanded));
-    }
-
-    auto [ci_pl_l, ci_pl_h] = confidence_interval_95(path_lengths);
-    auto [ci_t_l, ci_t_h] = confidence_interval_95(times);
-    auto [ci_n_l, ci_n_h] = confidence_interval_95(nodes_vec);
-
-    nlohmann::json res;
-    res["planner"] = planner_name;
-    res["mean_path_length"] = mean(path_lengths);
-    res["std_path_length"] = std_dev(path_lengths);
-    res["mean_time_ms"] = mean(times);
-    res["std_time_ms"] = std_dev(times);
-    res["mean_nodes"] = mean(nodes_vec);
-    res["success_rate"] = static_cast<double>(successes) / repeats;
-    res["ci_path_length"] = {ci_pl_l, ci_pl_h};
-    res["ci_time_ms"] = {ci_t_l, ci_t_h};
-    res["repeats"] = repeats;
-    results.push_back(res);
-  }
+  for (auto& r : slots)
+    if (!r.is_null()) results.push_back(std::move(r));
 
   std::string base_path = config_path;
   size_t dot = base_path.rfind('.');
   if (dot != std::string::npos) base_path = base_path.substr(0, dot);
 
   std::ofstream jf(base_path + "_results.json");
-  jf << nlohmann::json{{"results", results}}.dump(2);
+  nlohmann::json env_stats = {{"environments", environments.size()},
+                               {"hits", environments.hits()},
+                               {"generation_ms", environments.generation_ms()}};
+  jf << nlohmann::json{{"results", results}, {"environment_cache", env_stats}}.dump(2);
 
   std::ofstream cf(base_path + "_results.csv");
   cf << "planner,mean_path_length,std_path_length,mean_time_ms,std_time_ms,"
-     << "mean_nodes,success_rate,ci_low,ci_high\n";
+     << "mean_nodes,success_rate,ci_low,ci_high";
+  for (size_t e = 0; e < kNumPerfEvents; ++e)
+    cf << ",mean_" << perf_event_name(static_cast<PerfEvent>(e));
+  cf << "\n";
   for (const auto& r : results) {
     cf << r["planner"] << "," << r["mean_path_length"] << ","
        << r["std_path_length"] << "," << r["mean_time_ms"] << ","
        << r["std_time_ms"] << "," << r["mean_nodes"] << ","
        << r["success_rate"] << "," << r["ci_time_ms"][0] << ","
-       << r["ci_time_ms"][1] << "\n";
+       << r["ci_time_ms"][1];
+    // Counter columns stay empty where counters were off or unavailable.
+    for (size_t e = 0; e < kNumPerfEvents; ++e) {
+      const std::string key = std::string("mean_") + perf_event_name(static_cast<PerfEvent>(e));
+      cf << ",";
+      if (r.contains("perf") && r["perf"].contains(key)) cf << r["perf"][key];
+    }
+    cf << "\n";
   }
   std::cout << "Results written to " << base_path << "_results.json and .csv\n";
 }
@@ -0,0 +1,55 @@
+#include "benchmark/environment_cache.hpp"
+#include <chrono>
+#include <vector>
+
+namespace pbs {
+
+EnvironmentLookup EnvironmentCache::get_or_generate(const std::string& key,
+                                                    const Generate& generate) {
+  std::shared_ptr<Entry> entry;
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto& slot = entries_[key];
+    if (!slot) slot = std::make_shared<Entry>();
+    entry = slot;
+  }
+  // Only the entry is locked while generating, so other keys proceed.
+  std::lock_guard<std::mutex> lock(entry->mu);
+  EnvironmentLookup out;
+  if (entry->env) {
+    out.env = entry->env;
+    out.hit = true;
+    ++hits_;
+    return out;
+  }
+  auto t0 = std::chrono::steady_clock::now();
+  entry->env = generate();
+  entry->generation_ms = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - t0).count();
+  out.env = entry->env;
+  out.generation_ms = entry->generation_ms;
+  return out;
+}
+
+size_t EnvironmentCache::size() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return entries_.size();
+}
+
+uint64_t EnvironmentCache::hits() const { return hits_; }
+
+double EnvironmentCache::generation_ms() const {
+  std::vector<std::shared_ptr<Entry>> entries;
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    for (const auto& [key, entry] : entries_) entries.push_back(entry);
+  }
+  double total = 0.0;
+  for (const auto& entry : entries) {
+    std::lock_guard<std::mutex> entry_lock(entry->mu);
+    total += entry->generation_ms;
+  }
+  return total;
+}
+
+}  // namespace pbs
@@ -0,0 +1,114 @@
+#include "benchmark/perf_counters.hpp"
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace pbs {
+
+const char* perf_event_name(PerfEvent event) {
+  switch (event) {
+    case PerfEvent::Cycles: return "cycles";
+    case PerfEvent::Instructions: return "instructions";
+    case PerfEvent::L1dMisses: return "l1d_misses";
+    case PerfEvent::LlcMisses: return "llc_misses";
+    case PerfEvent::BranchMisses: return "branch_misses";
+  }
+  return "";
+}
+
+#if defined(__linux__)
+
+namespace {
+
+void describe(PerfEvent event, perf_event_attr& attr) {
+  auto cache = [&](uint64_t id) {
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = id | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+  };
+  attr.type = PERF_TYPE_HARDWARE;
+  switch (event) {
+    case PerfEvent::Cycles: attr.config = PERF_COUNT_HW_CPU_CYCLES; break;
+    case PerfEvent::Instructions: attr.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+    case PerfEvent::L1dMisses: cache(PERF_COUNT_HW_CACHE_L1D); break;
+    case PerfEvent::LlcMisses: cache(PERF_COUNT_HW_CACHE_LL); break;
+    case PerfEvent::BranchMisses: attr.config = PERF_COUNT_HW_BRANCH_MISSES; break;
+  }
+}
+
+int open_event(PerfEvent event, int group_fd) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  describe(event, attr);
+  attr.disabled = group_fd < 0 ? 1 : 0;  // Members follow the leader
+  attr.exclude_kernel = 1;  // Allowed at perf_event_paranoid 2
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                     PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+
+}  // namespace
+
+PerfCounters::PerfCounters() {
+  fds_.fill(-1);
+  for (size_t e = 0; e < kNumPerfEvents; ++e) {
+    const int fd = open_event(static_cast<PerfEvent>(e), leader_);
+    if (fd < 0) {
+      if (error_.empty())
+        error_ = std::string(perf_event_name(static_cast<PerfEvent>(e))) + ": " +
+                 std::strerror(errno);
+      continue;
+    }
+    if (leader_ < 0) leader_ = fd;
+    fds_[e] = fd;
+    slot_[e] = opened_++;
+  }
+  if (available()) error_.clear();
+}
+
+PerfCounters::~PerfCounters() {
+  for (int fd : fds_)
+    if (fd >= 0) close(fd);
+}
+
+void PerfCounters::start() {
+  if (!available()) return;
+  ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+PerfSample PerfCounters::stop() {
+  PerfSample sample;
+  if (!available()) return sample;
+  ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+  // Group read: nr, time_enabled, time_running, then one value per event.
+  uint64_t buf[3 + kNumPerfEvents] = {};
+  if (read(leader_, buf, sizeof(buf)) < static_cast<ssize_t>(3 * sizeof(uint64_t)) ||
+      buf[0] != opened_ || buf[2] == 0)
+    return sample;
+  const double scale = static_cast<double>(buf[1]) / static_cast<double>(buf[2]);
+  for (size_t e = 0; e < kNumPerfEvents; ++e) {
+    if (fds_[e] < 0) continue;
+    sample.counts[e] = static_cast<double>(buf[3 + slot_[e]]) * scale;
+    sample.valid[e] = true;
+  }
+  return sample;
+}
+
+#else
+
+PerfCounters::PerfCounters() : error_("perf_event_open is Linux only") { fds_.fill(-1); }
+PerfCounters::~PerfCounters() = default;
+void PerfCounters::start() {}
+PerfSample PerfCounters::stop() { return {}; }
+
+#endif
+
+}  // namespace pbs
@@ -1,4 +1,5 @@
 #include "benchmark/statistics.hpp"
+#include <algorithm>
 #include <cmath>
 
 namespace pbs {
@@ -22,4 +23,21 @@ std::pair<double, double> confidence_interval_95(const std::vector<double>& v) {
   return {m - err, m + err};
 }
 
+double median(std::vector<double> v) {
+  if (v.empty()) return 0;
+  const size_t mid = v.size() / 2;
+  std::nth_element(v.begin(), v.begin() + mid, v.end());
+  if (v.size() % 2 == 1) return v[mid];
+  const double upper = v[mid];
+  return (*std::max_element(v.begin(), v.begin() + mid) + upper) / 2;
+}
+
+double median_abs_deviation(const std::vector<double>& v) {
+  const double m = median(v);
+  std::vector<double> dev;
+  dev.reserve(v.size());
+  for (double x : v) dev.push_back(std::abs(x - m));
+  return median(std::move(dev));
+}
+
 }  // namespace pbs
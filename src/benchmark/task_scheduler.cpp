@@ -0,0 +1,96 @@
+#include "benchmark/task_scheduler.hpp"
+#include "benchmark/timing.hpp"
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pbs {
+
+namespace {
+
+struct WorkQueue {
+  std::mutex mutex;
+  std::deque<size_t> tasks;
+
+  bool pop_front(size_t& task) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (tasks.empty()) return false;
+    task = tasks.front();
+    tasks.pop_front();
+    return true;
+  }
+  bool steal_back(size_t& task) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (tasks.empty()) return false;
+    task = tasks.back();
+    tasks.pop_back();
+    return true;
+  }
+};
+
+// Core for worker w: w modulo the core count.
+int worker_core(int worker) {
+  const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+  return static_cast<int>(static_cast<unsigned>(worker) % cores);
+}
+
+}  // namespace
+
+TaskScheduler::TaskScheduler(int workers, bool pin_to_cores)
+  : workers_(workers > 0 ? workers
+                         : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))),
+    pin_(pin_to_cores) {}
+
+void TaskScheduler::run(size_t num_tasks,
+                        const std::function<void(size_t task, int worker)>& fn,
+                        const std::function<bool(size_t task)>& pinnable) const {
+  // The pin holds for one task and the worker's previous mask comes back
+  // after it, so neither the caller nor an unpinnable task inherits it.
+  auto run_task = [&](size_t task, int w) {
+    const bool pin = pin_ && (!pinnable || pinnable(task));
+    ScopedAffinity affinity(pin ? worker_core(w) : -1);
+    fn(task, w);
+  };
+  const int n = static_cast<int>(std::min<size_t>(static_cast<size_t>(workers_),
+                                                  std::max<size_t>(num_tasks, 1)));
+  if (n <= 1) {
+    for (size_t t = 0; t < num_tasks; ++t) run_task(t, 0);
+    return;
+  }
+
+  std::vector<std::unique_ptr<WorkQueue>> queues;
+  for (int w = 0; w < n; ++w) queues.push_back(std::make_unique<WorkQueue>());
+  for (size_t t = 0; t < num_tasks; ++t) queues[t % n]->tasks.push_back(t);
+
+  std::mutex error_mutex;
+  std::exception_ptr error;
+  std::atomic<bool> failed{false};
+  auto worker = [&](int w) {
+    // No task spawns others, so once every deque is empty the work is done.
+    for (;;) {
+      if (failed.load(std::memory_order_relaxed)) return;
+      size_t task = 0;
+      bool found = queues[w]->pop_front(task);
+      for (int k = 1; !found && k < n; ++k) found = queues[(w + k) % n]->steal_back(task);
+      if (!found) return;
+      try {
+        run_task(task, w);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) error = std::current_exception();
+        failed = true;
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int w = 0; w < n; ++w) threads.emplace_back(worker, w);
+  for (auto& t : threads) t.join();
+  if (error) std::rethrow_exception(error);
+}
+
+}  // namespace pbs
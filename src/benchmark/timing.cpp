@@ -0,0 +1,121 @@
+#include "benchmark/timing.hpp"
+#include <algorithm>
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PBS_HAVE_TSC 1
+#endif
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace pbs {
+
+namespace {
+
+uint64_t steady_ns() {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint64_t read_tsc() {
+#ifdef PBS_HAVE_TSC
+  return __rdtsc();
+#else
+  return steady_ns();
+#endif
+}
+
+}  // namespace
+
+std::string to_string(TimerSource source) {
+  return source == TimerSource::Tsc ? "tsc" : "steady_clock";
+}
+
+std::string to_string(CacheMode mode) { return mode == CacheMode::Cold ? "cold" : "warm"; }
+
+SolveTimer::SolveTimer(TimerSource source) : source_(source) {
+#ifndef PBS_HAVE_TSC
+  source_ = TimerSource::SteadyClock;
+#endif
+  if (source_ == TimerSource::Tsc) {
+    // Ticks over a 10 ms steady-clock window.
+    const uint64_t n0 = steady_ns(), c0 = read_tsc();
+    uint64_t n1 = n0;
+    while (n1 - n0 < 10'000'000) n1 = steady_ns();
+    const uint64_t c1 = read_tsc();
+    ticks_per_ns_ = static_cast<double>(c1 - c0) / static_cast<double>(n1 - n0);
+  }
+  // Minimum of back-to-back reads: the part of every interval that is the
+  // timer itself rather than the timed code.
+  uint64_t best = UINT64_MAX;
+  for (int i = 0; i < 1000; ++i) {
+    const uint64_t a = now();
+    const uint64_t b = now();
+    best = std::min(best, b - a);
+  }
+  overhead_ns_ = to_ns(best);
+}
+
+uint64_t SolveTimer::now() const {
+  return source_ == TimerSource::Tsc ? read_tsc() : steady_ns();
+}
+
+double SolveTimer::to_ns(uint64_t ticks) const {
+  return source_ == TimerSource::Tsc ? ticks / ticks_per_ns_ : static_cast<double>(ticks);
+}
+
+double SolveTimer::stop_ms() const {
+  const double ns = to_ns(now() - t0_) - overhead_ns_;
+  return std::max(0.0, ns) * 1e-6;
+}
+
+CacheFlusher::CacheFlusher(size_t bytes)
+  : buffer_(new uint64_t[std::max<size_t>(bytes / sizeof(uint64_t), 1)]),
+    words_(std::max<size_t>(bytes / sizeof(uint64_t), 1)) {}
+
+void CacheFlusher::flush() {
+  // New values every round, so the writes cannot be skipped; one word per
+  // cache line is enough to own the line.
+  ++round_;
+  constexpr size_t kLine = 64 / sizeof(uint64_t);
+  for (size_t i = 0; i < words_; i += kLine) buffer_[i] = round_ + i;
+  uint64_t sum = 0;
+  for (size_t i = 0; i < words_; i += kLine) sum += buffer_[i];
+  sink_ = sum;
+}
+
+ScopedAffinity::ScopedAffinity(int core, int count) {
+#if defined(__linux__)
+  if (core < 0 || count < 1 || core + count > CPU_SETSIZE) return;
+  auto saved = std::make_unique<unsigned char[]>(sizeof(cpu_set_t));
+  auto* previous = reinterpret_cast<cpu_set_t*>(saved.get());
+  if (sched_getaffinity(0, sizeof(cpu_set_t), previous) != 0) return;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int c = core; c < core + count; ++c) CPU_SET(c, &set);
+  if (sched_setaffinity(0, sizeof(set), &set) != 0) return;
+  // The kernel drops offline or disallowed cores from the mask; a partial
+  // mask would quietly share cores, so it counts as not pinned.
+  cpu_set_t got;
+  if (sched_getaffinity(0, sizeof(got), &got) != 0 || !CPU_EQUAL(&got, &set)) {
+    sched_setaffinity(0, sizeof(cpu_set_t), previous);
+    return;
+  }
+  saved_ = std::move(saved);
+  core_ = core;
+  count_ = count;
+#else
+  (void)core;
+  (void)count;
+#endif
+}
+
+ScopedAffinity::~ScopedAffinity() {
+#if defined(__linux__)
+  if (saved_)
+    sched_setaffinity(0, sizeof(cpu_set_t), reinterpret_cast<cpu_set_t*>(saved_.get()));
+#endif
+}
+
+}  // namespace pbs
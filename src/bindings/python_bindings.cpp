@@ -12,10 +12,18 @@
 #include "planners/weighted_astar.hpp"
 #include "planners/thetastar.hpp"
 #include "planners/prm.hpp"
+#include "planners/roadmap.hpp"
+#include "planners/spars.hpp"
 #include "planners/lazy_prm.hpp"
+#include "planners/fmt_star.hpp"
 #include "planners/rrt.hpp"
 #include "planners/rrt_star.hpp"
+#include "planners/rrt_connect.hpp"
 #include "planners/informed_rrt_star.hpp"
+#include "planners/bit_star.hpp"
+#include "planners/sampler.hpp"
+#include "planners/visibility_graph_planner.hpp"
+#include "planners/path_postprocessor.hpp"
 #include "geometry/polygon.hpp"
 #include "benchmark/benchmark_engine.hpp"
 #include <nlohmann/json.hpp>
@@ -80,6 +88,11 @@ PYBIND11_MODULE(planning_benchmark, m) {
     .value("Euclidean", pbs::HeuristicType::Euclidean)
     .value("Diagonal", pbs::HeuristicType::Diagonal);
 
+  py::class_<pbs::SamplerConfig>(m, "SamplerConfig")
+    .def(py::init<>())
+    .def_readwrite("type", &pbs::SamplerConfig::type)
+    .def_readwrite("seed", &pbs::SamplerConfig::seed);
+
   // Base class must be registered before derived classes
   py::class_<pbs::IPlanner>(m, "IPlanner");
 
@@ -105,34 +118,98 @@ PYBIND11_MODULE(planning_benchmark, m) {
     .def("solve", &pbs::ThetaStarPlanner::solve)
     .def("nodes_expanded", &pbs::ThetaStarPlanner::nodes_expanded);
 
+  // Roadmaps are immutable once built; pybind11 holds them non-const.
+  py::class_<pbs::Roadmap, std::shared_ptr<pbs::Roadmap>>(m, "Roadmap")
+    .def_static("load", [](const std::string& path) {
+      return std::const_pointer_cast<pbs::Roadmap>(pbs::Roadmap::load(path));
+    })
+    .def("save", [](const pbs::Roadmap& r, const std::string& path) { return r.save(path); })
+    .def("num_nodes", &pbs::Roadmap::num_nodes)
+    .def("num_edges", &pbs::Roadmap::num_edges)
+    .def("data_bytes", &pbs::Roadmap::data_bytes)
+    .def("mapped", &pbs::Roadmap::mapped)
+    .def("build_ms", &pbs::Roadmap::build_ms);
+
   py::class_<pbs::PRMPlanner, pbs::IPlanner>(m, "PRMPlanner")
     .def(py::init<int, int>(), py::arg("num_samples") = 500, py::arg("k_neighbors") = 10)
     .def("solve", &pbs::PRMPlanner::solve)
-    .def("nodes_expanded", &pbs::PRMPlanner::nodes_expanded);
+    .def("nodes_expanded", &pbs::PRMPlanner::nodes_expanded)
+    .def("set_sampler", &pbs::PRMPlanner::set_sampler)
+    .def("set_free_space_sampling", &pbs::PRMPlanner::set_free_space_sampling)
+    .def("set_num_threads", &pbs::PRMPlanner::set_num_threads)
+    .def("roadmap", [](pbs::PRMPlanner& p, const pbs::IEnvironment& env) {
+      return std::const_pointer_cast<pbs::Roadmap>(p.roadmap(env));
+    })
+    .def("query", &pbs::PRMPlanner::query)
+    .def("set_roadmap", [](pbs::PRMPlanner& p, std::shared_ptr<pbs::Roadmap> r) {
+      p.set_roadmap(std::move(r));
+    })
+    .def("last_build_ms", &pbs::PRMPlanner::last_build_ms)
+    .def("last_query_ms", &pbs::PRMPlanner::last_query_ms);
+
+  py::class_<pbs::SPARSPlanner, pbs::PRMPlanner>(m, "SPARSPlanner")
+    .def(py::init<int, double, double, int, int>(),
+         py::arg("num_samples") = 20000, py::arg("sparse_delta") = 0.1,
+         py::arg("stretch") = 2.0, py::arg("max_failures") = 1000,
+         py::arg("k_neighbors") = 10)
+    .def("stretch", &pbs::SPARSPlanner::stretch);
 
   py::class_<pbs::LazyPRMPlanner, pbs::IPlanner>(m, "LazyPRMPlanner")
     .def(py::init<int, int>(), py::arg("num_samples") = 500, py::arg("k_neighbors") = 10)
     .def("solve", &pbs::LazyPRMPlanner::solve)
-    .def("nodes_expanded", &pbs::LazyPRMPlanner::nodes_expanded);
+    .def("nodes_expanded", &pbs::LazyPRMPlanner::nodes_expanded)
+    .def("edges_checked", &pbs::LazyPRMPlanner::edges_checked)
+    .def("set_sampler", &pbs::LazyPRMPlanner::set_sampler)
+    .def("set_free_space_sampling", &pbs::LazyPRMPlanner::set_free_space_sampling);
+
+  py::class_<pbs::FMTStarPlanner, pbs::IPlanner>(m, "FMTStarPlanner")
+    .def(py::init<int, double>(), py::arg("num_samples") = 1000, py::arg("radius_factor") = 1.1)
+    .def("solve", &pbs::FMTStarPlanner::solve)
+    .def("nodes_expanded", &pbs::FMTStarPlanner::nodes_expanded)
+    .def("edges_checked", &pbs::FMTStarPlanner::edges_checked)
+    .def("set_sampler", &pbs::FMTStarPlanner::set_sampler)
+    .def("set_free_space_sampling", &pbs::FMTStarPlanner::set_free_space_sampling);
 
   py::class_<pbs::RRTPlanner, pbs::IPlanner>(m, "RRTPlanner")
     .def(py::init<double, double, int>(),
          py::arg("step_size") = 1.0, py::arg("goal_bias") = 0.1, py::arg("max_iter") = 5000)
     .def("solve", &pbs::RRTPlanner::solve)
-    .def("nodes_expanded", &pbs::RRTPlanner::nodes_expanded);
+    .def("nodes_expanded", &pbs::RRTPlanner::nodes_expanded)
+    .def("set_num_threads", &pbs::RRTPlanner::set_num_threads)
+    .def("num_threads", &pbs::RRTPlanner::num_threads)
+    .def("set_sampler", &pbs::RRTPlanner::set_sampler)
+    .def("set_time_budget_ms", &pbs::RRTPlanner::set_time_budget_ms);
 
-  py::class_<pbs::RRTStarPlanner, pbs::IPlanner>(m, "RRTStarPlanner")
-    .def(py::init<double, double, int, double>(),
-         py::arg("step_size") = 1.0, py::arg("goal_bias") = 0.1,
-         py::arg("max_iter") = 5000, py::arg("gamma") = 10.0)
-    .def("solve", &pbs::RRTStarPlanner::solve)
-    .def("nodes_expanded", &pbs::RRTStarPlanner::nodes_expanded);
+  py::class_<pbs::RRTConnectPlanner, pbs::IPlanner>(m, "RRTConnectPlanner")
+    .def(py::init<double, double, int>(),
+         py::arg("step_size") = 1.0, py::arg("goal_bias") = 0.1, py::arg("max_iter") = 5000)
+    .def("solve", &pbs::RRTConnectPlanner::solve)
+    .def("nodes_expanded", &pbs::RRTConnectPlanner::nodes_expanded)
+    .def("set_sampler", &pbs::RRTConnectPlanner::set_sampler)
+    .def("set_time_budget_ms", &pbs::RRTConnectPlanner::set_time_budget_ms);
 
   py::class_<pbs::ConvergenceData>(m, "ConvergenceData")
     .def_readonly("cost_vs_iteration", &pbs::ConvergenceData::cost_vs_iteration)
+    .def_readonly("cost_vs_time", &pbs::ConvergenceData::cost_vs_time)
+    .def_readonly("tree_size_vs_time", &pbs::ConvergenceData::tree_size_vs_time)
     .def_readonly("final_cost", &pbs::ConvergenceData::final_cost)
     .def_readonly("gap_to_optimal", &pbs::ConvergenceData::gap_to_optimal);
 
+  py::class_<pbs::RRTStarPlanner, pbs::IPlanner>(m, "RRTStarPlanner")
+    .def(py::init<double, double, int, double>(),
+         py::arg("step_size") = 1.0, py::arg("goal_bias") = 0.1,
+         py::arg("max_iter") = 5000, py::arg("gamma") = 10.0)
+    .def("solve", &pbs::RRTStarPlanner::solve)
+    .def("nodes_expanded", &pbs::RRTStarPlanner::nodes_expanded)
+    .def("convergence_data", &pbs::RRTStarPlanner::convergence_data,
+         py::return_value_policy::reference_internal)
+    .def("set_optimal_cost", &pbs::RRTStarPlanner::set_optimal_cost)
+    .def("set_num_threads", &pbs::RRTStarPlanner::set_num_threads)
+    .def("num_threads", &pbs::RRTStarPlanner::num_threads)
+    .def("set_compact_storage", &pbs::RRTStarPlanner::set_compact_storage)
+    .def("set_sampler", &pbs::RRTStarPlanner::set_sampler)
+    .def("set_time_budget_ms", &pbs::RRTStarPlanner::set_time_budget_ms);
+
   py::class_<pbs::InformedRRTStarPlanner, pbs::IPlanner>(m, "InformedRRTStarPlanner")
     .def(py::init<double, double, int, double>(),
          py::arg("step_size") = 1.0, py::arg("goal_bias") = 0.1,
@@ -140,7 +217,56 @@ PYBIND11_MODULE(planning_benchmark, m) {
     .def("solve", &pbs::InformedRRTStarPlanner::solve)
     .def("nodes_expanded", &pbs::InformedRRTStarPlanner::nodes_expanded)
     .def("convergence_data", &pbs::InformedRRTStarPlanner::convergence_data,
-         py::return_value_policy::reference_internal);
+         py::return_value_policy::reference_internal)
+    .def("set_optimal_cost", &pbs::InformedRRTStarPlanner::set_optimal_cost)
+    .def("set_pruning", &pbs::InformedRRTStarPlanner::set_pruning)
+    .def("nodes_pruned", &pbs::InformedRRTStarPlanner::nodes_pruned)
+    .def("set_sampler", &pbs::InformedRRTStarPlanner::set_sampler)
+    .def("set_time_budget_ms", &pbs::InformedRRTStarPlanner::set_time_budget_ms);
+
+  py::class_<pbs::BITStarPlanner, pbs::IPlanner>(m, "BITStarPlanner")
+    .def(py::init<int, int, double>(),
+         py::arg("batch_size") = 100, py::arg("max_batches") = 20,
+         py::arg("rewire_factor") = 1.1)
+    .def("solve", &pbs::BITStarPlanner::solve)
+    .def("nodes_expanded", &pbs::BITStarPlanner::nodes_expanded)
+    .def("edges_checked", &pbs::BITStarPlanner::edges_checked)
+    .def("convergence_data", &pbs::BITStarPlanner::convergence_data,
+         py::return_value_policy::reference_internal)
+    .def("set_optimal_cost", &pbs::BITStarPlanner::set_optimal_cost)
+    .def("set_sampler", &pbs::BITStarPlanner::set_sampler)
+    .def("set_time_budget_ms", &pbs::BITStarPlanner::set_time_budget_ms);
+
+  py::class_<pbs::VisibilityGraphPlanner, pbs::IPlanner>(m, "VisibilityGraphPlanner")
+    .def(py::init<>())
+    .def("solve", &pbs::VisibilityGraphPlanner::solve)
+    .def("nodes_expanded", &pbs::VisibilityGraphPlanner::nodes_expanded);
+
+  py::enum_<pbs::ShortcutMode>(m, "ShortcutMode")
+    .value("None_", pbs::ShortcutMode::None)
+    .value("Greedy", pbs::ShortcutMode::Greedy)
+    .value("Random", pbs::ShortcutMode::Random);
+
+  py::class_<pbs::PathPostprocessOptions>(m, "PathPostprocessOptions")
+    .def(py::init<>())
+    .def_readwrite("shortcut", &pbs::PathPostprocessOptions::shortcut)
+    .def_readwrite("iterations", &pbs::PathPostprocessOptions::iterations)
+    .def_readwrite("batch_size", &pbs::PathPostprocessOptions::batch_size)
+    .def_readwrite("partial", &pbs::PathPostprocessOptions::partial)
+    .def_readwrite("bspline", &pbs::PathPostprocessOptions::bspline)
+    .def_readwrite("samples_per_span", &pbs::PathPostprocessOptions::samples_per_span)
+    .def_readwrite("seed", &pbs::PathPostprocessOptions::seed);
+
+  py::class_<pbs::PathPostprocessStats>(m, "PathPostprocessStats")
+    .def_readonly("shortcut_ms", &pbs::PathPostprocessStats::shortcut_ms)
+    .def_readonly("bspline_ms", &pbs::PathPostprocessStats::bspline_ms)
+    .def_readonly("collision_checks", &pbs::PathPostprocessStats::collision_checks)
+    .def_readonly("shortcuts", &pbs::PathPostprocessStats::shortcuts);
+
+  py::class_<pbs::PathPostprocessor>(m, "PathPostprocessor")
+    .def(py::init<const pbs::PathPostprocessOptions&>())
+    .def("process", &pbs::PathPostprocessor::process)
+    .def("stats", &pbs::PathPostprocessor::stats, py::return_value_policy::reference_internal);
 
   py::class_<pbs::Point2D>(m, "Point2D")
     .def(py::init<double, double>())
@@ -183,9 +309,9 @@ PYBIND11_MODULE(planning_benchmark, m) {
     int successes = 0;
     double total_len = 0, total_time = 0;
     for (int r = 0; r < repeats; ++r) {
-      auto t0 = std::chrono::high_resolution_clock::now();
+      auto t0 = std::chrono::steady_clock::now();
       pbs::Path path = planner.solve(env, start, goal);
-      auto t1 = std::chrono::high_resolution_clock::now();
+      auto t1 = std::chrono::steady_clock::now();
       double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
       if (path.success) { successes++; total_len += path.length; }
       total_time += ms;
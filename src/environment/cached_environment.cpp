@@ -0,0 +1,109 @@
+#include "environment/cached_environment.hpp"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace pbs {
+
+namespace {
+
+// Slot layout: bit 0 = occupied, bit 1 = collision-free, bits 2..63 = key tag.
+constexpr uint64_t kOccupied = 1;
+constexpr uint64_t kFree = 2;
+constexpr uint64_t kTagMask = ~uint64_t{3};
+
+uint64_t mix(uint64_t h, uint64_t v) {
+  h ^= v + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+  h ^= h >> 33;
+  h *= 0xFF51AFD7ED558CCDull;
+  h ^= h >> 33;
+  return h;
+}
+
+size_t round_up_pow2(size_t n) {
+  size_t p = 1;
+  while (p < n) p <<= 1;
+  return p;
+}
+
+}  // namespace
+
+CachedEnvironment::CachedEnvironment(std::shared_ptr<const IEnvironment> inner,
+                                     size_t capacity, double quantum)
+  : EnvironmentDecorator(std::move(inner)),
+    inv_quantum_(1.0 / quantum),
+    mask_(round_up_pow2(capacity < kMaxProbe ? kMaxProbe : capacity) - 1),
+    slots_(new std::atomic<uint64_t>[mask_ + 1]) {
+  clear();
+}
+
+uint64_t CachedEnvironment::segment_hash(const State& a, const State& b) const {
+  auto q = [this](double v) {
+    return static_cast<uint64_t>(std::llround(v * inv_quantum_));
+  };
+  uint64_t ka[3] = {q(a.x), q(a.y), a.theta ? q(*a.theta) ^ 1 : 0};
+  uint64_t kb[3] = {q(b.x), q(b.y), b.theta ? q(*b.theta) ^ 1 : 0};
+  // Segments are undirected: order endpoints canonically.
+  if (std::lexicographical_compare(kb, kb + 3, ka, ka + 3))
+    std::swap(ka, kb);
+  uint64_t h = 0;
+  for (uint64_t v : ka) h = mix(h, v);
+  for (uint64_t v : kb) h = mix(h, v);
+  return h;
+}
+
+bool CachedEnvironment::collision_free(const State& a, const State& b) const {
+  const uint64_t h = segment_hash(a, b);
+  uint64_t tag = h & kTagMask;
+  if (tag == 0) tag = 4;
+  const size_t home = static_cast<size_t>(h) & mask_;
+
+  for (size_t i = 0; i < kMaxProbe; ++i) {
+    uint64_t s = slots_[(home + i) & mask_].load(std::memory_order_acquire);
+    if (s == 0) break;
+    if ((s & kTagMask) == tag) {
+      hits_.fetch_add(1, std::memory_order_relaxed);
+      return (s & kFree) != 0;
+    }
+  }
+  misses_.fetch_add(1, std::memory_order_relaxed);
+
+  const bool free = inner_->collision_free(a, b);
+  const uint64_t entry = tag | kOccupied | (free ? kFree : 0);
+  for (size_t i = 0; i < kMaxProbe; ++i) {
+    auto& slot = slots_[(home + i) & mask_];
+    uint64_t expected = 0;
+    if (slot.compare_exchange_strong(expected, entry, std::memory_order_acq_rel)) {
+      inserts_.fetch_add(1, std::memory_order_relaxed);
+      return free;
+    }
+    if ((expected & kTagMask) == tag) return free;  // Raced with same key
+  }
+  slots_[home].store(entry, std::memory_order_release);
+  evictions_.fetch_add(1, std::memory_order_relaxed);
+  return free;
+}
+
+CollisionCacheStats CachedEnvironment::stats() const {
+  CollisionCacheStats s;
+  s.hits = hits_.load(std::memory_order_relaxed);
+  s.misses = misses_.load(std::memory_order_relaxed);
+  s.inserts = inserts_.load(std::memory_order_relaxed);
+  s.evictions = evictions_.load(std::memory_order_relaxed);
+  return s;
+}
+
+void CachedEnvironment::reset_stats() {
+  hits_ = 0;
+  misses_ = 0;
+  inserts_ = 0;
+  evictions_ = 0;
+}
+
+void CachedEnvironment::clear() {
+  for (size_t i = 0; i <= mask_; ++i)
+    slots_[i].store(0, std::memory_order_relaxed);
+  reset_stats();
+}
+
+}  // namespace pbs
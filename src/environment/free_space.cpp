@@ -0,0 +1,73 @@
+#include "environment/free_space.hpp"
+#include "environment/continuous_environment.hpp"
+#include "environment/environment_decorator.hpp"
+#include "environment/grid_environment.hpp"
+#include <algorithm>
+
+namespace pbs {
+
+FreeCellSampler::FreeCellSampler(std::vector<uint32_t> cells, int width, int height)
+  : cells_(std::move(cells)), width_(width), height_(height) {}
+
+void FreeCellSampler::map(double u, double v, double& x, double& y) const {
+  const double t = u * static_cast<double>(cells_.size());
+  const size_t k = std::min(static_cast<size_t>(t), cells_.size() - 1);
+  const uint32_t cell = cells_[k];
+  x = static_cast<double>(cell % static_cast<uint32_t>(width_)) + (t - static_cast<double>(k));
+  y = static_cast<double>(cell / static_cast<uint32_t>(width_)) + v;
+}
+
+double FreeCellSampler::free_fraction() const {
+  return static_cast<double>(cells_.size()) / (static_cast<double>(width_) * height_);
+}
+
+TrapezoidSampler::TrapezoidSampler(std::vector<Trapezoid> trapezoids, double bounds_area)
+  : trapezoids_(std::move(trapezoids)), bounds_area_(bounds_area) {
+  double total = 0;
+  for (const auto& t : trapezoids_) cumulative_.push_back(total += t.area());
+}
+
+void TrapezoidSampler::map(double u, double v, double& x, double& y) const {
+  const double t = u * cumulative_.back();
+  const size_t k = std::min<size_t>(
+      std::upper_bound(cumulative_.begin(), cumulative_.end(), t) - cumulative_.begin(),
+      trapezoids_.size() - 1);
+  const double before = k > 0 ? cumulative_[k - 1] : 0.0;
+  const double area = cumulative_[k] - before;
+  const double w = area > 0 ? std::clamp((t - before) / area, 0.0, 1.0) : 0.0;
+  trapezoids_[k].map(w, v, x, y);
+}
+
+double TrapezoidSampler::free_fraction() const {
+  return bounds_area_ > 0 ? cumulative_.back() / bounds_area_ : 0.0;
+}
+
+std::shared_ptr<const FreeSpaceSampler> free_space_sampler(const IEnvironment& env) {
+  if (const auto* scene = env_cast<ContinuousEnvironment>(env)) {
+    return scene->preprocessing_cache().get_or_build<TrapezoidSampler>(
+        "free_space/trapezoids", [&]() -> std::shared_ptr<const TrapezoidSampler> {
+          double x_min = 0, x_max = 0, y_min = 0, y_max = 0;
+          scene->get_bounds(x_min, x_max, y_min, y_max);
+          auto traps = trapezoidal_decomposition(x_min, x_max, y_min, y_max, scene->obstacles());
+          if (traps.empty()) return nullptr;
+          return std::make_shared<const TrapezoidSampler>(std::move(traps),
+                                                          (x_max - x_min) * (y_max - y_min));
+        });
+  }
+  if (const auto* grid = env_cast<GridEnvironment>(env)) {
+    return grid->preprocessing_cache().get_or_build<FreeCellSampler>(
+        "free_space/cells", [&]() -> std::shared_ptr<const FreeCellSampler> {
+          std::vector<uint32_t> cells;
+          for (int r = 0; r < grid->height(); ++r)
+            for (int c = 0; c < grid->width(); ++c)
+              if (!grid->occupied(r, c))
+                cells.push_back(static_cast<uint32_t>(r) * grid->width() + c);
+          if (cells.empty()) return nullptr;
+          return std::make_shared<const FreeCellSampler>(std::move(cells), grid->width(),
+                                                         grid->height());
+        });
+  }
+  return nullptr;
+}
+
+}  // namespace pbs
@@ -0,0 +1,50 @@
+#include "environment/preprocessing_cache.hpp"
+#include "environment/continuous_environment.hpp"
+#include "environment/environment_decorator.hpp"
+#include "environment/grid_environment.hpp"
+
+namespace pbs {
+
+PreprocessingCache* preprocessing_cache_of(const IEnvironment& env) {
+  if (const auto* scene = env_cast<ContinuousEnvironment>(env)) return &scene->preprocessing_cache();
+  if (const auto* grid = env_cast<GridEnvironment>(env)) return &grid->preprocessing_cache();
+  return nullptr;
+}
+
+uint64_t hash_bytes(const void* data, size_t bytes, uint64_t h) {
+  const auto* p = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < bytes; ++i) {
+    h ^= p[i];
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+uint64_t environment_hash(const IEnvironment& env) {
+  auto mix = [](uint64_t h, auto value) { return hash_bytes(&value, sizeof(value), h); };
+  uint64_t h = hash_bytes(nullptr, 0);
+  if (const auto* grid = env_cast<GridEnvironment>(env)) {
+    h = mix(mix(h, grid->width()), grid->height());
+    for (int r = 0; r < grid->height(); ++r)
+      for (int c = 0; c < grid->width(); ++c) h = mix(h, grid->occupied(r, c));
+    return h;
+  }
+  double x_min = 0, x_max = 0, y_min = 0, y_max = 0;
+  env.get_bounds(x_min, x_max, y_min, y_max);
+  h = mix(mix(mix(mix(h, x_min), x_max), y_min), y_max);
+  if (const auto* scene = env_cast<ContinuousEnvironment>(env)) {
+    for (const auto& poly : scene->obstacles()) {
+      h = mix(h, poly.size());
+      for (const auto& v : poly.vertices()) h = mix(mix(h, v.x), v.y);
+    }
+    return h;
+  }
+  constexpr int kLattice = 256;
+  for (int i = 0; i < kLattice; ++i)
+    for (int j = 0; j < kLattice; ++j)
+      h = mix(h, env.is_valid(State(x_min + (x_max - x_min) * (i + 0.5) / kLattice,
+                                    y_min + (y_max - y_min) * (j + 0.5) / kLattice)));
+  return h;
+}
+
+}  // namespace pbs
@@ -0,0 +1,192 @@
+#include "environment/rasterizer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace pbs {
+
+namespace {
+
+struct Extent {
+  double x_min, y_min, x_max, y_max;
+};
+
+// x of every edge crossing the horizontal line y (half-open in y), sorted.
+void crossings(const Polygon& poly, double y, std::vector<double>& xs) {
+  xs.clear();
+  const auto& v = poly.vertices();
+  for (size_t i = 0, j = v.size() - 1; i < v.size(); j = i++) {
+    const Point2D& a = v[j];
+    const Point2D& b = v[i];
+    if ((a.y <= y) != (b.y <= y))
+      xs.push_back(a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y));
+  }
+  std::sort(xs.begin(), xs.end());
+}
+
+class RowRasterizer {
+ public:
+  RowRasterizer(const std::vector<Polygon>& polys, const std::vector<Extent>& ext,
+                const GridMapping& m, RasterCoverage coverage)
+    : polys_(polys), ext_(ext), m_(m), coverage_(coverage) {}
+
+  void run(int row, std::vector<int>& out) {
+    const double y0 = m_.y_min + row * m_.resolution;
+    const double y1 = y0 + m_.resolution;
+    for (size_t k = 0; k < polys_.size(); ++k) {
+      const Extent& e = ext_[k];
+      if (e.y_max < y0 || e.y_min > y1) continue;
+      if (coverage_ == RasterCoverage::Center) {
+        fill_centers(polys_[k], y0 + 0.5 * m_.resolution, out);
+      } else {
+        mark_edges(polys_[k], y0, y1, out);
+        fill_cells(polys_[k], y0, out);
+        fill_cells(polys_[k], y1, out);
+      }
+    }
+  }
+
+ private:
+  // Closed interval: an endpoint on a cell border blocks both neighbours.
+  void mark(double xa, double xb, std::vector<int>& out) const {
+    int c0 = static_cast<int>(std::ceil((xa - m_.x_min) / m_.resolution)) - 1;
+    int c1 = static_cast<int>(std::floor((xb - m_.x_min) / m_.resolution));
+    c0 = std::max(c0, 0);
+    c1 = std::min(c1, m_.width - 1);
+    for (int c = c0; c <= c1; ++c) out[c] = 1;
+  }
+
+  // Interior spans on the line y: every touched cell is blocked.
+  void fill_cells(const Polygon& poly, double y, std::vector<int>& out) {
+    crossings(poly, y, xs_);
+    for (size_t i = 0; i + 1 < xs_.size(); i += 2) mark(xs_[i], xs_[i + 1], out);
+  }
+
+  // Boundary: x-extent of each edge clipped to the band [y0, y1].
+  void mark_edges(const Polygon& poly, double y0, double y1, std::vector<int>& out) const {
+    const auto& v = poly.vertices();
+    for (size_t i = 0, j = v.size() - 1; i < v.size(); j = i++) {
+      const Point2D& a = v[j];
+      const Point2D& b = v[i];
+      if (std::max(a.y, b.y) < y0 || std::min(a.y, b.y) > y1) continue;
+      double xa = a.x, xb = b.x;
+      if (a.y != b.y) {
+        double ta = std::clamp((y0 - a.y) / (b.y - a.y), 0.0, 1.0);
+        double tb = std::clamp((y1 - a.y) / (b.y - a.y), 0.0, 1.0);
+        xa = a.x + ta * (b.x - a.x);
+        xb = a.x + tb * (b.x - a.x);
+      }
+      mark(std::min(xa, xb), std::max(xa, xb), out);
+    }
+  }
+
+  // Cells whose center lies in an interior span of the line y.
+  void fill_centers(const Polygon& poly, double y, std::vector<int>& out) {
+    crossings(poly, y, xs_);
+    for (size_t i = 0; i + 1 < xs_.size(); i += 2) {
+      int c0 = static_cast<int>(std::ceil((xs_[i] - m_.x_min) / m_.resolution - 0.5));
+      int c1 = static_cast<int>(std::floor((xs_[i + 1] - m_.x_min) / m_.resolution - 0.5));
+      c0 = std::max(c0, 0);
+      c1 = std::min(c1, m_.width - 1);
+      for (int c = c0; c <= c1; ++c) out[c] = 1;
+    }
+  }
+
+  const std::vector<Polygon>& polys_;
+  const std::vector<Extent>& ext_;
+  const GridMapping& m_;
+  RasterCoverage coverage_;
+  std::vector<double> xs_;
+};
+
+}  // namespace
+
+RasterCoverage parse_raster_coverage(const std::string& s) {
+  if (s == "center") return RasterCoverage::Center;
+  return RasterCoverage::Conservative;
+}
+
+const char* to_string(RasterCoverage c) {
+  return c == RasterCoverage::Center ? "center" : "conservative";
+}
+
+State GridMapping::to_cell(const State& s) const {
+  int col = static_cast<int>(std::floor((s.x - x_min) / resolution));
+  int row = static_cast<int>(std::floor((s.y - y_min) / resolution));
+  return State(std::clamp(row, 0, height - 1), std::clamp(col, 0, width - 1));
+}
+
+State GridMapping::to_world(const State& cell) const {
+  return State(x_min + (cell.x + 0.5) * resolution, y_min + (cell.y + 0.5) * resolution);
+}
+
+Path GridMapping::to_world(const Path& grid_path, const State& start,
+                           const State& goal) const {
+  Path out;
+  out.success = grid_path.success;
+  for (const auto& s : grid_path.states) out.states.push_back(to_world(s));
+  if (!out.states.empty()) {
+    out.states.front() = State(start.x, start.y);
+    out.states.back() = State(goal.x, goal.y);
+  }
+  out.compute_length();
+  return out;
+}
+
+RasterGrid rasterize(const ContinuousEnvironment& env, double resolution,
+                     RasterCoverage coverage, int num_threads) {
+  auto t0 = std::chrono::steady_clock::now();
+  GridMapping m;
+  double x_max = 0, y_max = 0;
+  env.get_bounds(m.x_min, x_max, m.y_min, y_max);
+  m.resolution = resolution > 0 ? resolution : 1.0;
+  m.width = std::max(1, static_cast<int>(std::ceil((x_max - m.x_min) / m.resolution - 1e-9)));
+  m.height = std::max(1, static_cast<int>(std::ceil((y_max - m.y_min) / m.resolution - 1e-9)));
+
+  std::vector<Polygon> polys;
+  std::vector<Extent> ext;
+  for (const auto& p : env.obstacles()) {
+    if (p.size() < 3) continue;
+    Extent e{};
+    p.get_bounding_box(e.x_min, e.y_min, e.x_max, e.y_max);
+    polys.push_back(p);
+    ext.push_back(e);
+  }
+
+  std::vector<std::vector<int>> occ(m.height, std::vector<int>(m.width, 0));
+  if (num_threads <= 0)
+    num_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+  // Small grids are not worth a thread each; keep at least 32 rows per worker.
+  num_threads = std::clamp(m.height / 32, 1, num_threads);
+
+  // Rows are independent, so workers take interleaved rows without locking.
+  auto work = [&](int tid) {
+    RowRasterizer rr(polys, ext, m, coverage);
+    for (int r = tid; r < m.height; r += num_threads) rr.run(r, occ[r]);
+  };
+  std::vector<std::thread> workers;
+  for (int t = 1; t < num_threads; ++t) workers.emplace_back(work, t);
+  work(0);
+  for (auto& w : workers) w.join();
+
+  RasterGrid out{GridEnvironment(m.width, m.height, std::move(occ)), m, coverage, 0.0};
+  out.build_ms = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - t0).count();
+  return out;
+}
+
+std::shared_ptr<const RasterGrid> rasterize_cached(
+    const ContinuousEnvironment& env, double resolution, RasterCoverage coverage,
+    int num_threads) {
+  char key[64];
+  std::snprintf(key, sizeof(key), "raster/%.9g/%s", resolution, to_string(coverage));
+  return env.preprocessing_cache().get_or_build<RasterGrid>(key, [&] {
+    return std::make_shared<const RasterGrid>(
+        rasterize(env, resolution, coverage, num_threads));
+  });
+}
+
+}  // namespace pbs
@@ -1,20 +1,142 @@
 #include "environment/se2_environment.hpp"
+#include <algorithm>
+#include <cmath>
 
 namespace pbs {
 
+namespace {
+
+double wrap_pi(double a) {
+  a = std::fmod(a + M_PI, 2 * M_PI);
+  if (a < 0) a += 2 * M_PI;
+  return a - M_PI;
+}
+
+}  // namespace
+
 SE2Environment::SE2Environment(std::shared_ptr<ContinuousEnvironment> base)
   : base_(std::move(base)) {}
 
-bool SE2Environment::is_valid(const State& s) const {
-  if (!base_->is_valid(s))
+SE2Environment::SE2Environment(std::shared_ptr<ContinuousEnvironment> base,
+                               const Polygon& footprint, int num_headings)
+  : base_(std::move(base)) {
+  base_->get_bounds(x_min_, x_max_, y_min_, y_max_);
+
+  ConvexShape fp = ConvexShape::from_polygon(footprint.convex_hull());
+  for (const auto& v : fp.vertices)
+    radius_ = std::max(radius_, std::hypot(v.x, v.y));
+  sweep_res_ = 0.5 * fp.min_width();
+  if (sweep_res_ < 1e-6) sweep_res_ = 1e-3;
+
+  // A pose is tested at the nearest heading, up to pi/N away; no footprint
+  // point moves further than the chord 2r sin(pi/2N) over that angle, so
+  // footprints inflated by it contain the exact one and checks stay
+  // conservative.
+  num_headings = std::max(num_headings, 1);
+  heading_margin_ = 2 * radius_ * std::sin(M_PI / (2 * num_headings));
+  const ConvexShape padded = fp.inflated(heading_margin_);
+  headings_.reserve(num_headings);
+  for (int k = 0; k < num_headings; ++k)
+    headings_.push_back(padded.rotated(2 * M_PI * k / num_headings));
+
+  for (const auto& poly : base_->obstacles()) {
+    if (poly.is_convex()) {
+      pieces_.push_back(ConvexShape::from_polygon(poly));
+    } else {
+      for (const auto& tri : poly.triangulate())
+        pieces_.push_back(ConvexShape::from_polygon(tri));
+    }
+  }
+
+  // Cells about one footprint across keep per-query candidate lists short.
+  double extent = std::max(x_max_ - x_min_, y_max_ - y_min_);
+  cell_ = std::max({2 * radius_, extent / 128.0, 1e-6});
+  cols_ = static_cast<int>(std::ceil((x_max_ - x_min_) / cell_)) + 1;
+  rows_ = static_cast<int>(std::ceil((y_max_ - y_min_) / cell_)) + 1;
+
+  auto cell_range = [this](const ConvexShape& p, int& c0, int& c1, int& r0, int& r1) {
+    c0 = std::clamp(static_cast<int>((p.x_min - x_min_) / cell_), 0, cols_ - 1);
+    c1 = std::clamp(static_cast<int>((p.x_max - x_min_) / cell_), 0, cols_ - 1);
+    r0 = std::clamp(static_cast<int>((p.y_min - y_min_) / cell_), 0, rows_ - 1);
+    r1 = std::clamp(static_cast<int>((p.y_max - y_min_) / cell_), 0, rows_ - 1);
+  };
+  cell_start_.assign(static_cast<size_t>(cols_) * rows_ + 1, 0);
+  for (const auto& p : pieces_) {
+    int c0, c1, r0, r1;
+    cell_range(p, c0, c1, r0, r1);
+    for (int r = r0; r <= r1; ++r)
+      for (int c = c0; c <= c1; ++c)
+        cell_start_[static_cast<size_t>(r) * cols_ + c + 1]++;
+  }
+  for (size_t i = 1; i < cell_start_.size(); ++i)
+    cell_start_[i] += cell_start_[i - 1];
+  cell_items_.resize(cell_start_.back());
+  std::vector<size_t> fill(cell_start_.begin(), cell_start_.end() - 1);
+  for (size_t id = 0; id < pieces_.size(); ++id) {
+    int c0, c1, r0, r1;
+    cell_range(pieces_[id], c0, c1, r0, r1);
+    for (int r = r0; r <= r1; ++r)
+      for (int c = c0; c <= c1; ++c)
+        cell_items_[fill[static_cast<size_t>(r) * cols_ + c]++] = id;
+  }
+}
+
+bool SE2Environment::pose_free(double x, double y, double theta) const {
+  const int n = num_headings();
+  int k = static_cast<int>(std::lround(theta * n / (2 * M_PI))) % n;
+  if (k < 0) k += n;
+  const ConvexShape& fp = headings_[k];
+
+  double bx0 = x + fp.x_min, bx1 = x + fp.x_max;
+  double by0 = y + fp.y_min, by1 = y + fp.y_max;
+  if (bx0 < x_min_ || bx1 > x_max_ || by0 < y_min_ || by1 > y_max_)
     return false;
+
+  auto col = [this](double v) {
+    return std::clamp(static_cast<int>((v - x_min_) / cell_), 0, cols_ - 1);
+  };
+  auto row = [this](double v) {
+    return std::clamp(static_cast<int>((v - y_min_) / cell_), 0, rows_ - 1);
+  };
+  const int c0 = col(bx0), c1 = col(bx1), r0 = row(by0), r1 = row(by1);
+  for (int r = r0; r <= r1; ++r) {
+    for (int c = c0; c <= c1; ++c) {
+      size_t cell = static_cast<size_t>(r) * cols_ + c;
+      for (size_t i = cell_start_[cell]; i < cell_start_[cell + 1]; ++i) {
+        const ConvexShape& p = pieces_[cell_items_[i]];
+        // A piece spanning several cells is tested only in the first shared one.
+        if (c != std::max(c0, col(p.x_min)) || r != std::max(r0, row(p.y_min)))
+          continue;
+        if (convex_overlap(fp, x, y, p))
+          return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool SE2Environment::is_valid(const State& s) const {
   if (s.theta && (*s.theta < 0 || *s.theta >= 2 * M_PI))
     return false;
-  return true;
+  if (has_footprint())
+    return pose_free(s.x, s.y, s.theta.value_or(0.0));
+  return base_->is_valid(s);
 }
 
 bool SE2Environment::collision_free(const State& a, const State& b) const {
-  return base_->collision_free(a, b);
+  if (!has_footprint())
+    return base_->collision_free(a, b);
+  const double ta = a.theta.value_or(0.0);
+  const double dth = wrap_pi(b.theta.value_or(0.0) - ta);
+  const double dx = b.x - a.x, dy = b.y - a.y;
+  const double sweep = std::max(std::hypot(dx, dy), std::abs(dth) * radius_);
+  const int steps = std::max(1, static_cast<int>(std::ceil(sweep / sweep_res_)));
+  for (int i = 0; i <= steps; ++i) {
+    double t = static_cast<double>(i) / steps;
+    if (!pose_free(a.x + t * dx, a.y + t * dy, ta + t * dth))
+      return false;
+  }
+  return true;
 }
 
 double SE2Environment::clearance(const State& s) const {
@@ -0,0 +1,115 @@
+#include "geometry/convex_sat.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace pbs {
+
+namespace {
+
+void project(const std::vector<Point2D>& verts, const Point2D& axis,
+             double& lo, double& hi) {
+  lo = std::numeric_limits<double>::max();
+  hi = std::numeric_limits<double>::lowest();
+  for (const auto& v : verts) {
+    double p = v.x * axis.x + v.y * axis.y;
+    lo = std::min(lo, p);
+    hi = std::max(hi, p);
+  }
+}
+
+bool separated_on(const std::vector<Point2D>& axes, const ConvexShape& a,
+                  double dx, double dy, const ConvexShape& b) {
+  for (const auto& ax : axes) {
+    double a_lo, a_hi, b_lo, b_hi;
+    project(a.vertices, ax, a_lo, a_hi);
+    double off = dx * ax.x + dy * ax.y;
+    project(b.vertices, ax, b_lo, b_hi);
+    if (a_hi + off < b_lo - 1e-12 || b_hi < a_lo + off - 1e-12)
+      return true;
+  }
+  return false;
+}
+
+void compute_axes_and_box(ConvexShape& s) {
+  s.axes.clear();
+  size_t n = s.vertices.size();
+  for (size_t i = 0; i < n; ++i) {
+    const auto& a = s.vertices[i];
+    const auto& b = s.vertices[(i + 1) % n];
+    double ex = b.x - a.x, ey = b.y - a.y;
+    double len = std::hypot(ex, ey);
+    if (len < 1e-12) continue;
+    s.axes.emplace_back(-ey / len, ex / len);
+  }
+  Polygon(s.vertices).get_bounding_box(s.x_min, s.y_min, s.x_max, s.y_max);
+}
+
+}  // namespace
+
+ConvexShape ConvexShape::from_polygon(const Polygon& poly) {
+  ConvexShape s;
+  s.vertices = poly.vertices();
+  compute_axes_and_box(s);
+  return s;
+}
+
+ConvexShape ConvexShape::rotated(double theta) const {
+  ConvexShape s;
+  double c = std::cos(theta), sn = std::sin(theta);
+  s.vertices.reserve(vertices.size());
+  for (const auto& v : vertices)
+    s.vertices.emplace_back(c * v.x - sn * v.y, sn * v.x + c * v.y);
+  compute_axes_and_box(s);
+  return s;
+}
+
+ConvexShape ConvexShape::inflated(double delta) const {
+  const size_t n = vertices.size();
+  if (n < 3 || delta <= 0) return *this;
+  double area2 = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const auto& a = vertices[i];
+    const auto& b = vertices[(i + 1) % n];
+    area2 += a.x * b.y - b.x * a.y;
+  }
+  const double out = area2 >= 0 ? 1.0 : -1.0;  // CCW: right-hand normal points out
+  auto normal = [&](size_t i) {
+    const auto& a = vertices[i];
+    const auto& b = vertices[(i + 1) % n];
+    const double ex = b.x - a.x, ey = b.y - a.y, len = std::hypot(ex, ey);
+    return len < 1e-12 ? Point2D(0, 0) : Point2D(out * ey / len, -out * ex / len);
+  };
+  ConvexShape s;
+  s.vertices.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    const Point2D n1 = normal((i + n - 1) % n), n2 = normal(i);
+    const double c = 1 + n1.x * n2.x + n1.y * n2.y;
+    // Mitre point: the intersection of both offset edges.
+    const Point2D m = c > 1e-9 ? Point2D((n1.x + n2.x) / c, (n1.y + n2.y) / c) : n2;
+    s.vertices.emplace_back(vertices[i].x + delta * m.x, vertices[i].y + delta * m.y);
+  }
+  compute_axes_and_box(s);
+  return s;
+}
+
+double ConvexShape::min_width() const {
+  double w = std::numeric_limits<double>::max();
+  for (const auto& ax : axes) {
+    double lo, hi;
+    project(vertices, ax, lo, hi);
+    w = std::min(w, hi - lo);
+  }
+  return axes.empty() ? 0.0 : w;
+}
+
+bool convex_overlap(const ConvexShape& a, double dx, double dy,
+                    const ConvexShape& b) {
+  if (a.x_max + dx < b.x_min || b.x_max < a.x_min + dx ||
+      a.y_max + dy < b.y_min || b.y_max < a.y_min + dy)
+    return false;
+  return !separated_on(a.axes, a, dx, dy, b) &&
+         !separated_on(b.axes, a, dx, dy, b);
+}
+
+}  // namespace pbs
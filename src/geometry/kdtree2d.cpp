@@ -61,12 +61,22 @@ std::vector<size_t> KdTree2D::k_nearest(const Point2D& p, size_t k) const {
 
 std::vector<size_t> KdTree2D::radius_search(const Point2D& p, double r) const {
   std::vector<size_t> result;
-  double r2 = r * r;
-  for (size_t i = 0; i < points_.size(); ++i) {
-    if (dist_sq(p, points_[i]) <= r2)
-      result.push_back(i);
-  }
+  radius_rec(0, points_.size(), 0, p, r * r, result);
   return result;
 }
 
+// Subranges mirror build_rec: [l, mid) holds values <= the split at mid and
+// (mid, r) values >= it, so a side is skipped when the split plane is
+// farther than r from p.
+void KdTree2D::radius_rec(size_t l, size_t r, int axis, const Point2D& p, double r2,
+                          std::vector<size_t>& out) const {
+  if (l >= r) return;
+  size_t mid = l + (r - l) / 2;
+  const Point2D& q = points_[indices_[mid]];
+  if (dist_sq(p, q) <= r2) out.push_back(indices_[mid]);
+  double diff = (axis == 0) ? p.x - q.x : p.y - q.y;
+  if (diff <= 0 || diff * diff <= r2) radius_rec(l, mid, 1 - axis, p, r2, out);
+  if (diff >= 0 || diff * diff <= r2) radius_rec(mid + 1, r, 1 - axis, p, r2, out);
+}
+
 }  // namespace pbs
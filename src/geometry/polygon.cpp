@@ -34,4 +34,134 @@ void Polygon::get_bounding_box(double& x_min, double& y_min,
   }
 }
 
+namespace {
+
+double cross(const Point2D& o, const Point2D& a, const Point2D& b) {
+  return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+// p lies in the bounding box of segment ab (used once p is known collinear).
+bool in_box(const Point2D& a, const Point2D& b, const Point2D& p) {
+  return std::min(a.x, b.x) <= p.x && p.x <= std::max(a.x, b.x) &&
+         std::min(a.y, b.y) <= p.y && p.y <= std::max(a.y, b.y);
+}
+
+// Segments ab and cd cross or touch.
+bool segments_meet(const Point2D& a, const Point2D& b, const Point2D& c, const Point2D& d) {
+  const double d1 = cross(c, d, a), d2 = cross(c, d, b);
+  const double d3 = cross(a, b, c), d4 = cross(a, b, d);
+  if (((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) &&
+      ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0)))
+    return true;
+  return (d1 == 0 && in_box(c, d, a)) || (d2 == 0 && in_box(c, d, b)) ||
+         (d3 == 0 && in_box(a, b, c)) || (d4 == 0 && in_box(a, b, d));
+}
+
+// No two non-adjacent edges meet.
+bool is_simple(const std::vector<Point2D>& v) {
+  const size_t n = v.size();
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = i + 2; j < n; ++j) {
+      if (i == 0 && j == n - 1) continue;  // Adjacent through the closing edge
+      if (segments_meet(v[i], v[(i + 1) % n], v[j], v[(j + 1) % n])) return false;
+    }
+  return true;
+}
+
+}  // namespace
+
+bool Polygon::is_convex() const {
+  size_t n = vertices_.size();
+  if (n < 3) return false;
+  int sign = 0;
+  for (size_t i = 0; i < n; ++i) {
+    double c = cross(vertices_[i], vertices_[(i + 1) % n], vertices_[(i + 2) % n]);
+    if (std::abs(c) < 1e-12) continue;
+    int s = c > 0 ? 1 : -1;
+    if (sign != 0 && s != sign) return false;
+    sign = s;
+  }
+  return sign != 0;
+}
+
+Polygon Polygon::convex_hull() const {
+  std::vector<Point2D> pts = vertices_;
+  if (pts.size() < 3) return Polygon(pts);
+  std::sort(pts.begin(), pts.end(), [](const Point2D& a, const Point2D& b) {
+    return a.x < b.x || (a.x == b.x && a.y < b.y);
+  });
+  std::vector<Point2D> hull(2 * pts.size());
+  size_t k = 0;
+  for (size_t i = 0; i < pts.size(); ++i) {
+    while (k >= 2 && cross(hull[k - 2], hull[k - 1], pts[i]) <= 0) --k;
+    hull[k++] = pts[i];
+  }
+  for (size_t i = pts.size() - 1, t = k + 1; i > 0; --i) {
+    while (k >= t && cross(hull[k - 2], hull[k - 1], pts[i - 1]) <= 0) --k;
+    hull[k++] = pts[i - 1];
+  }
+  hull.resize(k - 1);
+  return Polygon(std::move(hull));
+}
+
+std::vector<Polygon> Polygon::triangulate() const {
+  std::vector<Polygon> tris;
+  size_t n = vertices_.size();
+  if (n < 3) return tris;
+  // Ear clipping assumes a simple polygon. Every region a self-intersecting
+  // one encloses lies in its hull, so callers that need the pieces to cover
+  // the polygon (SE2 obstacle SAT) stay conservative.
+  if (!is_simple(vertices_)) {
+    tris.push_back(convex_hull());
+    return tris;
+  }
+  double area2 = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const auto& a = vertices_[i];
+    const auto& b = vertices_[(i + 1) % n];
+    area2 += a.x * b.y - b.x * a.y;
+  }
+  std::vector<size_t> idx(n);
+  for (size_t i = 0; i < n; ++i) idx[i] = area2 >= 0 ? i : n - 1 - i;  // CCW order
+
+  auto inside_tri = [](const Point2D& p, const Point2D& a, const Point2D& b,
+                       const Point2D& c) {
+    return cross(a, b, p) >= 0 && cross(b, c, p) >= 0 && cross(c, a, p) >= 0;
+  };
+  size_t guard = 0;
+  while (idx.size() > 3 && guard++ < n * n) {
+    bool clipped = false;
+    for (size_t i = 0; i < idx.size(); ++i) {
+      size_t ip = idx[(i + idx.size() - 1) % idx.size()];
+      size_t ic = idx[i];
+      size_t in = idx[(i + 1) % idx.size()];
+      const auto& a = vertices_[ip];
+      const auto& b = vertices_[ic];
+      const auto& c = vertices_[in];
+      if (cross(a, b, c) <= 1e-12) continue;  // Reflex or degenerate
+      bool ear = true;
+      for (size_t j : idx) {
+        if (j == ip || j == ic || j == in) continue;
+        if (inside_tri(vertices_[j], a, b, c)) { ear = false; break; }
+      }
+      if (!ear) continue;
+      tris.emplace_back(std::vector<Point2D>{a, b, c});
+      idx.erase(idx.begin() + static_cast<std::ptrdiff_t>(i));
+      clipped = true;
+      break;
+    }
+    if (!clipped) break;  // Degenerate input (e.g. collinear runs)
+  }
+  if (idx.size() == 3) {
+    tris.emplace_back(std::vector<Point2D>{
+        vertices_[idx[0]], vertices_[idx[1]], vertices_[idx[2]]});
+  } else if (idx.size() > 3) {
+    // Clipping stalled: cover what is left by its hull rather than drop it.
+    std::vector<Point2D> rest;
+    for (size_t i : idx) rest.push_back(vertices_[i]);
+    tris.push_back(Polygon(std::move(rest)).convex_hull());
+  }
+  return tris;
+}
+
 }  // namespace pbs
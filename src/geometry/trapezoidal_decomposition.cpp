@@ -0,0 +1,108 @@
+#include "geometry/trapezoidal_decomposition.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace pbs {
+
+namespace {
+
+constexpr double kEps = 1e-12;
+
+// Non-vertical segment with x0 < x1 of obstacle `poly` (-1: bounds).
+struct Edge {
+  double x0, y0, x1, y1;
+  int poly;
+  double y_at(double x) const { return y0 + (y1 - y0) * (x - x0) / (x1 - x0); }
+};
+
+// x of the proper crossing of a and b, if there is one.
+bool crossing_x(const Edge& a, const Edge& b, double& x) {
+  const double lo = std::max(a.x0, b.x0), hi = std::min(a.x1, b.x1);
+  if (hi - lo <= kEps) return false;
+  const double d_lo = a.y_at(lo) - b.y_at(lo), d_hi = a.y_at(hi) - b.y_at(hi);
+  if ((d_lo > 0) == (d_hi > 0) || d_lo == 0 || d_hi == 0) return false;
+  x = lo + (hi - lo) * d_lo / (d_lo - d_hi);
+  return true;
+}
+
+}  // namespace
+
+void Trapezoid::map(double u, double v, double& x, double& y) const {
+  // Height is linear in s = (x - x0) / (x1 - x0), so the area CDF is the
+  // quadratic h0 s + (h1 - h0) s^2 / 2 = u (h0 + h1) / 2, solved in the
+  // cancellation-free form.
+  const double h0 = top0 - bottom0, h1 = top1 - bottom1;
+  const double den = h0 + std::sqrt(std::max(0.0, h0 * h0 + u * (h1 * h1 - h0 * h0)));
+  const double s = den > 0 ? std::clamp(u * (h0 + h1) / den, 0.0, 1.0) : u;
+  x = x0 + s * (x1 - x0);
+  const double bottom = bottom0 + s * (bottom1 - bottom0);
+  y = bottom + v * (h0 + s * (h1 - h0));
+}
+
+std::vector<Trapezoid> trapezoidal_decomposition(double x_min, double x_max, double y_min,
+                                                 double y_max,
+                                                 const std::vector<Polygon>& obstacles) {
+  std::vector<Trapezoid> out;
+  if (x_max - x_min <= kEps || y_max - y_min <= kEps) return out;
+
+  // The bounds' bottom and top are edges like any other.
+  std::vector<Edge> edges{{x_min, y_min, x_max, y_min, -1}, {x_min, y_max, x_max, y_max, -1}};
+  std::vector<double> cuts{x_min, x_max};
+  for (size_t p = 0; p < obstacles.size(); ++p) {
+    const auto& v = obstacles[p].vertices();
+    const int id = static_cast<int>(p);
+    for (size_t i = 0; i < v.size(); ++i) {
+      const Point2D& a = v[i];
+      const Point2D& b = v[(i + 1) % v.size()];
+      cuts.push_back(a.x);
+      if (std::abs(a.x - b.x) <= kEps) continue;
+      edges.push_back(a.x < b.x ? Edge{a.x, a.y, b.x, b.y, id} : Edge{b.x, b.y, a.x, a.y, id});
+    }
+  }
+  for (size_t i = 0; i < edges.size(); ++i)
+    for (size_t j = i + 1; j < edges.size(); ++j) {
+      double x = 0;
+      if (crossing_x(edges[i], edges[j], x)) cuts.push_back(x);
+    }
+  std::sort(cuts.begin(), cuts.end());
+
+  // Walking a slab upwards, crossing an edge toggles whether we are inside
+  // its polygon (even-odd, like Polygon::contains) or inside the bounds.
+  struct Cut { double ya, yb, ym; int poly; };
+  std::vector<Cut> column;
+  std::vector<char> inside(obstacles.size(), 0);
+  double a = x_min;
+  for (double b : cuts) {
+    b = std::min(b, x_max);
+    if (b - a <= kEps) continue;
+    const double m = 0.5 * (a + b);
+    column.clear();
+    for (const auto& e : edges)
+      if (e.x0 <= a + kEps && e.x1 >= b - kEps)
+        column.push_back({e.y_at(a), e.y_at(b), e.y_at(m), e.poly});
+    std::sort(column.begin(), column.end(),
+              [](const Cut& p, const Cut& q) { return p.ym < q.ym; });
+    int depth = 0;  // polygons containing the current gap
+    bool in_bounds = false;
+    for (size_t k = 0; k < column.size(); ++k) {
+      const Cut& lo = column[k];
+      if (lo.poly < 0) {
+        in_bounds = !in_bounds;
+      } else {
+        char& in = inside[static_cast<size_t>(lo.poly)];
+        depth += in ? -1 : 1;
+        in ^= 1;
+      }
+      if (k + 1 == column.size()) break;
+      const Cut& hi = column[k + 1];
+      if (in_bounds && depth == 0 && hi.ym - lo.ym > kEps)
+        out.push_back({a, b, lo.ya, lo.yb, hi.ya, hi.yb});
+    }
+    for (const Cut& c : column)
+      if (c.poly >= 0) inside[static_cast<size_t>(c.poly)] = 0;
+    a = b;
+  }
+  return out;
+}
+
+}  // namespace pbs
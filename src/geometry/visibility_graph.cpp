@@ -0,0 +1,231 @@
+#include "geometry/visibility_graph.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <set>
+
+namespace pbs {
+
+namespace {
+
+constexpr double kEps = 1e-9;
+
+double cross(double ax, double ay, double bx, double by) { return ax * by - ay * bx; }
+
+// Counter-clockwise angle from (ux, uy) to (vx, vy) in [0, 2pi).
+double ccw_angle(double ux, double uy, double vx, double vy) {
+  double a = std::atan2(cross(ux, uy, vx, vy), ux * vx + uy * vy);
+  return a < 0 ? a + 2 * M_PI : a;
+}
+
+// Sweep state: the ray from p through the current event point. Polygon edge
+// e runs from vertex e to vertex next[e].
+struct Ray {
+  const std::vector<Point2D>* pts;
+  const std::vector<size_t>* next;
+  Point2D p;
+  double dx = 1, dy = 0;  // Unit direction
+
+  // Distance from p to edge e along the ray.
+  double dist(size_t e) const {
+    const Point2D& a = (*pts)[e];
+    const Point2D& b = (*pts)[(*next)[e]];
+    double ex = b.x - a.x, ey = b.y - a.y;
+    double denom = cross(dx, dy, ex, ey);
+    if (denom * denom < 1e-24 * (ex * ex + ey * ey))
+      return std::min(std::hypot(a.x - p.x, a.y - p.y), std::hypot(b.x - p.x, b.y - p.y));
+    return cross(a.x - p.x, a.y - p.y, ex, ey) / denom;
+  }
+};
+
+// Orders the edges cut by the ray by distance from p. Edges meeting at a
+// common vertex on the ray are ordered by which one bends towards p.
+struct EdgeLess {
+  const Ray* ray;
+  bool operator()(size_t e1, size_t e2) const {
+    if (e1 == e2) return false;
+    double d1 = ray->dist(e1), d2 = ray->dist(e2);
+    if (std::abs(d1 - d2) > kEps * std::max(1.0, d1)) return d1 < d2;
+    const auto& next = *ray->next;
+    const auto& pts = *ray->pts;
+    size_t q = SIZE_MAX, o1 = 0, o2 = 0;
+    if (next[e1] == e2) { q = e2; o1 = e1; o2 = next[e2]; }
+    else if (next[e2] == e1) { q = e1; o1 = next[e1]; o2 = e2; }
+    if (q == SIZE_MAX) return e1 < e2;
+    const Point2D& c = pts[q];
+    double px = ray->p.x - c.x, py = ray->p.y - c.y;
+    auto angle = [&](size_t o) {
+      double ox = pts[o].x - c.x, oy = pts[o].y - c.y;
+      return std::atan2(std::abs(cross(px, py, ox, oy)), px * ox + py * oy);
+    };
+    double a1 = angle(o1), a2 = angle(o2);
+    if (a1 != a2) return a1 < a2;
+    return e1 < e2;
+  }
+};
+
+}  // namespace
+
+VisibilityGraph::VisibilityGraph(const std::vector<Polygon>& obstacles)
+  : VisibilityGraph(obstacles, -1e300, 1e300, -1e300, 1e300) {}
+
+VisibilityGraph::VisibilityGraph(const std::vector<Polygon>& obstacles, double x_min,
+                                 double x_max, double y_min, double y_max) {
+  for (const auto& poly : obstacles) {
+    const auto& v = poly.vertices();
+    if (v.size() < 3) continue;
+    double area2 = 0;
+    for (size_t i = 0, j = v.size() - 1; i < v.size(); j = i++)
+      area2 += cross(v[j].x, v[j].y, v[i].x, v[i].y);
+    const size_t base = pts_.size();
+    const size_t n = v.size();
+    for (size_t i = 0; i < n; ++i) {
+      pts_.push_back(v[i]);
+      prev_.push_back(base + (i + n - 1) % n);
+      next_.push_back(base + (i + 1) % n);
+      ccw_.push_back(area2 > 0);
+    }
+  }
+
+  // Shortest paths only bend at convex vertices.
+  node_of_.assign(pts_.size(), SIZE_MAX);
+  for (size_t i = 0; i < pts_.size(); ++i) {
+    const Point2D& a = pts_[prev_[i]];
+    const Point2D& w = pts_[i];
+    const Point2D& b = pts_[next_[i]];
+    double turn = cross(w.x - a.x, w.y - a.y, b.x - w.x, b.y - w.y);
+    bool inside = w.x > x_min + kEps && w.x < x_max - kEps &&
+                  w.y > y_min + kEps && w.y < y_max - kEps;
+    if (inside && (ccw_[i] ? turn > 0 : turn < 0)) {
+      node_of_[i] = node_.size();
+      node_.push_back(i);
+    }
+  }
+
+  adj_.resize(node_.size());
+  for (size_t u = 0; u < node_.size(); ++u) {
+    const Point2D& pu = pts_[node_[u]];
+    for (size_t v : sweep(pu, node_[u], {}).vertices) {
+      if (v <= u) continue;  // Each pair is added from its lower endpoint.
+      const Point2D& pv = pts_[node_[v]];
+      double d = std::hypot(pv.x - pu.x, pv.y - pu.y);
+      adj_[u].push_back({v, d});
+      adj_[v].push_back({u, d});
+      ++num_edges_;
+    }
+  }
+}
+
+VisibilityGraph::Visible VisibilityGraph::visible_from(
+    const Point2D& p, const std::vector<Point2D>& extra) const {
+  return sweep(p, SIZE_MAX, extra);
+}
+
+bool VisibilityGraph::into_interior(size_t v, double dx, double dy) const {
+  const Point2D& w = pts_[v];
+  // Interior lies counter-clockwise from the outgoing edge to the incoming one.
+  const Point2D& b = pts_[ccw_[v] ? next_[v] : prev_[v]];
+  const Point2D& a = pts_[ccw_[v] ? prev_[v] : next_[v]];
+  double span = ccw_angle(b.x - w.x, b.y - w.y, a.x - w.x, a.y - w.y);
+  double ang = ccw_angle(b.x - w.x, b.y - w.y, dx, dy);
+  return ang > kEps && ang < span - kEps;
+}
+
+VisibilityGraph::Visible VisibilityGraph::sweep(
+    const Point2D& p, size_t self, const std::vector<Point2D>& extra) const {
+  struct Event {
+    double angle, dist;
+    size_t id;  // < pts_.size(): vertex; otherwise extra point id - pts_.size()
+  };
+  std::vector<Event> events;
+  events.reserve(pts_.size() + extra.size());
+  auto add_event = [&](const Point2D& q, size_t id) {
+    double d = std::hypot(q.x - p.x, q.y - p.y);
+    if (d < kEps) return;
+    double a = std::atan2(q.y - p.y, q.x - p.x);
+    events.push_back({a < 0 ? a + 2 * M_PI : a, d, id});
+  };
+  for (size_t i = 0; i < pts_.size(); ++i)
+    if (i != self) add_event(pts_[i], i);
+  for (size_t k = 0; k < extra.size(); ++k) add_event(extra[k], pts_.size() + k);
+  std::sort(events.begin(), events.end(), [](const Event& a, const Event& b) {
+    return a.angle != b.angle ? a.angle < b.angle : a.dist < b.dist;
+  });
+
+  auto incident_to_self = [&](size_t e) {
+    return self != SIZE_MAX && (e == self || next_[e] == self);
+  };
+
+  Ray ray{&pts_, &next_, p};
+  std::set<size_t, EdgeLess> active(EdgeLess{&ray});
+  // Edges properly crossing the initial ray (direction +x).
+  for (size_t e = 0; e < pts_.size(); ++e) {
+    if (incident_to_self(e)) continue;
+    const Point2D& a = pts_[e];
+    const Point2D& b = pts_[next_[e]];
+    if ((a.y - p.y) * (b.y - p.y) >= 0) continue;
+    double x = a.x + (p.y - a.y) * (b.x - a.x) / (b.y - a.y);
+    if (x > p.x) active.insert(e);
+  }
+
+  Visible out;
+  bool prev_visible = false;
+  const Point2D* prev_pt = nullptr;
+  for (const Event& ev : events) {
+    const bool is_vertex = ev.id < pts_.size();
+    const Point2D& w = is_vertex ? pts_[ev.id] : extra[ev.id - pts_.size()];
+    ray.dx = (w.x - p.x) / ev.dist;
+    ray.dy = (w.y - p.y) / ev.dist;
+
+    // A vertex strictly between p and w on the same ray hides w if it is
+    // itself hidden; otherwise only edges cut strictly before w can block.
+    bool collinear_prev = prev_pt &&
+        std::abs(cross(prev_pt->x - p.x, prev_pt->y - p.y, ray.dx, ray.dy)) <
+            kEps * std::max(1.0, ev.dist) &&
+        (prev_pt->x - p.x) * ray.dx + (prev_pt->y - p.y) * ray.dy > 0;
+
+    bool visible = true;
+    if (is_vertex && into_interior(ev.id, p.x - w.x, p.y - w.y)) {
+      visible = false;
+    } else if (collinear_prev && !prev_visible) {
+      visible = false;
+    } else {
+      for (size_t e : active) {
+        if (ray.dist(e) >= ev.dist - kEps * std::max(1.0, ev.dist)) break;
+        // Edges that only touch the ray at an endpoint do not block.
+        auto on_ray = [&](const Point2D& q) {
+          return std::abs(cross(q.x - p.x, q.y - p.y, ray.dx, ray.dy)) <
+                 kEps * std::max(1.0, ev.dist);
+        };
+        if (on_ray(pts_[e]) || on_ray(pts_[next_[e]])) continue;
+        visible = false;
+        break;
+      }
+    }
+
+    if (visible) {
+      if (!is_vertex) out.extra.push_back(ev.id - pts_.size());
+      else if (node_of_[ev.id] != SIZE_MAX) out.vertices.push_back(node_of_[ev.id]);
+    }
+
+    if (is_vertex) {
+      // Edges at w ending clockwise of the ray leave the set, the ones
+      // continuing counter-clockwise enter it.
+      const size_t incident[2] = {prev_[ev.id], ev.id};
+      for (int pass = 0; pass < 2; ++pass) {
+        for (size_t e : incident) {
+          if (incident_to_self(e)) continue;
+          const Point2D& o = pts_[e == ev.id ? next_[e] : e];
+          double side = cross(w.x - p.x, w.y - p.y, o.x - p.x, o.y - p.y);
+          if (pass == 0 && side < 0) active.erase(e);
+          if (pass == 1 && side > 0) active.insert(e);
+        }
+      }
+    }
+    prev_pt = &w;
+    prev_visible = visible;
+  }
+  return out;
+}
+
+}  // namespace pbs
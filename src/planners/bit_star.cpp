@@ -0,0 +1,231 @@
+#include "planners/bit_star.hpp"
+#include "planners/informed_set.hpp"
+#include "environment/ienvironment.hpp"
+#include "geometry/kdtree2d.hpp"
+#include "geometry/point2d.hpp"
+#include <cmath>
+#include <queue>
+#include <tuple>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+namespace pbs {
+
+namespace {
+
+constexpr double kInf = 1e99;
+
+// RGG connection radius for q points in a 2D set of measure `area`
+// (Karaman & Frazzoli, as used by BIT*).
+double rgg_radius(size_t q, double area, double eta) {
+  if (q <= 1) return 1e9;
+  const double n = static_cast<double>(q);
+  return eta * 2.0 * std::sqrt(1.5 * area / M_PI) * std::sqrt(std::log(n) / n);
+}
+
+}  // namespace
+
+BITStarPlanner::BITStarPlanner(int batch_size, int max_batches, double rewire_factor)
+  : batch_size_(batch_size), max_batches_(max_batches), rewire_factor_(rewire_factor) {}
+
+Path BITStarPlanner::solve(const IEnvironment& env, const State& start,
+                           const State& goal) {
+  nodes_expanded_ = 0;
+  edges_checked_ = 0;
+  conv_data_ = ConvergenceData{};
+
+  double x_min = 0, x_max = 0, y_min = 0, y_max = 0;
+  if (!env.get_bounds(x_min, x_max, y_min, y_max) || !env.is_valid(start) ||
+      !env.is_valid(goal)) {
+    Path p; p.success = false; return p;
+  }
+
+  // Point pool: index 0 is the start (root), 1 the goal. Samples join the
+  // tree in place; pruned points stay in the pool but are marked dead, and
+  // pruned tree vertices leave the tree with their subtrees.
+  std::vector<Point2D> pts{Point2D(start.x, start.y), Point2D(goal.x, goal.y)};
+  std::vector<double> g{0.0, kInf};
+  std::vector<size_t> parent{SIZE_MAX, SIZE_MAX};
+  std::vector<std::vector<size_t>> children(2);
+  std::vector<char> in_tree{1, 0}, dead{0, 0};
+  std::vector<int> expanded_batch{-1, -1};
+  const size_t kStart = 0, kGoal = 1;
+
+  auto c_hat = [&](size_t a, size_t b) {
+    return std::hypot(pts[a].x - pts[b].x, pts[a].y - pts[b].y);
+  };
+  auto g_hat = [&](size_t i) { return c_hat(kStart, i); };
+  auto h_hat = [&](size_t i) { return c_hat(i, kGoal); };
+
+  // Lowers g along the subtree of v after its cost changed.
+  auto propagate = [&](size_t v) {
+    std::vector<size_t> stack{v};
+    while (!stack.empty()) {
+      size_t u = stack.back(); stack.pop_back();
+      for (size_t c : children[u]) {
+        g[c] = g[u] + c_hat(u, c);
+        stack.push_back(c);
+      }
+    }
+  };
+
+  double c_best = kInf;
+
+  // Takes v and its subtree out of the tree. Detached vertices that could
+  // still lie on a better solution return to the samples, the rest die.
+  auto detach = [&](size_t v) {
+    auto& sib = children[parent[v]];
+    sib.erase(std::find(sib.begin(), sib.end(), v));
+    std::vector<size_t> stack{v};
+    while (!stack.empty()) {
+      size_t u = stack.back(); stack.pop_back();
+      for (size_t c : children[u]) stack.push_back(c);
+      children[u].clear();
+      in_tree[u] = 0;
+      parent[u] = SIZE_MAX;
+      g[u] = kInf;
+      expanded_batch[u] = -1;
+      if (g_hat(u) + h_hat(u) >= c_best) dead[u] = 1;
+    }
+  };
+
+  using VItem = std::pair<double, size_t>;
+  using EItem = std::tuple<double, double, size_t, size_t>;  // (f, g(v) + c, v, x)
+  std::priority_queue<VItem, std::vector<VItem>, std::greater<VItem>> qv;
+  std::priority_queue<EItem, std::vector<EItem>, std::greater<EItem>> qe;
+
+  auto sampler = new_sampler();
+  const double bounds_area = (x_max - x_min) * (y_max - y_min);
+  int total_samples = 0;
+
+  KdTree2D kd;
+  std::vector<size_t> kd_ids;  // kd index -> pool index
+  double radius = 0.0;
+
+  // Checked per edge, so a budget ends the search mid-batch.
+  Deadline deadline(time_budget_ms_);
+  for (int batch = 0; batch < max_batches_ && !deadline.expired(); ++batch) {
+    // Prune: samples whose best possible solution cannot beat c_best, and
+    // tree vertices whose cost-to-come already rules that out. Vertices on
+    // the current solution have g + h_hat <= c_best and always stay.
+    if (c_best < kInf) {
+      for (size_t i = 2; i < pts.size(); ++i) {
+        if (dead[i]) continue;
+        if (!in_tree[i]) {
+          if (g_hat(i) + h_hat(i) >= c_best) dead[i] = 1;
+        } else if (g[i] + h_hat(i) > c_best + 1e-9) {
+          detach(i);
+        }
+      }
+    }
+
+    // New batch from the informed set (the whole workspace until solved).
+    int k = 0;
+    for (int attempts = 0; k < batch_size_ && attempts < batch_size_ * 20; ++attempts) {
+      double u = 0, v = 0, x = 0, y = 0;
+      sampler->next(u, v);
+      if (c_best < kInf) {
+        sample_ellipse(start.x, start.y, goal.x, goal.y, c_best, u, v, x, y);
+        if (x < x_min || x > x_max || y < y_min || y > y_max) continue;
+      } else {
+        x = x_min + u * (x_max - x_min);
+        y = y_min + v * (y_max - y_min);
+      }
+      if (!env.is_valid(State(x, y))) continue;
+      pts.push_back(Point2D(x, y));
+      g.push_back(kInf);
+      parent.push_back(SIZE_MAX);
+      children.emplace_back();
+      in_tree.push_back(0);
+      dead.push_back(0);
+      expanded_batch.push_back(-1);
+      ++k;
+    }
+    total_samples += k;  // Accepted, not requested: rejection drops some
+
+    std::vector<Point2D> live;
+    kd_ids.clear();
+    for (size_t i = 0; i < pts.size(); ++i)
+      if (!dead[i]) { live.push_back(pts[i]); kd_ids.push_back(i); }
+    kd.build(live);
+    const double area = c_best < kInf
+        ? std::min(bounds_area, ellipse_area(start.x, start.y, goal.x, goal.y, c_best))
+        : bounds_area;
+    radius = rgg_radius(live.size(), area, rewire_factor_);
+
+    qe = {};
+    qv = {};
+    for (size_t i = 0; i < pts.size(); ++i)
+      if (in_tree[i] && !dead[i]) qv.push({g[i] + h_hat(i), i});
+
+    auto expand = [&](size_t v) {
+      expanded_batch[v] = batch;
+      ++nodes_expanded_;
+      for (size_t k : kd.radius_search(pts[v], radius)) {
+        size_t x = kd_ids[k];
+        if (x == v || x == kStart || parent[x] == v) continue;
+        double c = c_hat(v, x);
+        if (g[v] + c + h_hat(x) >= c_best) continue;
+        // Tree vertices only as rewiring targets the edge would improve.
+        if (in_tree[x] && g[v] + c >= g[x]) continue;
+        qe.push({g[v] + c + h_hat(x), g[v] + c, v, x});
+      }
+    };
+
+    while (!deadline.expired()) {
+      while (!qv.empty() && (qe.empty() || qv.top().first <= std::get<0>(qe.top()))) {
+        auto [key, v] = qv.top();
+        qv.pop();
+        if (expanded_batch[v] == batch || dead[v] || key > g[v] + h_hat(v) + 1e-12) continue;
+        expand(v);
+      }
+      if (qe.empty()) break;
+      auto [f, gc, v, x] = qe.top();
+      qe.pop();
+      const double c = c_hat(v, x);
+      // Queue exhausted of useful edges: the batch is done.
+      if (g[v] + c + h_hat(x) >= c_best) break;
+      if (g[v] + c >= g[x]) continue;
+      // Lazy evaluation: the only collision check BIT* pays per edge.
+      ++edges_checked_;
+      if (!env.collision_free(State(pts[v].x, pts[v].y), State(pts[x].x, pts[x].y)))
+        continue;
+      if (in_tree[x]) {
+        auto& sib = children[parent[x]];
+        sib.erase(std::find(sib.begin(), sib.end(), x));
+      } else {
+        in_tree[x] = 1;
+      }
+      parent[x] = v;
+      children[v].push_back(x);
+      g[x] = g[v] + c;
+      propagate(x);
+      if (expanded_batch[x] != batch) qv.push({g[x] + h_hat(x), x});
+      if (in_tree[kGoal] && g[kGoal] < c_best) {
+        c_best = g[kGoal];
+        conv_data_.cost_vs_time.push_back({deadline.elapsed_ms(), c_best});
+      }
+    }
+
+    if (c_best < kInf) conv_data_.cost_vs_iteration.push_back({total_samples, c_best});
+  }
+
+  Path path;
+  if (!in_tree[kGoal]) {
+    path.success = false;
+    return path;
+  }
+  conv_data_.final_cost = g[kGoal];
+  if (optimal_cost_ > 0) conv_data_.gap_to_optimal = g[kGoal] - optimal_cost_;
+
+  std::vector<size_t> trace;
+  for (size_t cur = kGoal; cur != SIZE_MAX; cur = parent[cur]) trace.push_back(cur);
+  std::reverse(trace.begin(), trace.end());
+  for (size_t i : trace) path.states.push_back(State(pts[i].x, pts[i].y));
+  path.success = true;
+  path.compute_length();
+  return path;
+}
+
+}  // namespace pbs
@@ -0,0 +1,244 @@
+#include "planners/concurrent_rrt_tree.hpp"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace pbs {
+
+namespace {
+
+void lock(std::atomic<uint8_t>& l) {
+  while (l.exchange(1, std::memory_order_acquire)) {
+    while (l.load(std::memory_order_relaxed)) std::this_thread::yield();
+  }
+}
+
+void unlock(std::atomic<uint8_t>& l) { l.store(0, std::memory_order_release); }
+
+}  // namespace
+
+ConcurrentRRTTree::ConcurrentRRTTree(size_t capacity, double x_min, double x_max,
+                                     double y_min, double y_max, double cell)
+  : capacity_(capacity), x_min_(x_min), y_min_(y_min), cell_(cell > 0 ? cell : 1.0),
+    num_blocks_((capacity + kBlockSize - 1) / kBlockSize) {
+  blocks_.reset(new std::atomic<Block*>[num_blocks_]);
+  for (size_t b = 0; b < num_blocks_; ++b) blocks_[b].store(nullptr, std::memory_order_relaxed);
+  const double w = std::max(x_max - x_min, 1e-9), h = std::max(y_max - y_min, 1e-9);
+  const double slots = static_cast<double>(std::min<size_t>(capacity, size_t{1} << 16));
+  const double max_cells = 4.0 * slots + 64.0;
+  if ((w / cell_) * (h / cell_) > max_cells) cell_ = std::sqrt(w * h / max_cells);
+  nx_ = std::max(1, static_cast<int>(std::ceil(w / cell_)));
+  ny_ = std::max(1, static_cast<int>(std::ceil(h / cell_)));
+  heads_ = std::vector<std::atomic<uint32_t>>(static_cast<size_t>(nx_) * ny_);
+  for (auto& hd : heads_) hd.store(kNone, std::memory_order_relaxed);
+}
+
+ConcurrentRRTTree::~ConcurrentRRTTree() {
+  for (size_t b = 0; b < num_blocks_; ++b) delete blocks_[b].load(std::memory_order_relaxed);
+}
+
+size_t ConcurrentRRTTree::blocks_allocated() const {
+  size_t n = 0;
+  for (size_t b = 0; b < num_blocks_; ++b)
+    if (blocks_[b].load(std::memory_order_acquire)) ++n;
+  return n;
+}
+
+ConcurrentRRTTree::Node& ConcurrentRRTTree::claim(size_t i) {
+  auto& slot = blocks_[i >> kBlockShift];
+  Block* b = slot.load(std::memory_order_acquire);
+  if (!b) {
+    // Whoever claims a slot in a missing block may allocate it; losers of
+    // the race free their copy and use the published one.
+    Block* fresh = new Block();
+    if (slot.compare_exchange_strong(b, fresh, std::memory_order_acq_rel,
+                                     std::memory_order_acquire))
+      b = fresh;
+    else
+      delete fresh;
+  }
+  return b->nodes[i & (kBlockSize - 1)];
+}
+
+size_t ConcurrentRRTTree::size() const {
+  return std::min<size_t>(next_.load(std::memory_order_acquire), capacity_);
+}
+
+void ConcurrentRRTTree::cell_coords(double x, double y, int& cx, int& cy) const {
+  cx = std::clamp(static_cast<int>(std::floor((x - x_min_) / cell_)), 0, nx_ - 1);
+  cy = std::clamp(static_cast<int>(std::floor((y - y_min_) / cell_)), 0, ny_ - 1);
+}
+
+uint32_t ConcurrentRRTTree::add(double x, double y, uint32_t parent, double cost) {
+  const uint32_t i = next_.fetch_add(1, std::memory_order_relaxed);
+  if (i >= capacity_) return kNone;
+  Node& n = claim(i);
+  n.x = x;
+  n.y = y;
+  n.parent.store(parent, std::memory_order_relaxed);
+  n.cost.store(cost, std::memory_order_relaxed);
+  if (parent != kNone) link_child(parent, i);
+
+  // Publish: the release CAS makes the coordinates visible to any reader
+  // that reaches i from the cell head.
+  int cx = 0, cy = 0;
+  cell_coords(x, y, cx, cy);
+  auto& head = heads_[static_cast<size_t>(cy) * nx_ + cx];
+  uint32_t h = head.load(std::memory_order_relaxed);
+  do {
+    n.next_in_cell = h;
+  } while (!head.compare_exchange_weak(h, i, std::memory_order_release,
+                                       std::memory_order_relaxed));
+  n.ready.store(1, std::memory_order_release);
+  return i;
+}
+
+uint32_t ConcurrentRRTTree::nearest(double x, double y) const {
+  const size_t n = size();
+  uint32_t best = kNone;
+  double best_d2 = 1e300;
+  auto consider = [&](uint32_t i, const Node& nd) {
+    double dx = nd.x - x, dy = nd.y - y;
+    double d2 = dx * dx + dy * dy;
+    if (d2 < best_d2) { best_d2 = d2; best = i; }
+  };
+  auto visit = [&](int cx, int cy) {
+    if (cx < 0 || cy < 0 || cx >= nx_ || cy >= ny_) return;
+    uint32_t i = heads_[static_cast<size_t>(cy) * nx_ + cx].load(std::memory_order_acquire);
+    while (i != kNone) {
+      const Node& nd = node(i);
+      consider(i, nd);
+      i = nd.next_in_cell;
+    }
+  };
+
+  int cx = 0, cy = 0;
+  cell_coords(x, y, cx, cy);
+  size_t scanned = 0;
+  const int max_ring = std::max(nx_, ny_);
+  for (int ring = 0; ring <= max_ring; ++ring) {
+    // Every point in ring r is at least (r - 1) cells from the query.
+    const double lb = (ring - 1) * cell_;
+    if (best != kNone && lb > 0 && lb * lb > best_d2) break;
+    // A sparse tree in a large grid: a plain scan is cheaper than more rings.
+    if (scanned > n) {
+      best = kNone;
+      best_d2 = 1e300;
+      for (size_t i = 0; i < n; ++i) {
+        const Node* nd = find(i);
+        if (nd && nd->ready.load(std::memory_order_acquire)) consider(static_cast<uint32_t>(i), *nd);
+      }
+      return best;
+    }
+    if (ring == 0) {
+      visit(cx, cy);
+      ++scanned;
+      continue;
+    }
+    for (int d = -ring; d <= ring; ++d) {
+      visit(cx + d, cy - ring);
+      visit(cx + d, cy + ring);
+    }
+    for (int d = -ring + 1; d <= ring - 1; ++d) {
+      visit(cx - ring, cy + d);
+      visit(cx + ring, cy + d);
+    }
+    scanned += 8 * static_cast<size_t>(ring);
+  }
+  return best;
+}
+
+void ConcurrentRRTTree::near(double x, double y, double r, std::vector<uint32_t>& out) const {
+  int cx0 = 0, cy0 = 0, cx1 = 0, cy1 = 0;
+  cell_coords(x - r, y - r, cx0, cy0);
+  cell_coords(x + r, y + r, cx1, cy1);
+  const double r2 = r * r;
+  for (int cy = cy0; cy <= cy1; ++cy)
+    for (int cx = cx0; cx <= cx1; ++cx) {
+      uint32_t i = heads_[static_cast<size_t>(cy) * nx_ + cx].load(std::memory_order_acquire);
+      while (i != kNone) {
+        const Node& nd = node(i);
+        double dx = nd.x - x, dy = nd.y - y;
+        if (dx * dx + dy * dy <= r2) out.push_back(i);
+        i = nd.next_in_cell;
+      }
+    }
+}
+
+void ConcurrentRRTTree::link_child(uint32_t parent, uint32_t child) {
+  Node& p = node(parent);
+  lock(p.child_lock);
+  p.children.push_back(child);
+  unlock(p.child_lock);
+}
+
+void ConcurrentRRTTree::unlink_child(uint32_t parent, uint32_t child) {
+  Node& p = node(parent);
+  lock(p.child_lock);
+  auto& c = p.children;
+  auto it = std::find(c.begin(), c.end(), child);
+  if (it != c.end()) {
+    *it = c.back();
+    c.pop_back();
+  }
+  unlock(p.child_lock);
+}
+
+bool ConcurrentRRTTree::rewire(uint32_t i, uint32_t new_parent, double edge) {
+  Node& n = node(i);
+  lock(n.node_lock);
+  // Costs only decrease, so cost(new_parent) read now is an upper bound of
+  // its cost at any later time and the parent < child invariant holds.
+  const double c_new = cost(new_parent) + edge;
+  if (c_new >= n.cost.load(std::memory_order_relaxed)) {
+    unlock(n.node_lock);
+    return false;
+  }
+  const uint32_t old = n.parent.load(std::memory_order_relaxed);
+  n.parent.store(new_parent, std::memory_order_release);
+  n.cost.store(c_new, std::memory_order_release);
+  unlock(n.node_lock);
+
+  unlink_child(old, i);
+  link_child(new_parent, i);
+  propagate(i);
+  return true;
+}
+
+void ConcurrentRRTTree::propagate(uint32_t root) {
+  // A child whose parent changed meanwhile is skipped; one reached through a
+  // stale list keeps a cost that is too high, never too low.
+  std::vector<uint32_t> stack{root}, kids;
+  while (!stack.empty()) {
+    const uint32_t u = stack.back();
+    stack.pop_back();
+    Node& nu = node(u);
+    const double cu = nu.cost.load(std::memory_order_acquire);
+    lock(nu.child_lock);
+    kids = nu.children;
+    unlock(nu.child_lock);
+    for (uint32_t c : kids) {
+      bool lowered = false;
+      Node& nc = node(c);
+      lock(nc.node_lock);
+      if (nc.parent.load(std::memory_order_relaxed) == u) {
+        const double cost_c = cu + std::hypot(nc.x - nu.x, nc.y - nu.y);
+        if (cost_c < nc.cost.load(std::memory_order_relaxed)) {
+          nc.cost.store(cost_c, std::memory_order_release);
+          lowered = true;
+        }
+      }
+      unlock(nc.node_lock);
+      if (lowered) stack.push_back(c);
+    }
+  }
+}
+
+std::vector<size_t> ConcurrentRRTTree::path_to_root(size_t i) const {
+  std::vector<size_t> trace;
+  for (size_t cur = i; cur != kNone; cur = parent(cur)) trace.push_back(cur);
+  std::reverse(trace.begin(), trace.end());
+  return trace;
+}
+
+}  // namespace pbs
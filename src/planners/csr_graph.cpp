@@ -0,0 +1,85 @@
+#include "planners/csr_graph.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace pbs {
+
+CSRGraph::CSRGraph(std::shared_ptr<const void> owner, uint32_t num_nodes, size_t num_edges,
+                   const uint64_t* offsets, const uint32_t* targets, const float* weights,
+                   bool prevalidated)
+  : owner_(std::move(owner)), num_nodes_(num_nodes), num_edges_(num_edges),
+    offsets_(offsets), targets_(targets), weights_(weights),
+    checked_((num_edges + 63) / 64, prevalidated ? ~uint64_t{0} : 0),
+    valid_((num_edges + 63) / 64, ~uint64_t{0}) {}
+
+void CSRGraph::set_checked(uint64_t e, bool valid) {
+  const uint64_t bit = uint64_t{1} << (e & 63);
+  checked_[e >> 6] |= bit;
+  if (valid) valid_[e >> 6] |= bit;
+  else valid_[e >> 6] &= ~bit;
+}
+
+uint64_t CSRGraph::find_edge(uint32_t u, uint32_t v) const {
+  // Rows built by CSRGraphBuilder are sorted by target.
+  const uint32_t* first = targets_ + begin(u);
+  const uint32_t* last = targets_ + end(u);
+  const uint32_t* it = std::lower_bound(first, last, v);
+  return it != last && *it == v ? static_cast<uint64_t>(it - targets_) : end(u);
+}
+
+size_t CSRGraph::memory_bytes() const {
+  return (static_cast<size_t>(num_nodes_) + 1) * sizeof(uint64_t) +
+         num_edges_ * (sizeof(uint32_t) + sizeof(float)) +
+         (checked_.size() + valid_.size()) * sizeof(uint64_t);
+}
+
+CSRGraphBuilder::CSRGraphBuilder(uint32_t num_nodes, int num_buffers)
+  : num_nodes_(num_nodes), buffers_(static_cast<size_t>(std::max(num_buffers, 1))) {}
+
+CSRGraph CSRGraphBuilder::build(bool symmetric, bool prevalidated) const {
+  // Count, prefix-sum, scatter, then sort and deduplicate each row.
+  std::vector<uint64_t> offsets(static_cast<size_t>(num_nodes_) + 1, 0);
+  for (const auto& buf : buffers_)
+    for (const Edge& e : buf) {
+      ++offsets[e.from + 1];
+      if (symmetric) ++offsets[e.to + 1];
+    }
+  for (uint32_t u = 0; u < num_nodes_; ++u) offsets[u + 1] += offsets[u];
+
+  std::vector<std::pair<uint32_t, float>> slots(offsets[num_nodes_]);
+  std::vector<uint64_t> fill(offsets.begin(), offsets.end() - 1);
+  for (const auto& buf : buffers_)
+    for (const Edge& e : buf) {
+      slots[fill[e.from]++] = {e.to, e.weight};
+      if (symmetric) slots[fill[e.to]++] = {e.from, e.weight};
+    }
+
+  struct Storage {
+    std::vector<uint64_t> offsets;
+    std::vector<uint32_t> targets;
+    std::vector<float> weights;
+  };
+  auto storage = std::make_shared<Storage>();
+  storage->offsets.resize(offsets.size());
+  storage->targets.reserve(slots.size());
+  storage->weights.reserve(slots.size());
+  for (uint32_t u = 0; u < num_nodes_; ++u) {
+    storage->offsets[u] = storage->targets.size();
+    auto first = slots.begin() + static_cast<ptrdiff_t>(offsets[u]);
+    auto last = slots.begin() + static_cast<ptrdiff_t>(offsets[u + 1]);
+    std::sort(first, last);
+    for (auto it = first; it != last; ++it) {
+      if (it != first && it->first == (it - 1)->first) continue;
+      storage->targets.push_back(it->first);
+      storage->weights.push_back(it->second);
+    }
+  }
+  storage->offsets[num_nodes_] = storage->targets.size();
+  const size_t m = storage->targets.size();
+  const uint64_t* o = storage->offsets.data();
+  const uint32_t* t = storage->targets.data();
+  const float* w = storage->weights.data();
+  return CSRGraph(std::move(storage), num_nodes_, m, o, t, w, prevalidated);
+}
+
+}  // namespace pbs
@@ -1,4 +1,5 @@
 #include "planners/dijkstra.hpp"
+#include "environment/environment_decorator.hpp"
 #include "environment/grid_environment.hpp"
 #include <algorithm>
 #include <queue>
@@ -30,7 +31,7 @@ Path DijkstraPlanner::solve(const IEnvironment& env, const State& start,
                             const State& goal) {
   nodes_expanded_ = 0;
   Path result;
-  const auto* grid = dynamic_cast<const GridEnvironment*>(&env);
+  const auto* grid = env_cast<GridEnvironment>(env);
   if (!grid) {
     result.success = false;
     return result;
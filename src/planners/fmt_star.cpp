@@ -0,0 +1,125 @@
+#include "planners/fmt_star.hpp"
+#include "environment/free_space.hpp"
+#include "environment/ienvironment.hpp"
+#include "geometry/kdtree2d.hpp"
+#include "geometry/point2d.hpp"
+#include "planners/roadmap.hpp"
+#include <algorithm>
+#include <queue>
+#include <cstddef>
+#include <cmath>
+
+namespace pbs {
+
+FMTStarPlanner::FMTStarPlanner(int num_samples, double radius_factor)
+  : num_samples_(num_samples), radius_factor_(radius_factor) {}
+
+Path FMTStarPlanner::solve(const IEnvironment& env, const State& start,
+                           const State& goal) {
+  nodes_expanded_ = 0;
+  edges_checked_ = 0;
+
+  double x_min = 0, x_max = 0, y_min = 0, y_max = 0;
+  if (!env.get_bounds(x_min, x_max, y_min, y_max)) {
+    Path p; p.success = false; return p;
+  }
+
+  std::vector<Point2D> points;
+  points.push_back(Point2D(start.x, start.y));
+  points.push_back(Point2D(goal.x, goal.y));
+
+  auto sampler = new_sampler();
+  auto free_space = free_space_sampling_ ? free_space_sampler(env) : nullptr;
+  sample_valid_points(env, *sampler, free_space.get(), num_samples_, points);
+
+  KdTree2D tree;
+  tree.build(points);
+  // r_n = eta * 2 (1 + 1/d)^(1/d) (mu / zeta_d)^(1/d) (log n / n)^(1/d), d = 2.
+  // mu is the free area when the free-space sampler knows it; otherwise the
+  // bounds area stands in, which overestimates r_n on cluttered maps.
+  const double n = static_cast<double>(points.size());
+  double area = (x_max - x_min) * (y_max - y_min);
+  if (free_space) area *= free_space->free_fraction();
+  const double r = radius_factor_ * 2.0 * std::sqrt(1.5 * area / M_PI) *
+                   std::sqrt(std::log(n) / n);
+
+  const size_t start_idx = 0, goal_idx = 1;
+  std::vector<std::vector<size_t>> near(points.size());
+  std::vector<char> has_near(points.size(), 0);
+  auto neighbors = [&](size_t i) -> const std::vector<size_t>& {
+    if (!has_near[i]) {
+      near[i] = tree.radius_search(points[i], r);
+      has_near[i] = 1;
+    }
+    return near[i];
+  };
+  auto dist = [&](size_t a, size_t b) {
+    return std::hypot(points[a].x - points[b].x, points[a].y - points[b].y);
+  };
+
+  enum : char { kUnvisited, kOpen, kClosed };
+  std::vector<char> status(points.size(), kUnvisited);
+  std::vector<double> cost(points.size(), 1e99);
+  std::vector<size_t> parent(points.size(), SIZE_MAX);
+  using PQ = std::priority_queue<std::pair<double, size_t>,
+         std::vector<std::pair<double, size_t>>,
+         std::greater<std::pair<double, size_t>>>;
+  PQ open;
+  status[start_idx] = kOpen;
+  cost[start_idx] = 0;
+  open.push({0, start_idx});
+
+  std::vector<size_t> added;
+  while (!open.empty()) {
+    size_t z = open.top().second;
+    open.pop();
+    if (status[z] != kOpen) continue;
+    nodes_expanded_++;
+    if (z == goal_idx) break;
+
+    added.clear();
+    for (size_t x : neighbors(z)) {
+      if (status[x] != kUnvisited) continue;
+      // Locally optimal connection among the open neighbors of x.
+      size_t best_parent = SIZE_MAX;
+      double c_min = 1e99;
+      for (size_t y : neighbors(x)) {
+        if (status[y] != kOpen) continue;
+        double c = cost[y] + dist(y, x);
+        if (c < c_min) { c_min = c; best_parent = y; }
+      }
+      if (best_parent == SIZE_MAX) continue;
+      edges_checked_++;
+      if (!env.collision_free(State(points[best_parent].x, points[best_parent].y),
+                              State(points[x].x, points[x].y)))
+        continue;
+      parent[x] = best_parent;
+      cost[x] = c_min;
+      added.push_back(x);
+    }
+    // New nodes open only after z's sweep, so they cannot parent each other.
+    for (size_t x : added) {
+      status[x] = kOpen;
+      open.push({cost[x], x});
+    }
+    status[z] = kClosed;
+  }
+
+  Path path;
+  if (parent[goal_idx] == SIZE_MAX) {
+    path.success = false;
+    return path;
+  }
+
+  std::vector<size_t> trace;
+  for (size_t cur = goal_idx; cur != SIZE_MAX; cur = parent[cur])
+    trace.push_back(cur);
+  std::reverse(trace.begin(), trace.end());
+  for (size_t i : trace)
+    path.states.push_back(State(points[i].x, points[i].y));
+  path.success = true;
+  path.compute_length();
+  return path;
+}
+
+}  // namespace pbs
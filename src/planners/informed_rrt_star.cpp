@@ -1,7 +1,8 @@
 #include "planners/informed_rrt_star.hpp"
+#include "planners/informed_set.hpp"
+#include "planners/rrt_tree.hpp"
 #include "environment/ienvironment.hpp"
 #include "geometry/point2d.hpp"
-#include <random>
 #include <cmath>
 #include <vector>
 #include <algorithm>
@@ -17,23 +18,6 @@ double rrt_star_radius(size_t n, double gamma, int dim, double step_size) {
   return std::min(r, step_size * 2.0);
 }
 
-void sample_ellipse(double sx, double sy, double gx, double gy, double c_best,
-                    std::mt19937& rng, double& x, double& y) {
-  double c_min = std::hypot(gx - sx, gy - sy);
-  if (c_best <= c_min) { x = sx; y = sy; return; }
-  double a = c_best / 2;
-  double c = c_min / 2;
-  double b = std::sqrt(std::max(0.0, a * a - c * c));
-  std::uniform_real_distribution<double> u01(0, 1), u02pi(0, 2 * M_PI);
-  double theta = u02pi(rng);
-  double r = std::sqrt(u01(rng));
-  double ex = a * r * std::cos(theta);
-  double ey = b * r * std::sin(theta);
-  double angle = std::atan2(gy - sy, gx - sx);
-  x = sx + (gx - sx) / 2 + ex * std::cos(angle) - ey * std::sin(angle);
-  y = sy + (gy - sy) / 2 + ex * std::sin(angle) + ey * std::cos(angle);
-}
-
 }  // namespace
 
 InformedRRTStarPlanner::InformedRRTStarPlanner(double step_size, double goal_bias,
@@ -44,6 +28,7 @@ InformedRRTStarPlanner::InformedRRTStarPlanner(double step_size, double goal_bia
 Path InformedRRTStarPlanner::solve(const IEnvironment& env, const State& start,
                                    const State& goal) {
   nodes_expanded_ = 0;
+  nodes_pruned_ = 0;
   conv_data_ = ConvergenceData{};
 
   double x_min = 0, x_max = 0, y_min = 0, y_max = 0;
@@ -51,109 +36,124 @@ Path InformedRRTStarPlanner::solve(const IEnvironment& env, const State& start,
     Path p; p.success = false; return p;
   }
 
-  std::vector<Point2D> tree;
-  tree.push_back(Point2D(start.x, start.y));
-  std::vector<size_t> parent;
-  parent.push_back(0);
-  std::vector<double> cost;
-  cost.push_back(0.0);
+  RRTTree tree;
+  // Growth beyond this is amortized; a time budget usually comes with a
+  // max_iter far above what the tree reaches.
+  tree.reserve(std::min<size_t>(static_cast<size_t>(max_iter_) + 1, size_t{1} << 16));
+  tree.add(start.x, start.y, 0.0, RRTTree::kNone, 0.0);
 
-  std::mt19937 rng(42);
-  std::uniform_real_distribution<double> u01(0, 1), ux(x_min, x_max), uy(y_min, y_max);
+  auto sampler = new_sampler();
 
   const double goal_thresh = step_size_ * 1.5;
   double best_cost = 1e99;
   size_t best_goal_idx = SIZE_MAX;
   bool has_path = false;
 
-  for (int iter = 0; iter < max_iter_; ++iter) {
+  Deadline deadline(time_budget_ms_);
+  auto log_tree_size = [&] {
+    conv_data_.tree_size_vs_time.push_back(
+        {deadline.elapsed_ms(), static_cast<int>(tree.size())});
+  };
+  // Branch and bound: cost-to-come plus the straight-line distance to the
+  // goal never decreases down the tree, so whole subtrees go at once.
+  auto prune = [&] {
+    std::vector<char> keep(tree.size());
+    for (size_t i = 0; i < tree.size(); ++i)
+      keep[i] = tree.cost(i) + std::hypot(goal.x - tree.x(i), goal.y - tree.y(i)) <=
+                best_cost + 1e-9;
+    const size_t before = tree.size();
+    const std::vector<uint32_t> remap = tree.prune(keep);
+    if (tree.size() == before) return;
+    nodes_pruned_ += static_cast<int>(before - tree.size());
+    best_goal_idx = remap[best_goal_idx];
+    log_tree_size();
+  };
+  for (int iter = 0; iter < max_iter_ && !deadline.expired(); ++iter) {
     Point2D sample;
-    if (has_path && u01(rng) > goal_bias_) {
-      sample_ellipse(start.x, start.y, goal.x, goal.y, best_cost, rng,
-                    sample.x, sample.y);
+    if (has_path && sampler->uniform() > goal_bias_) {
+      double u = 0, v = 0;
+      sampler->next(u, v);
+      sample_ellipse(start.x, start.y, goal.x, goal.y, best_cost, u, v, sample.x, sample.y);
       if (sample.x < x_min || sample.x > x_max || sample.y < y_min || sample.y > y_max)
         continue;
-    } else if (u01(rng) < goal_bias_) {
+    } else if (sampler->uniform() < goal_bias_) {
       sample.x = goal.x; sample.y = goal.y;
     } else {
-      sample.x = ux(rng); sample.y = uy(rng);
+      double u = 0, v = 0;
+      sampler->next(u, v);
+      sample.x = x_min + u * (x_max - x_min);
+      sample.y = y_min + v * (y_max - y_min);
     }
 
+    const double* xs = tree.xs();
+    const double* ys = tree.ys();
     size_t near_idx = 0;
     double near_d2 = 1e99;
     for (size_t i = 0; i < tree.size(); ++i) {
-      double dx = sample.x - tree[i].x, dy = sample.y - tree[i].y;
+      double dx = sample.x - xs[i], dy = sample.y - ys[i];
       double d2 = dx * dx + dy * dy;
       if (d2 < near_d2) { near_d2 = d2; near_idx = i; }
     }
 
-    double dx = sample.x - tree[near_idx].x, dy = sample.y - tree[near_idx].y;
+    double dx = sample.x - xs[near_idx], dy = sample.y - ys[near_idx];
     double d = std::sqrt(dx * dx + dy * dy);
     Point2D new_pt;
     if (d <= step_size_ || d < 1e-9) {
       new_pt = sample;
     } else {
-      new_pt.x = tree[near_idx].x + step_size_ * dx / d;
-      new_pt.y = tree[near_idx].y + step_size_ * dy / d;
+      new_pt.x = xs[near_idx] + step_size_ * dx / d;
+      new_pt.y = ys[near_idx] + step_size_ * dy / d;
     }
 
-    State a(tree[near_idx].x, tree[near_idx].y);
+    State a(xs[near_idx], ys[near_idx]);
     State b(new_pt.x, new_pt.y);
     if (!env.collision_free(a, b)) continue;
     if (!env.is_valid(State(new_pt.x, new_pt.y))) continue;
 
-    double seg_cost = std::hypot(new_pt.x - tree[near_idx].x, new_pt.y - tree[near_idx].y);
-    double c_min = cost[near_idx] + seg_cost;
+    double seg_cost = std::hypot(new_pt.x - xs[near_idx], new_pt.y - ys[near_idx]);
+    double c_min = tree.cost(near_idx) + seg_cost;
     size_t best_parent = near_idx;
 
     double r = rrt_star_radius(tree.size(), gamma_, 2, step_size_);
     for (size_t i = 0; i < tree.size(); ++i) {
-      double dist = std::hypot(tree[i].x - new_pt.x, tree[i].y - new_pt.y);
+      double dist = std::hypot(xs[i] - new_pt.x, ys[i] - new_pt.y);
       if (dist > r) continue;
-      State ai(tree[i].x, tree[i].y);
+      State ai(xs[i], ys[i]);
       if (!env.collision_free(ai, b)) continue;
-      double c = cost[i] + dist;
+      double c = tree.cost(i) + dist;
       if (c < c_min) { c_min = c; best_parent = i; }
     }
 
-    tree.push_back(new_pt);
-    parent.push_back(best_parent);
-    cost.push_back(c_min);
+    const size_t new_idx = tree.add(new_pt.x, new_pt.y, 0.0, best_parent, c_min);
+    xs = tree.xs();
+    ys = tree.ys();
 
-    for (size_t i = 0; i < tree.size() - 1; ++i) {
-      double dist = std::hypot(tree[i].x - new_pt.x, tree[i].y - new_pt.y);
+    for (size_t i = 0; i < new_idx; ++i) {
+      double dist = std::hypot(xs[i] - new_pt.x, ys[i] - new_pt.y);
       if (dist > r) continue;
-      State ai(tree[i].x, tree[i].y);
+      double c_new = tree.cost(new_idx) + dist;
+      if (c_new >= tree.cost(i)) continue;
+      State ai(xs[i], ys[i]);
       if (!env.collision_free(ai, b)) continue;
-      double c_new = cost.back() + dist;
-      if (c_new < cost[i]) {
-        parent[i] = tree.size() - 1;
-        cost[i] = c_new;
-        std::vector<size_t> stack = {i};
-        while (!stack.empty()) {
-          size_t u = stack.back(); stack.pop_back();
-          for (size_t j = 0; j < tree.size() - 1; ++j) {
-            if (parent[j] == u) {
-              double d_uj = std::hypot(tree[j].x - tree[u].x, tree[j].y - tree[u].y);
-              cost[j] = cost[u] + d_uj;
-              stack.push_back(j);
-            }
-          }
-        }
-      }
+      tree.rewire(i, new_idx, c_new);
     }
 
-    nodes_expanded_ = static_cast<int>(tree.size());
+    nodes_expanded_ = static_cast<int>(tree.size()) + nodes_pruned_;
 
     double to_goal = std::hypot(goal.x - new_pt.x, goal.y - new_pt.y);
     if (to_goal < goal_thresh) {
       State sa(new_pt.x, new_pt.y), sg(goal.x, goal.y);
       if (env.collision_free(sa, sg)) {
-        double c_goal = cost.back() + to_goal;
+        double c_goal = tree.cost(new_idx) + to_goal;
         if (c_goal < best_cost) {
           best_cost = c_goal;
-          best_goal_idx = tree.size() - 1;
+          best_goal_idx = new_idx;
           has_path = true;
+          conv_data_.cost_vs_time.push_back({deadline.elapsed_ms(), best_cost});
+          if (pruning_) {
+            log_tree_size();
+            prune();
+          }
         }
       }
     }
@@ -161,7 +161,9 @@ Path InformedRRTStarPlanner::solve(const IEnvironment& env, const State& start,
     if (has_path) {
       conv_data_.cost_vs_iteration.push_back({iter + 1, best_cost});
     }
+    if ((iter + 1) % 256 == 0) log_tree_size();
   }
+  log_tree_size();
 
   conv_data_.final_cost = best_cost;
   if (optimal_cost_ > 0)
@@ -174,14 +176,8 @@ Path InformedRRTStarPlanner::solve(const IEnvironment& env, const State& start,
   }
 
   Path path;
-  std::vector<size_t> trace;
-  for (size_t cur = best_goal_idx; ; cur = parent[cur]) {
-    trace.push_back(cur);
-    if (cur == 0) break;
-  }
-  std::reverse(trace.begin(), trace.end());
-  for (size_t i : trace)
-    path.states.push_back(State(tree[i].x, tree[i].y));
+  for (size_t i : tree.path_to_root(best_goal_idx))
+    path.states.push_back(State(tree.x(i), tree.y(i)));
   path.states.push_back(State(goal.x, goal.y));
   path.success = true;
   path.compute_length();
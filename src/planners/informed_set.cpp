@@ -0,0 +1,31 @@
+#include "planners/informed_set.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace pbs {
+
+void sample_ellipse(double sx, double sy, double gx, double gy, double c_best,
+                    double u, double v, double& x, double& y) {
+  double c_min = std::hypot(gx - sx, gy - sy);
+  if (c_best <= c_min) { x = sx; y = sy; return; }
+  double a = c_best / 2;
+  double c = c_min / 2;
+  double b = std::sqrt(std::max(0.0, a * a - c * c));
+  double theta = u * (2 * M_PI);
+  double r = std::sqrt(v);
+  double ex = a * r * std::cos(theta);
+  double ey = b * r * std::sin(theta);
+  double angle = std::atan2(gy - sy, gx - sx);
+  x = sx + (gx - sx) / 2 + ex * std::cos(angle) - ey * std::sin(angle);
+  y = sy + (gy - sy) / 2 + ex * std::sin(angle) + ey * std::cos(angle);
+}
+
+double ellipse_area(double sx, double sy, double gx, double gy, double c_best) {
+  double c_min = std::hypot(gx - sx, gy - sy);
+  if (c_best <= c_min) return 0.0;
+  double a = c_best / 2;
+  double b = std::sqrt(a * a - c_min * c_min / 4);
+  return M_PI * a * b;
+}
+
+}  // namespace pbs
@@ -1,13 +1,17 @@
 #include "planners/lazy_prm.hpp"
+#include "environment/free_space.hpp"
 #include "environment/ienvironment.hpp"
 #include "geometry/kdtree2d.hpp"
 #include "geometry/point2d.hpp"
-#include <random>
+#include "planners/roadmap.hpp"
+#include "planners/csr_graph.hpp"
 #include <algorithm>
 #include <queue>
-#include <set>
 #include <cstddef>
 #include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
 
 namespace pbs {
 
@@ -17,6 +21,7 @@ LazyPRMPlanner::LazyPRMPlanner(int num_samples, int k_neighbors)
 Path LazyPRMPlanner::solve(const IEnvironment& env, const State& start,
                            const State& goal) {
   nodes_expanded_ = 0;
+  edges_checked_ = 0;
 
   double x_min = 0, x_max = 0, y_min = 0, y_max = 0;
   if (!env.get_bounds(x_min, x_max, y_min, y_max)) {
@@ -27,83 +32,135 @@ Path LazyPRMPlanner::solve(const IEnvironment& env, const State& start,
   points.push_back(Point2D(start.x, start.y));
   points.push_back(Point2D(goal.x, goal.y));
 
-  std::mt19937 rng(42);
-  std::uniform_real_distribution<double> ux(x_min, x_max), uy(y_min, y_max);
-  int collected = 0, attempts = 0;
-  while (collected < num_samples_ && attempts < num_samples_ * 10) {
-    double x = ux(rng), y = uy(rng);
-    State s(x, y);
-    if (env.is_valid(s)) {
-      points.push_back(Point2D(x, y));
-      collected++;
-    }
-    attempts++;
-  }
+  auto sampler = new_sampler();
+  auto free_space = free_space_sampling_ ? free_space_sampler(env) : nullptr;
+  sample_valid_points(env, *sampler, free_space.get(), num_samples_, points);
 
   KdTree2D tree;
   tree.build(points);
 
-  std::vector<std::vector<std::pair<size_t, double>>> adj(points.size());
-  for (size_t i = 0; i < points.size(); ++i) {
-    auto knn = tree.k_nearest(points[i], k_neighbors_ + 1);
-    for (size_t j : knn) {
-      if (j == i) continue;
-      double d = std::hypot(points[j].x - points[i].x, points[j].y - points[i].y);
-      adj[i].push_back({j, d});
-    }
-  }
+  // Undirected k-nearest-neighbour graph; no edge is checked yet.
+  const auto n = static_cast<uint32_t>(points.size());
+  CSRGraphBuilder builder(n);
+  for (uint32_t i = 0; i < n; ++i)
+    for (size_t j : tree.k_nearest(points[i], k_neighbors_ + 1))
+      if (j != i)
+        builder.add(0, i, static_cast<uint32_t>(j),
+                    static_cast<float>(std::hypot(points[j].x - points[i].x,
+                                                  points[j].y - points[i].y)));
+  CSRGraph graph = builder.build(true, false);
+  auto usable = [&](uint64_t e) { return !graph.checked(e) || graph.valid(e); };
 
-  std::set<std::pair<size_t, size_t>> invalid_edges;
-  auto edge_valid = [&](size_t a, size_t b) {
-    if (a > b) std::swap(a, b);
-    if (invalid_edges.count({a, b})) return false;
-    State sa(points[a].x, points[a].y);
-    State sb(points[b].x, points[b].y);
-    if (!env.collision_free(sa, sb)) {
-      invalid_edges.insert({a, b});
-      return false;
+  // LPA* over the edges not known to be invalid: invalidating an edge only
+  // repairs the part of the search that depended on it.
+  const uint32_t start_idx = 0, goal_idx = 1;
+  const double inf = std::numeric_limits<double>::infinity();
+  std::vector<double> g(n, inf), rhs(n, inf), h(n);
+  for (uint32_t i = 0; i < n; ++i)
+    h[i] = std::hypot(points[goal_idx].x - points[i].x, points[goal_idx].y - points[i].y);
+  using Key = std::pair<double, double>;
+  auto key = [&](uint32_t u) {
+    const double m = std::min(g[u], rhs[u]);
+    return Key{m + h[u], m};
+  };
+  using Item = std::pair<Key, uint32_t>;
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> open;
+  // Entries are dropped lazily: an item is live while its node is
+  // inconsistent and its key is current.
+  auto top = [&]() -> const Item* {
+    while (!open.empty()) {
+      const auto& [k, u] = open.top();
+      if (g[u] != rhs[u] && k == key(u)) return &open.top();
+      open.pop();
+    }
+    return nullptr;
+  };
+  auto update = [&](uint32_t u) {
+    if (u != start_idx) {
+      rhs[u] = inf;
+      for (uint64_t e = graph.begin(u); e < graph.end(u); ++e)
+        if (usable(e)) rhs[u] = std::min(rhs[u], g[graph.target(e)] + graph.weight(e));
     }
-    return true;
+    if (g[u] != rhs[u]) open.push({key(u), u});
   };
+  rhs[start_idx] = 0;
+  open.push({key(start_idx), start_idx});
 
-  const size_t start_idx = 0, goal_idx = 1;
-  std::vector<double> dist(points.size(), 1e99);
-  std::vector<size_t> parent(points.size(), SIZE_MAX);
-  dist[start_idx] = 0;
-  using PQ = std::priority_queue<std::pair<double, size_t>,
-         std::vector<std::pair<double, size_t>>,
-         std::greater<std::pair<double, size_t>>>;
-  PQ pq;
-  pq.push({0, start_idx});
+  Path path;
+  std::vector<uint32_t> trace;
+  std::vector<uint64_t> trace_edges, order;
+  while (true) {
+    for (const Item* t = top(); t && (t->first < key(goal_idx) || rhs[goal_idx] != g[goal_idx]);
+         t = top()) {
+      const uint32_t u = t->second;
+      open.pop();
+      nodes_expanded_++;
+      if (g[u] > rhs[u]) {
+        g[u] = rhs[u];
+      } else {
+        g[u] = inf;
+        update(u);
+      }
+      for (uint64_t e = graph.begin(u); e < graph.end(u); ++e)
+        if (usable(e)) update(graph.target(e));
+    }
+    if (g[goal_idx] == inf) {
+      path.success = false;
+      return path;
+    }
 
-  while (!pq.empty()) {
-    auto [d, u] = pq.top(); pq.pop();
-    if (d > dist[u]) continue;
-    nodes_expanded_++;
-    if (u == goal_idx) break;
-    for (const auto& [v, w] : adj[u]) {
-      if (!edge_valid(u, v)) continue;
-      double nd = dist[u] + w;
-      if (nd < dist[v]) {
-        dist[v] = nd;
-        parent[v] = u;
-        pq.push({nd, v});
+    // Walk back along the best predecessors.
+    trace.assign(1, goal_idx);
+    trace_edges.clear();
+    for (uint32_t cur = goal_idx; cur != start_idx;) {
+      uint32_t best = UINT32_MAX;
+      uint64_t best_e = 0;
+      double best_g = inf;
+      for (uint64_t e = graph.begin(cur); e < graph.end(cur); ++e)
+        if (usable(e) && g[graph.target(e)] + graph.weight(e) < best_g) {
+          best_g = g[graph.target(e)] + graph.weight(e);
+          best = graph.target(e);
+          best_e = e;
+        }
+      if (best == UINT32_MAX) {
+        path.success = false;
+        return path;
       }
+      cur = best;
+      trace.push_back(cur);
+      trace_edges.push_back(best_e);
     }
-  }
 
-  Path path;
-  if (dist[goal_idx] >= 1e98) {
-    path.success = false;
-    return path;
+    // Check the unverified path edges, longest (most likely to collide)
+    // first, stopping at the first failure.
+    order.clear();
+    for (size_t i = 0; i < trace_edges.size(); ++i)
+      if (!graph.checked(trace_edges[i])) order.push_back(i);
+    std::sort(order.begin(), order.end(), [&](uint64_t a, uint64_t b) {
+      return graph.weight(trace_edges[a]) > graph.weight(trace_edges[b]);
+    });
+    bool blocked = false;
+    for (uint64_t i : order) {
+      // trace_edges[i] leads from trace[i] back to trace[i + 1]; both
+      // directions share the result.
+      const uint32_t a = trace[i], b = trace[i + 1];
+      const uint64_t e = trace_edges[i], rev = graph.find_edge(b, a);
+      ++edges_checked_;
+      const bool ok =
+          env.collision_free(State(points[a].x, points[a].y), State(points[b].x, points[b].y));
+      graph.set_checked(e, ok);
+      graph.set_checked(rev, ok);
+      if (ok) continue;
+      update(a);
+      update(b);
+      blocked = true;
+      break;
+    }
+    if (!blocked) break;
   }
 
-  std::vector<size_t> trace;
-  for (size_t cur = goal_idx; cur != SIZE_MAX; cur = parent[cur])
-    trace.push_back(cur);
   std::reverse(trace.begin(), trace.end());
-
-  for (size_t i : trace)
+  for (uint32_t i : trace)
     path.states.push_back(State(points[i].x, points[i].y));
   path.success = true;
   path.compute_length();
@@ -0,0 +1,221 @@
+#include "planners/path_postprocessor.hpp"
+#include "environment/ienvironment.hpp"
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace pbs {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double ms_since(Clock::time_point t) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - t).count();
+}
+
+double subpath_length(const std::vector<State>& s, size_t i, size_t j) {
+  double len = 0.0;
+  for (size_t k = i; k < j; ++k) len += distance(s[k], s[k + 1]);
+  return len;
+}
+
+// Uniform cubic B-spline span over q[0..3] at t in [0, 1].
+State spline_point(const State* q, double t) {
+  const double t2 = t * t, t3 = t2 * t, u = 1.0 - t;
+  const double b0 = u * u * u / 6.0;
+  const double b1 = (3 * t3 - 6 * t2 + 4) / 6.0;
+  const double b2 = (-3 * t3 + 3 * t2 + 3 * t + 1) / 6.0;
+  const double b3 = t3 / 6.0;
+  return State(b0 * q[0].x + b1 * q[1].x + b2 * q[2].x + b3 * q[3].x,
+               b0 * q[0].y + b1 * q[1].y + b2 * q[2].y + b3 * q[3].y);
+}
+
+}  // namespace
+
+PathPostprocessor::PathPostprocessor(const PathPostprocessOptions& options)
+  : options_(options) {}
+
+bool PathPostprocessor::segment_free(const IEnvironment& env, const State& a,
+                                     const State& b) {
+  ++stats_.collision_checks;
+  return env.collision_free(a, b);
+}
+
+Path PathPostprocessor::process(const IEnvironment& env, const Path& path) {
+  stats_ = {};
+  Path out = path;
+  if (!path.success || path.states.size() < 3) return out;
+  for (const State& s : path.states)
+    if (s.theta) return out;
+
+  auto t0 = Clock::now();
+  if (options_.shortcut == ShortcutMode::Greedy) greedy_shortcut(env, out);
+  else if (options_.shortcut == ShortcutMode::Random) random_shortcut(env, out);
+  stats_.shortcut_ms = ms_since(t0);
+
+  if (options_.bspline) {
+    t0 = Clock::now();
+    bspline(env, out);
+    stats_.bspline_ms = ms_since(t0);
+  }
+  out.compute_length();
+  return out;
+}
+
+void PathPostprocessor::greedy_shortcut(const IEnvironment& env, Path& path) {
+  // From each kept vertex, jump to the farthest vertex it sees.
+  const std::vector<State>& s = path.states;
+  std::vector<State> out{s.front()};
+  for (size_t i = 0; i + 1 < s.size();) {
+    size_t j = s.size() - 1;
+    while (j > i + 1 && !segment_free(env, s[i], s[j])) --j;
+    if (j > i + 1) ++stats_.shortcuts;
+    out.push_back(s[j]);
+    i = j;
+  }
+  path.states = std::move(out);
+}
+
+void PathPostprocessor::random_shortcut(const IEnvironment& env, Path& path) {
+  // Candidate (i, j): axis -1 replaces s[i..j] by the segment s[i] s[j];
+  // axis 0 / 1 interpolates only x / y between them by arc length.
+  struct Candidate {
+    size_t i, j;
+    int axis;
+    double gain;
+    std::vector<State> interior;
+  };
+  std::mt19937_64 rng(options_.seed);
+  std::vector<State>& s = path.states;
+  std::vector<Candidate> batch;
+  std::vector<const Candidate*> accepted;
+
+  for (int it = 0; it < options_.iterations && s.size() >= 3; ++it) {
+    batch.clear();
+    const size_t n = s.size();
+    for (int b = 0; b < options_.batch_size; ++b) {
+      Candidate c;
+      c.i = std::uniform_int_distribution<size_t>(0, n - 3)(rng);
+      c.j = std::uniform_int_distribution<size_t>(c.i + 2, n - 1)(rng);
+      c.axis = options_.partial && (rng() & 1) ? static_cast<int>((rng() >> 1) & 1) : -1;
+      const double old_len = subpath_length(s, c.i, c.j);
+      double new_len = distance(s[c.i], s[c.j]);
+      if (c.axis >= 0) {
+        double arc = 0.0;
+        for (size_t k = c.i + 1; k < c.j; ++k) {
+          arc += distance(s[k - 1], s[k]);
+          const double t = old_len > 0 ? arc / old_len : 0.0;
+          State q(s[k].x, s[k].y);
+          if (c.axis == 0) q.x = s[c.i].x + t * (s[c.j].x - s[c.i].x);
+          else q.y = s[c.i].y + t * (s[c.j].y - s[c.i].y);
+          c.interior.push_back(q);
+        }
+        new_len = 0.0;
+        const State* prev = &s[c.i];
+        for (const State& q : c.interior) {
+          new_len += distance(*prev, q);
+          prev = &q;
+        }
+        new_len += distance(*prev, s[c.j]);
+      }
+      c.gain = old_len - new_len;
+      if (c.gain > 1e-9) batch.push_back(std::move(c));
+    }
+
+    // Best gain first; a candidate whose interior overlaps an accepted one
+    // would be invalidated by it, so it is dropped without a check.
+    std::stable_sort(batch.begin(), batch.end(),
+                     [](const Candidate& a, const Candidate& b) { return a.gain > b.gain; });
+    accepted.clear();
+    for (const Candidate& c : batch) {
+      bool overlaps = false;
+      for (const Candidate* a : accepted)
+        if (c.i < a->j && a->i < c.j) { overlaps = true; break; }
+      if (overlaps) continue;
+      bool ok = true;
+      if (c.axis < 0) {
+        ok = segment_free(env, s[c.i], s[c.j]);
+      } else {
+        const State* prev = &s[c.i];
+        for (const State& q : c.interior) {
+          if (!(ok = segment_free(env, *prev, q))) break;
+          prev = &q;
+        }
+        ok = ok && segment_free(env, *prev, s[c.j]);
+      }
+      if (ok) accepted.push_back(&c);
+    }
+
+    // Apply right to left so earlier indices stay valid.
+    std::sort(accepted.begin(), accepted.end(),
+              [](const Candidate* a, const Candidate* b) { return a->i > b->i; });
+    for (const Candidate* c : accepted) {
+      auto first = s.begin() + static_cast<ptrdiff_t>(c->i + 1);
+      auto last = s.begin() + static_cast<ptrdiff_t>(c->j);
+      if (c->axis < 0) s.erase(first, last);
+      else std::copy(c->interior.begin(), c->interior.end(), first);
+    }
+    stats_.shortcuts += static_cast<int>(accepted.size());
+  }
+}
+
+void PathPostprocessor::bspline(const IEnvironment& env, Path& path) {
+  const int samples = std::max(options_.samples_per_span, 1);
+  // The path is the control polygon, with tripled endpoints so the curve
+  // starts and ends on them. Where a span collides, the polygon edges under
+  // it are split at their midpoints, which pulls the curve towards the
+  // (free) polygon while keeping it C2; after kMaxRefinements the path is
+  // left as it is.
+  constexpr int kMaxRefinements = 12;
+  std::vector<State> p;
+  for (const State& s : path.states) p.push_back(State(s.x, s.y));
+  std::vector<State> q, curve;
+  std::vector<size_t> owner;
+  std::vector<char> split;
+  for (int round = 0;; ++round) {
+    q.clear();
+    owner.clear();
+    for (size_t k = 0; k < p.size(); ++k)
+      for (int r = 0; r < (k == 0 || k + 1 == p.size() ? 3 : 1); ++r) {
+        q.push_back(p[k]);
+        owner.push_back(k);
+      }
+    split.assign(p.size(), 0);
+    bool collides = false;
+    curve.assign(1, q.front());
+    for (size_t span = 0; span + 3 < q.size(); ++span) {
+      const size_t start = curve.size() - 1;
+      for (int k = 1; k <= samples; ++k)
+        curve.push_back(spline_point(&q[span], static_cast<double>(k) / samples));
+      for (size_t k = start; k + 1 < curve.size(); ++k) {
+        if (distance(curve[k], curve[k + 1]) < 1e-12 ||
+            segment_free(env, curve[k], curve[k + 1]))
+          continue;
+        collides = true;
+        for (size_t c = span; c < span + 3; ++c)
+          if (owner[c] != owner[c + 1]) split[owner[c]] = 1;
+        break;
+      }
+    }
+    if (!collides) break;
+    if (round == kMaxRefinements) return;
+    std::vector<State> refined;
+    for (size_t k = 0; k < p.size(); ++k) {
+      refined.push_back(p[k]);
+      if (split[k])
+        refined.push_back(State(0.5 * (p[k].x + p[k + 1].x), 0.5 * (p[k].y + p[k + 1].y)));
+    }
+    p = std::move(refined);
+  }
+
+  std::vector<State> out{path.states.front()};
+  for (const State& c : curve)
+    if (distance(out.back(), c) > 1e-9) out.push_back(c);
+  out.back() = path.states.back();
+  path.states = std::move(out);
+}
+
+}  // namespace pbs
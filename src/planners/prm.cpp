@@ -1,101 +1,78 @@
 #include "planners/prm.hpp"
+#include "environment/free_space.hpp"
 #include "environment/ienvironment.hpp"
-#include "geometry/kdtree2d.hpp"
-#include "geometry/point2d.hpp"
-#include <random>
+#include "environment/preprocessing_cache.hpp"
 #include <algorithm>
-#include <queue>
-#include <cstddef>
-#include <cmath>
+#include <chrono>
+#include <string>
 
 namespace pbs {
 
 PRMPlanner::PRMPlanner(int num_samples, int k_neighbors)
   : num_samples_(num_samples), k_neighbors_(k_neighbors) {}
 
+std::shared_ptr<const Roadmap> PRMPlanner::roadmap(const IEnvironment& env) {
+  last_build_ms_ = 0.0;
+  last_build_timings_ = {};
+  if (roadmap_) return roadmap_;
+  // Free-space samples are valid by construction; rejection is the
+  // fallback for environments without a decomposition.
+  auto free_space = free_space_sampling_ ? free_space_sampler(env) : nullptr;
+  auto build = [&] {
+    auto sampler = new_sampler();
+    auto r = build_roadmap(env, *sampler, free_space.get());
+    last_build_ms_ = r->build_ms();
+    last_build_timings_ = r->timings();
+    return r;
+  };
+  PreprocessingCache* cache = cache_roadmap_ ? preprocessing_cache_of(env) : nullptr;
+  if (!cache) return build();
+  const std::string key = roadmap_key() + "/" + sampler_config_.type + "/" +
+      std::to_string(sampler_config_.seed) + (free_space_sampling_ ? "/free" : "/reject");
+  return cache->get_or_build<Roadmap>(key, build);
+}
+
+RoadmapProvenance PRMPlanner::roadmap_provenance(const IEnvironment& env) const {
+  const std::string settings = roadmap_key() + "/" + sampler_config_.type +
+      (free_space_sampling_ ? "/free" : "/reject");
+  RoadmapProvenance p;
+  p.environment = environment_hash(env);
+  p.num_samples = static_cast<uint64_t>(num_samples_);
+  p.settings = hash_bytes(settings.data(), settings.size());
+  p.seed = sampler_config_.seed;
+  return p;
+}
+
+std::shared_ptr<const Roadmap> PRMPlanner::build_roadmap(const IEnvironment& env,
+                                                         ISampler& sampler,
+                                                         const FreeSpaceSampler* free_space) {
+  return Roadmap::build(env, num_samples_, k_neighbors_, sampler, free_space, num_threads_);
+}
+
+std::string PRMPlanner::roadmap_key() const {
+  return "prm/roadmap/" + std::to_string(num_samples_) + "/" + std::to_string(k_neighbors_);
+}
+
 Path PRMPlanner::solve(const IEnvironment& env, const State& start,
                        const State& goal) {
   nodes_expanded_ = 0;
+  last_build_ms_ = last_query_ms_ = 0.0;
 
   double x_min = 0, x_max = 0, y_min = 0, y_max = 0;
   if (!env.get_bounds(x_min, x_max, y_min, y_max)) {
     Path p; p.success = false; return p;
   }
+  last_roadmap_ = roadmap(env);
+  return query(*last_roadmap_, env, start, goal);
+}
 
-  std::vector<Point2D> points;
-  points.push_back(Point2D(start.x, start.y));
-  points.push_back(Point2D(goal.x, goal.y));
-
-  std::mt19937 rng(42);
-  std::uniform_real_distribution<double> ux(x_min, x_max), uy(y_min, y_max);
-  int collected = 0;
-  int attempts = 0;
-  while (collected < num_samples_ && attempts < num_samples_ * 10) {
-    double x = ux(rng), y = uy(rng);
-    State s(x, y);
-    if (env.is_valid(s)) {
-      points.push_back(Point2D(x, y));
-      collected++;
-    }
-    attempts++;
-  }
-
-  KdTree2D tree;
-  tree.build(points);
-
-  std::vector<std::vector<std::pair<size_t, double>>> adj(points.size());
-  for (size_t i = 0; i < points.size(); ++i) {
-    auto knn = tree.k_nearest(points[i], k_neighbors_ + 1);
-    for (size_t j : knn) {
-      if (j == i) continue;
-      State a(points[i].x, points[i].y);
-      State b(points[j].x, points[j].y);
-      if (env.collision_free(a, b)) {
-        double d = std::hypot(points[j].x - points[i].x, points[j].y - points[i].y);
-        adj[i].push_back({j, d});
-      }
-    }
-  }
-
-  const size_t start_idx = 0, goal_idx = 1;
-  std::vector<double> dist(points.size(), 1e99);
-  std::vector<size_t> parent(points.size(), SIZE_MAX);
-  dist[start_idx] = 0;
-  using PQ = std::priority_queue<std::pair<double, size_t>,
-         std::vector<std::pair<double, size_t>>,
-         std::greater<std::pair<double, size_t>>>;
-  PQ pq;
-  pq.push({0, start_idx});
-
-  while (!pq.empty()) {
-    auto [d, u] = pq.top(); pq.pop();
-    if (d > dist[u]) continue;
-    nodes_expanded_++;
-    if (u == goal_idx) break;
-    for (const auto& [v, w] : adj[u]) {
-      double nd = dist[u] + w;
-      if (nd < dist[v]) {
-        dist[v] = nd;
-        parent[v] = u;
-        pq.push({nd, v});
-      }
-    }
-  }
-
-  Path path;
-  if (dist[goal_idx] >= 1e98) {
-    path.success = false;
-    return path;
-  }
-
-  std::vector<size_t> trace;
-  for (size_t cur = goal_idx; cur != SIZE_MAX; cur = parent[cur])
-    trace.push_back(cur);
-  std::reverse(trace.begin(), trace.end());
-  for (size_t i : trace)
-    path.states.push_back(State(points[i].x, points[i].y));
-  path.success = true;
-  path.compute_length();
+Path PRMPlanner::query(const Roadmap& roadmap, const IEnvironment& env, const State& start,
+                       const State& goal) {
+  auto t0 = std::chrono::steady_clock::now();
+  Path path = roadmap.query(env, start, goal, static_cast<size_t>(std::max(k_neighbors_, 1)),
+                            &nodes_expanded_);
+  last_query_ms_ = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - t0).count();
   return path;
 }
 
@@ -0,0 +1,403 @@
+#include "planners/roadmap.hpp"
+#include "environment/free_space.hpp"
+#include "environment/ienvironment.hpp"
+#include "planners/sampler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace pbs {
+
+namespace {
+
+constexpr char kMagic[8] = {'P', 'B', 'S', 'R', 'M', 'A', 'P', '\0'};
+constexpr uint32_t kVersion = 3;  // 2: float weights, 3: provenance
+
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t k_neighbors;
+  uint64_t num_nodes;
+  uint64_t num_edges;
+  RoadmapProvenance provenance;
+};
+static_assert(sizeof(Header) == 64, "roadmap header must stay 64 bytes");
+
+size_t align8(size_t n) { return (n + 7) & ~size_t{7}; }
+
+// Calls fn(i, t) for i in [0, n) on num_threads threads, t being the thread
+// index (the caller is thread 0). Threads claim chunks of 64 indices from a
+// shared counter, so uneven collision-check costs balance out.
+template <class Fn>
+void parallel_chunks(int num_threads, size_t n, Fn&& fn) {
+  constexpr size_t kChunk = 64;
+  const size_t chunks = (n + kChunk - 1) / kChunk;
+  const int threads = static_cast<int>(std::min<size_t>(std::max(num_threads, 1), chunks));
+  if (threads <= 1) {
+    for (size_t i = 0; i < n; ++i) fn(i, 0);
+    return;
+  }
+  std::atomic<size_t> next{0};
+  auto work = [&](int t) {
+    for (size_t c = next++; c < chunks; c = next++)
+      for (size_t i = c * kChunk, e = std::min(n, i + kChunk); i < e; ++i) fn(i, t);
+  };
+  std::vector<std::thread> workers;
+  for (int t = 1; t < threads; ++t) workers.emplace_back(work, t);
+  work(0);
+  for (auto& w : workers) w.join();
+}
+
+// Byte offsets of the arrays for n nodes and m edges; the last is the size.
+struct Layout {
+  size_t xs, ys, offsets, targets, weights, end;
+  Layout(size_t n, size_t m) {
+    xs = sizeof(Header);
+    ys = xs + n * sizeof(double);
+    offsets = ys + n * sizeof(double);
+    targets = offsets + (n + 1) * sizeof(uint64_t);
+    weights = targets + m * sizeof(uint32_t);
+    end = align8(weights + m * sizeof(float));
+  }
+};
+
+// A zeroed roadmap buffer with its header written and typed array views.
+struct Buffer {
+  std::shared_ptr<uint64_t[]> words;
+  size_t bytes;
+  double* xs;
+  double* ys;
+  uint64_t* offsets;
+  uint32_t* targets;
+  float* weights;
+
+  Buffer(size_t n, size_t m, int k_neighbors) {
+    const Layout l(n, m);
+    bytes = l.end;
+    // uint64_t storage keeps every array 8-byte aligned.
+    words.reset(new uint64_t[l.end / 8]());
+    unsigned char* p = reinterpret_cast<unsigned char*>(words.get());
+    Header h{};
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kVersion;
+    h.k_neighbors = static_cast<uint32_t>(k_neighbors);
+    h.num_nodes = n;
+    h.num_edges = m;
+    std::memcpy(p, &h, sizeof(h));
+    xs = reinterpret_cast<double*>(p + l.xs);
+    ys = reinterpret_cast<double*>(p + l.ys);
+    offsets = reinterpret_cast<uint64_t*>(p + l.offsets);
+    targets = reinterpret_cast<uint32_t*>(p + l.targets);
+    weights = reinterpret_cast<float*>(p + l.weights);
+  }
+  std::shared_ptr<const unsigned char> data() const {
+    return std::shared_ptr<const unsigned char>(
+        words, reinterpret_cast<const unsigned char*>(words.get()));
+  }
+};
+
+}  // namespace
+
+bool Roadmap::attach(std::shared_ptr<const unsigned char> data, size_t bytes) {
+  if (bytes < sizeof(Header)) return false;
+  Header h;
+  std::memcpy(&h, data.get(), sizeof(h));
+  if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.version != kVersion) return false;
+  const Layout l(h.num_nodes, h.num_edges);
+  if (l.end != bytes) return false;
+  if (h.num_nodes > UINT32_MAX) return false;
+  const unsigned char* p = data.get();
+  // Files are untrusted: every row must lie inside the edge arrays and
+  // every target must be a node, or queries would read out of bounds.
+  const auto* offsets = reinterpret_cast<const uint64_t*>(p + l.offsets);
+  if (offsets[0] != 0 || offsets[h.num_nodes] != h.num_edges) return false;
+  for (size_t i = 0; i < h.num_nodes; ++i)
+    if (offsets[i] > offsets[i + 1]) return false;
+  const auto* targets = reinterpret_cast<const uint32_t*>(p + l.targets);
+  for (size_t e = 0; e < h.num_edges; ++e)
+    if (targets[e] >= h.num_nodes) return false;
+  xs_ = reinterpret_cast<const double*>(p + l.xs);
+  ys_ = reinterpret_cast<const double*>(p + l.ys);
+  graph_ = CSRGraph(data, static_cast<uint32_t>(h.num_nodes), h.num_edges, offsets, targets,
+                    reinterpret_cast<const float*>(p + l.weights), true);
+  k_neighbors_ = static_cast<int>(h.k_neighbors);
+  provenance_ = h.provenance;
+  data_ = std::move(data);
+  bytes_ = bytes;
+
+  std::vector<Point2D> pts(h.num_nodes);
+  for (size_t i = 0; i < pts.size(); ++i) pts[i] = Point2D(xs_[i], ys_[i]);
+  kdtree_.build(pts);
+  return true;
+}
+
+void sample_valid_points(const IEnvironment& env, ISampler& sampler,
+                         const FreeSpaceSampler* free_space, int n,
+                         std::vector<Point2D>& out, int num_threads) {
+  double x_min = 0, x_max = 0, y_min = 0, y_max = 0;
+  env.get_bounds(x_min, x_max, y_min, y_max);
+  // Blocks come from the one sampler (a single QMC sequence must not be
+  // split into streams); most runs need a single block.
+  const size_t target = static_cast<size_t>(std::max(n, 0));
+  const size_t block = std::max<size_t>(target, 1);
+  const size_t max_attempts = target * 10;
+  std::vector<double> us(block), vs(block), cx(block), cy(block);
+  std::vector<char> valid(block);
+  size_t collected = 0, attempts = 0;
+  while (collected < target && attempts < max_attempts) {
+    sampler.next_block(us.data(), vs.data(), block);
+    parallel_chunks(num_threads, block, [&](size_t i, int) {
+      double x = 0, y = 0;
+      if (free_space) {
+        free_space->map(us[i], vs[i], x, y);
+      } else {
+        x = x_min + us[i] * (x_max - x_min);
+        y = y_min + vs[i] * (y_max - y_min);
+      }
+      cx[i] = x;
+      cy[i] = y;
+      valid[i] = free_space || env.is_valid(State(x, y));
+    });
+    for (size_t i = 0; i < block && collected < target && attempts < max_attempts;
+         ++i, ++attempts)
+      if (valid[i]) {
+        out.push_back(Point2D(cx[i], cy[i]));
+        ++collected;
+      }
+  }
+}
+
+std::shared_ptr<const Roadmap> Roadmap::build(const IEnvironment& env, int num_samples,
+                                              int k_neighbors, ISampler& sampler,
+                                              const FreeSpaceSampler* free_space,
+                                              int num_threads) {
+  using Clock = std::chrono::steady_clock;
+  auto ms_since = [](Clock::time_point t) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t).count();
+  };
+  BuildTimings timings;
+  if (num_threads <= 0)
+    num_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+  timings.threads = num_threads;
+
+  // Sampling: kept in draw order, so the roadmap does not depend on the
+  // thread count.
+  auto t = Clock::now();
+  std::vector<Point2D> points;
+  sample_valid_points(env, sampler, free_space, num_samples, points, num_threads);
+  timings.sample_ms = ms_since(t);
+
+  // Neighbours: each node owns k + 1 candidate slots (its own index among
+  // them is dropped), written without locks.
+  t = Clock::now();
+  const size_t n = points.size();
+  const size_t slots = static_cast<size_t>(std::max(k_neighbors, 0)) + 1;
+  KdTree2D tree;
+  tree.build(points);
+  std::vector<uint32_t> cand(n * slots);
+  std::vector<uint32_t> count(n, 0);
+  parallel_chunks(num_threads, n, [&](size_t i, int) {
+    uint32_t c = 0;
+    for (size_t j : tree.k_nearest(points[i], slots))
+      if (j != i) cand[i * slots + c++] = static_cast<uint32_t>(j);
+    count[i] = c;
+  });
+  timings.knn_ms = ms_since(t);
+
+  // Edges: each thread appends the collision-free ones to its own buffer.
+  t = Clock::now();
+  CSRGraphBuilder builder(static_cast<uint32_t>(n), num_threads);
+  parallel_chunks(num_threads, n, [&](size_t i, int tid) {
+    const State a(points[i].x, points[i].y);
+    for (uint32_t c = 0; c < count[i]; ++c) {
+      const uint32_t j = cand[i * slots + c];
+      if (!env.collision_free(a, State(points[j].x, points[j].y))) continue;
+      builder.add(tid, static_cast<uint32_t>(i), j,
+                  static_cast<float>(std::hypot(points[j].x - points[i].x,
+                                                points[j].y - points[i].y)));
+    }
+  });
+  timings.connect_ms = ms_since(t);
+
+  t = Clock::now();
+  const CSRGraph graph = builder.build(false, true);
+  timings.layout_ms = ms_since(t);
+  return from_graph(points, graph, k_neighbors, timings);
+}
+
+std::shared_ptr<const Roadmap> Roadmap::from_graph(const std::vector<Point2D>& points,
+                                                   const CSRGraph& graph, int k_neighbors,
+                                                   const BuildTimings& timings) {
+  const auto t0 = std::chrono::steady_clock::now();
+  const size_t n = points.size(), m = graph.num_edges();
+  Buffer buf(n, m, k_neighbors);
+  for (size_t i = 0; i < n; ++i) {
+    buf.xs[i] = points[i].x;
+    buf.ys[i] = points[i].y;
+  }
+  std::copy_n(graph.offsets(), n + 1, buf.offsets);
+  std::copy_n(graph.targets(), m, buf.targets);
+  std::copy_n(graph.weights(), m, buf.weights);
+
+  std::shared_ptr<Roadmap> roadmap(new Roadmap());
+  roadmap->attach(buf.data(), buf.bytes);
+  roadmap->timings_ = timings;
+  roadmap->timings_.layout_ms += std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - t0).count();
+  const BuildTimings& bt = roadmap->timings_;
+  roadmap->build_ms_ = bt.sample_ms + bt.knn_ms + bt.connect_ms + bt.layout_ms;
+  return roadmap;
+}
+
+Path Roadmap::query(const IEnvironment& env, const State& start, const State& goal,
+                    size_t k, int* nodes_expanded) const {
+  int expanded = 0;
+  // Nodes 0..n-1 are the roadmap; n is the start and n + 1 the goal.
+  const size_t n = graph_.num_nodes();
+  const size_t start_idx = n, goal_idx = n + 1;
+  k = std::max<size_t>(k, 1);
+
+  std::vector<std::pair<size_t, double>> from_start;
+  std::vector<char> to_goal(n, 0);
+  std::vector<double> to_goal_w(n, 0.0);
+  if (n > 0) {
+    for (size_t j : kdtree_.k_nearest(Point2D(start.x, start.y), k))
+      if (env.collision_free(State(start.x, start.y), State(xs_[j], ys_[j])))
+        from_start.push_back({j, std::hypot(xs_[j] - start.x, ys_[j] - start.y)});
+    for (size_t j : kdtree_.k_nearest(Point2D(goal.x, goal.y), k))
+      if (env.collision_free(State(xs_[j], ys_[j]), State(goal.x, goal.y))) {
+        to_goal[j] = 1;
+        to_goal_w[j] = std::hypot(goal.x - xs_[j], goal.y - ys_[j]);
+      }
+  }
+  const bool direct = env.collision_free(State(start.x, start.y), State(goal.x, goal.y));
+
+  std::vector<double> dist(n + 2, 1e99);
+  std::vector<size_t> parent(n + 2, SIZE_MAX);
+  dist[start_idx] = 0;
+  using PQ = std::priority_queue<std::pair<double, size_t>,
+         std::vector<std::pair<double, size_t>>,
+         std::greater<std::pair<double, size_t>>>;
+  PQ pq;
+  pq.push({0, start_idx});
+  auto relax = [&](size_t u, size_t v, double w) {
+    double nd = dist[u] + w;
+    if (nd < dist[v]) {
+      dist[v] = nd;
+      parent[v] = u;
+      pq.push({nd, v});
+    }
+  };
+
+  while (!pq.empty()) {
+    auto [d, u] = pq.top(); pq.pop();
+    if (d > dist[u]) continue;
+    expanded++;
+    if (u == goal_idx) break;
+    if (u == start_idx) {
+      for (const auto& [v, w] : from_start) relax(u, v, w);
+      if (direct) relax(u, goal_idx, std::hypot(goal.x - start.x, goal.y - start.y));
+      continue;
+    }
+    for (uint64_t e = graph_.begin(u); e < graph_.end(u); ++e)
+      relax(u, graph_.target(e), graph_.weight(e));
+    if (to_goal[u]) relax(u, goal_idx, to_goal_w[u]);
+  }
+  if (nodes_expanded) *nodes_expanded = expanded;
+
+  Path path;
+  if (dist[goal_idx] >= 1e98) {
+    path.success = false;
+    return path;
+  }
+  std::vector<size_t> trace;
+  for (size_t cur = goal_idx; cur != SIZE_MAX; cur = parent[cur])
+    trace.push_back(cur);
+  std::reverse(trace.begin(), trace.end());
+  for (size_t i : trace) {
+    if (i == start_idx) path.states.push_back(State(start.x, start.y));
+    else if (i == goal_idx) path.states.push_back(State(goal.x, goal.y));
+    else path.states.push_back(State(xs_[i], ys_[i]));
+  }
+  path.success = true;
+  path.compute_length();
+  return path;
+}
+
+bool Roadmap::save(const std::string& path, const RoadmapProvenance& provenance) const {
+  // Written aside and renamed into place, so a concurrent load (another
+  // benchmark job, another process) never maps a partial file.
+  const std::string tmp = path + ".tmp" +
+      std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+  {
+    std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+    if (!f) return false;
+    Header h;
+    std::memcpy(&h, data_.get(), sizeof(h));
+    h.provenance = provenance;
+    f.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    f.write(reinterpret_cast<const char*>(data_.get()) + sizeof(h),
+            static_cast<std::streamsize>(bytes_ - sizeof(h)));
+    if (!f) {
+      std::remove(tmp.c_str());
+      return false;
+    }
+  }
+  if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+    std::remove(tmp.c_str());
+    return false;
+  }
+  return true;
+}
+
+std::shared_ptr<const Roadmap> Roadmap::load(const std::string& path,
+                                             const RoadmapProvenance& expected) {
+  std::shared_ptr<Roadmap> roadmap(new Roadmap());
+#if defined(__unix__) || defined(__APPLE__)
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) return nullptr;
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+    ::close(fd);
+    return nullptr;
+  }
+  const size_t bytes = static_cast<size_t>(st.st_size);
+  void* addr = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (addr == MAP_FAILED) return nullptr;
+  std::shared_ptr<const unsigned char> data(
+      static_cast<const unsigned char*>(addr),
+      [bytes](const unsigned char* a) { ::munmap(const_cast<unsigned char*>(a), bytes); });
+  roadmap->mapped_ = true;
+#else
+  std::ifstream f(path, std::ios::binary | std::ios::ate);
+  if (!f) return nullptr;
+  const size_t bytes = static_cast<size_t>(f.tellg());
+  std::shared_ptr<uint64_t[]> words(new uint64_t[(bytes + 7) / 8]());
+  f.seekg(0);
+  if (!f.read(reinterpret_cast<char*>(words.get()), static_cast<std::streamsize>(bytes)))
+    return nullptr;
+  std::shared_ptr<const unsigned char> data(
+      words, reinterpret_cast<const unsigned char*>(words.get()));
+#endif
+  if (!roadmap->attach(std::move(data), bytes)) return nullptr;
+  if (!(roadmap->provenance_ == expected)) return nullptr;
+  return roadmap;
+}
+
+}  // namespace pbs
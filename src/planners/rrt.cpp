@@ -1,17 +1,26 @@
 #include "planners/rrt.hpp"
+#include "planners/rrt_tree.hpp"
+#include "planners/concurrent_rrt_tree.hpp"
 #include "environment/ienvironment.hpp"
 #include "geometry/kdtree2d.hpp"
 #include "geometry/point2d.hpp"
-#include <random>
 #include <cmath>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <thread>
 
 namespace pbs {
 
 RRTPlanner::RRTPlanner(double step_size, double goal_bias, int max_iter)
   : step_size_(step_size), goal_bias_(goal_bias), max_iter_(max_iter) {}
 
+void RRTPlanner::set_steering(std::shared_ptr<const ISteering> steering,
+                              double resolution) {
+  steering_ = std::move(steering);
+  steer_res_ = resolution;
+}
+
 Path RRTPlanner::solve(const IEnvironment& env, const State& start,
                        const State& goal) {
   nodes_expanded_ = 0;
@@ -21,67 +30,95 @@ Path RRTPlanner::solve(const IEnvironment& env, const State& start,
     Path p; p.success = false; return p;
   }
 
-  std::vector<Point2D> tree;
-  tree.push_back(Point2D(start.x, start.y));
-  std::vector<size_t> parent;
-  parent.push_back(0);
+  const ISteering* steer = steering_.get();
+  const int threads = num_threads_ > 0
+      ? num_threads_ : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+  if (threads > 1 && !steer) return solve_parallel(env, start, goal, threads);
+
+  const bool sample_heading = steer && steer->uses_heading();
+  const double res = steer_res_ > 0 ? steer_res_ : step_size_ * 0.25;
 
-  std::mt19937 rng(42);
-  std::uniform_real_distribution<double> u01(0, 1), ux(x_min, x_max), uy(y_min, y_max);
+  RRTTree tree;
+  // Growth beyond this is amortized; a time budget usually comes with a
+  // max_iter far above what the tree reaches.
+  tree.reserve(std::min<size_t>(static_cast<size_t>(max_iter_) + 1, size_t{1} << 16));
+  tree.add(start.x, start.y, start.theta.value_or(0.0), RRTTree::kNone, 0.0);
+  auto node = [&](size_t i) {
+    return steer ? State(tree.x(i), tree.y(i), tree.theta(i)) : State(tree.x(i), tree.y(i));
+  };
+
+  auto sampler = new_sampler();
 
   const double goal_thresh = step_size_ * 1.5;
-  const double goal_dist = std::hypot(goal.x - start.x, goal.y - start.y);
 
-  for (int iter = 0; iter < max_iter_; ++iter) {
-    Point2D sample;
-    if (u01(rng) < goal_bias_) {
-      sample.x = goal.x; sample.y = goal.y;
+  Deadline deadline(time_budget_ms_);
+  for (int iter = 0; iter < max_iter_ && !deadline.expired(); ++iter) {
+    State sample;
+    if (sampler->uniform() < goal_bias_) {
+      sample = State(goal.x, goal.y);
+      sample.theta = goal.theta;
     } else {
-      sample.x = ux(rng); sample.y = uy(rng);
+      double u = 0, v = 0;
+      sampler->next(u, v);
+      sample = State(x_min + u * (x_max - x_min), y_min + v * (y_max - y_min));
+      if (sample_heading) sample.theta = sampler->uniform() * (2 * M_PI);
     }
 
     size_t near_idx = 0;
-    double near_d2 = 1e99;
-    for (size_t i = 0; i < tree.size(); ++i) {
-      double dx = sample.x - tree[i].x, dy = sample.y - tree[i].y;
-      double d2 = dx * dx + dy * dy;
-      if (d2 < near_d2) { near_d2 = d2; near_idx = i; }
+    if (steer) {
+      near_idx = steer->nearest(tree.xs(), tree.ys(), tree.thetas(), tree.size(), sample);
+    } else {
+      const double* xs = tree.xs();
+      const double* ys = tree.ys();
+      double near_d2 = 1e99;
+      for (size_t i = 0; i < tree.size(); ++i) {
+        double dx = sample.x - xs[i], dy = sample.y - ys[i];
+        double d2 = dx * dx + dy * dy;
+        if (d2 < near_d2) { near_d2 = d2; near_idx = i; }
+      }
     }
 
-    double dx = sample.x - tree[near_idx].x, dy = sample.y - tree[near_idx].y;
-    double d = std::sqrt(dx * dx + dy * dy);
-    Point2D new_pt;
-    if (d <= step_size_ || d < 1e-9) {
-      new_pt = sample;
+    State a = node(near_idx);
+    State b;
+    if (steer) {
+      b = steer->extend(a, sample, step_size_);
+      if (!steer->collision_free(env, a, b, res)) continue;
     } else {
-      new_pt.x = tree[near_idx].x + step_size_ * dx / d;
-      new_pt.y = tree[near_idx].y + step_size_ * dy / d;
+      double dx = sample.x - a.x, dy = sample.y - a.y;
+      double d = std::sqrt(dx * dx + dy * dy);
+      if (d <= step_size_ || d < 1e-9) {
+        b = State(sample.x, sample.y);
+      } else {
+        b = State(a.x + step_size_ * dx / d, a.y + step_size_ * dy / d);
+      }
+      if (!env.collision_free(a, b)) continue;
+      if (!env.is_valid(b)) continue;
     }
 
-    State a(tree[near_idx].x, tree[near_idx].y);
-    State b(new_pt.x, new_pt.y);
-    if (!env.collision_free(a, b)) continue;
-
-    if (!env.is_valid(State(new_pt.x, new_pt.y))) continue;
-
-    tree.push_back(new_pt);
-    parent.push_back(near_idx);
+    const size_t new_idx = tree.add(b.x, b.y, b.theta.value_or(0.0), near_idx, 0.0);
     nodes_expanded_ = static_cast<int>(tree.size());
 
-    double to_goal = std::hypot(goal.x - new_pt.x, goal.y - new_pt.y);
+    double to_goal = steer ? steer->distance(b, goal)
+                           : std::hypot(goal.x - b.x, goal.y - b.y);
     if (to_goal < goal_thresh) {
-      State sa(new_pt.x, new_pt.y), sg(goal.x, goal.y);
-      if (env.collision_free(sa, sg)) {
+      bool reached = steer ? steer->collision_free(env, b, goal, res)
+                           : env.collision_free(b, State(goal.x, goal.y));
+      if (reached) {
         Path path;
-        std::vector<size_t> trace;
-        for (size_t cur = tree.size() - 1; ; cur = parent[cur]) {
-          trace.push_back(cur);
-          if (cur == 0) break;
+        std::vector<size_t> trace = tree.path_to_root(new_idx);
+        if (steer) {
+          // Densify curved edges so the path is drivable as returned.
+          path.states.push_back(node(trace[0]));
+          for (size_t k = 1; k <= trace.size(); ++k) {
+            State to = k < trace.size() ? node(trace[k]) : goal;
+            auto seg = steer->interpolate(node(trace[k - 1]), to, res);
+            path.states.insert(path.states.end(), seg.begin() + 1, seg.end());
+          }
+        } else {
+          for (size_t i : trace)
+            path.states.push_back(State(tree.x(i), tree.y(i)));
+          path.states.push_back(State(goal.x, goal.y));
         }
-        std::reverse(trace.begin(), trace.end());
-        for (size_t i : trace)
-          path.states.push_back(State(tree[i].x, tree[i].y));
-        path.states.push_back(State(goal.x, goal.y));
         path.success = true;
         path.compute_length();
         return path;
@@ -94,4 +131,74 @@ Path RRTPlanner::solve(const IEnvironment& env, const State& start,
   return path;
 }
 
+// Workers claim iterations from a shared counter and insert into one
+// ConcurrentRRTTree; the first node that connects to the goal ends the search.
+Path RRTPlanner::solve_parallel(const IEnvironment& env, const State& start,
+                                const State& goal, int threads) {
+  double x_min = 0, x_max = 0, y_min = 0, y_max = 0;
+  env.get_bounds(x_min, x_max, y_min, y_max);
+  ConcurrentRRTTree tree(static_cast<size_t>(max_iter_) + 1, x_min, x_max, y_min, y_max,
+                         step_size_);
+  tree.add(start.x, start.y, ConcurrentRRTTree::kNone, 0.0);
+
+  const double goal_thresh = step_size_ * 1.5;
+  std::atomic<int> iters{0};
+  std::atomic<uint32_t> reached{ConcurrentRRTTree::kNone};
+  const Deadline deadline(time_budget_ms_);
+
+  auto work = [&](int tid) {
+    auto sampler = new_sampler(static_cast<uint64_t>(tid));
+    Deadline dl = deadline;
+    while (reached.load(std::memory_order_relaxed) == ConcurrentRRTTree::kNone &&
+           !dl.expired() && iters.fetch_add(1, std::memory_order_relaxed) < max_iter_) {
+      double sx = goal.x, sy = goal.y;
+      if (sampler->uniform() >= goal_bias_) {
+        double u = 0, v = 0;
+        sampler->next(u, v);
+        sx = x_min + u * (x_max - x_min);
+        sy = y_min + v * (y_max - y_min);
+      }
+
+      const uint32_t near_idx = tree.nearest(sx, sy);
+      State a(tree.x(near_idx), tree.y(near_idx));
+      double dx = sx - a.x, dy = sy - a.y;
+      double d = std::sqrt(dx * dx + dy * dy);
+      // Zero-length edges would break the strict parent < child cost order.
+      if (d < 1e-9) continue;
+      State b = d <= step_size_ ? State(sx, sy)
+                                : State(a.x + step_size_ * dx / d, a.y + step_size_ * dy / d);
+      if (!env.collision_free(a, b)) continue;
+      if (!env.is_valid(b)) continue;
+
+      const uint32_t new_idx =
+          tree.add(b.x, b.y, near_idx, tree.cost(near_idx) + std::min(d, step_size_));
+      if (new_idx == ConcurrentRRTTree::kNone) break;
+
+      if (std::hypot(goal.x - b.x, goal.y - b.y) < goal_thresh &&
+          env.collision_free(b, State(goal.x, goal.y))) {
+        uint32_t expected = ConcurrentRRTTree::kNone;
+        reached.compare_exchange_strong(expected, new_idx);
+      }
+    }
+  };
+  std::vector<std::thread> workers;
+  for (int t = 1; t < threads; ++t) workers.emplace_back(work, t);
+  work(0);
+  for (auto& w : workers) w.join();
+
+  nodes_expanded_ = static_cast<int>(tree.size());
+  Path path;
+  const uint32_t goal_idx = reached.load();
+  if (goal_idx == ConcurrentRRTTree::kNone) {
+    path.success = false;
+    return path;
+  }
+  for (size_t i : tree.path_to_root(goal_idx))
+    path.states.push_back(State(tree.x(i), tree.y(i)));
+  path.states.push_back(State(goal.x, goal.y));
+  path.success = true;
+  path.compute_length();
+  return path;
+}
+
 }  // namespace pbs
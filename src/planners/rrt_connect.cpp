@@ -0,0 +1,112 @@
+#include "planners/rrt_connect.hpp"
+#include "planners/rrt_tree.hpp"
+#include "environment/ienvironment.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace pbs {
+
+namespace {
+
+enum class Extend { Trapped, Advanced, Reached };
+
+size_t nearest(const RRTTree& tree, double x, double y) {
+  const double* xs = tree.xs();
+  const double* ys = tree.ys();
+  size_t best = 0;
+  double best_d2 = 1e99;
+  for (size_t i = 0; i < tree.size(); ++i) {
+    double dx = x - xs[i], dy = y - ys[i];
+    double d2 = dx * dx + dy * dy;
+    if (d2 < best_d2) { best_d2 = d2; best = i; }
+  }
+  return best;
+}
+
+// One step of at most step_size from the node nearest to (x, y) (or from
+// `from` if given). The new node index is written to `added`.
+Extend extend(RRTTree& tree, const IEnvironment& env, double x, double y, double step,
+              size_t from, size_t& added) {
+  State a(tree.x(from), tree.y(from));
+  double dx = x - a.x, dy = y - a.y;
+  double d = std::sqrt(dx * dx + dy * dy);
+  if (d < 1e-9) {
+    added = from;
+    return Extend::Reached;
+  }
+  const bool reaches = d <= step;
+  State b = reaches ? State(x, y) : State(a.x + step * dx / d, a.y + step * dy / d);
+  if (!env.collision_free(a, b) || !env.is_valid(b)) return Extend::Trapped;
+  added = tree.add(b.x, b.y, 0.0, from, tree.cost(from) + std::min(d, step));
+  return reaches ? Extend::Reached : Extend::Advanced;
+}
+
+}  // namespace
+
+RRTConnectPlanner::RRTConnectPlanner(double step_size, double goal_bias, int max_iter)
+  : step_size_(step_size), goal_bias_(goal_bias), max_iter_(max_iter) {}
+
+Path RRTConnectPlanner::solve(const IEnvironment& env, const State& start,
+                              const State& goal) {
+  nodes_expanded_ = 0;
+
+  double x_min = 0, x_max = 0, y_min = 0, y_max = 0;
+  if (!env.get_bounds(x_min, x_max, y_min, y_max)) {
+    Path p; p.success = false; return p;
+  }
+
+  RRTTree trees[2];
+  trees[0].add(start.x, start.y, 0.0, RRTTree::kNone, 0.0);
+  trees[1].add(goal.x, goal.y, 0.0, RRTTree::kNone, 0.0);
+
+  auto sampler = new_sampler();
+
+  int grow = 0;  // Tree extended this iteration; the other one connects.
+  Deadline deadline(time_budget_ms_);
+  for (int iter = 0; iter < max_iter_ && !deadline.expired(); ++iter, grow ^= 1) {
+    RRTTree& ta = trees[grow];
+    RRTTree& tb = trees[grow ^ 1];
+    double sx = tb.x(0), sy = tb.y(0);
+    if (sampler->uniform() >= goal_bias_) {
+      double u = 0, v = 0;
+      sampler->next(u, v);
+      sx = x_min + u * (x_max - x_min);
+      sy = y_min + v * (y_max - y_min);
+    }
+
+    size_t a_new = 0;
+    if (extend(ta, env, sx, sy, step_size_, nearest(ta, sx, sy), a_new) == Extend::Trapped)
+      continue;
+
+    // CONNECT: keep stepping tb towards the new node while it advances.
+    const double tx = ta.x(a_new), ty = ta.y(a_new);
+    size_t b_cur = nearest(tb, tx, ty);
+    Extend e = Extend::Advanced;
+    while (e == Extend::Advanced) e = extend(tb, env, tx, ty, step_size_, b_cur, b_cur);
+    nodes_expanded_ = static_cast<int>(trees[0].size() + trees[1].size());
+    if (e != Extend::Reached) continue;
+
+    // Start-side branch up to the meeting point, then goal-side branch down.
+    const size_t meet_start = grow == 0 ? a_new : b_cur;
+    const size_t meet_goal = grow == 0 ? b_cur : a_new;
+    Path path;
+    for (size_t i : trees[0].path_to_root(meet_start))
+      path.states.push_back(State(trees[0].x(i), trees[0].y(i)));
+    std::vector<size_t> back = trees[1].path_to_root(meet_goal);
+    // The meeting node exists in both trees; keep one copy.
+    for (size_t k = back.size() - 1; k-- > 0;)
+      path.states.push_back(State(trees[1].x(back[k]), trees[1].y(back[k])));
+    path.states.front() = start;
+    path.states.back() = goal;
+    path.success = true;
+    path.compute_length();
+    return path;
+  }
+
+  Path path;
+  path.success = false;
+  return path;
+}
+
+}  // namespace pbs
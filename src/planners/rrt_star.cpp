@@ -1,12 +1,18 @@
 #include "planners/rrt_star.hpp"
+#include "planners/rrt_tree.hpp"
+#include "planners/concurrent_rrt_tree.hpp"
 #include "environment/ienvironment.hpp"
 #include "geometry/kdtree2d.hpp"
 #include "geometry/point2d.hpp"
-#include <random>
 #include <cmath>
 #include <vector>
 #include <algorithm>
 #include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 namespace pbs {
 
@@ -25,117 +31,186 @@ RRTStarPlanner::RRTStarPlanner(double step_size, double goal_bias,
   : step_size_(step_size), goal_bias_(goal_bias),
     max_iter_(max_iter), gamma_(rewiring_radius_factor) {}
 
+void RRTStarPlanner::set_steering(std::shared_ptr<const ISteering> steering,
+                                  double resolution) {
+  steering_ = std::move(steering);
+  steer_res_ = resolution;
+}
+
 Path RRTStarPlanner::solve(const IEnvironment& env, const State& start,
                           const State& goal) {
   nodes_expanded_ = 0;
+  conv_data_ = ConvergenceData{};
 
   double x_min = 0, x_max = 0, y_min = 0, y_max = 0;
   if (!env.get_bounds(x_min, x_max, y_min, y_max)) {
     Path p; p.success = false; return p;
   }
 
-  std::vector<Point2D> tree;
-  tree.push_back(Point2D(start.x, start.y));
-  std::vector<size_t> parent;
-  parent.push_back(0);
-  std::vector<double> cost;
-  cost.push_back(0.0);
+  const ISteering* steer = steering_.get();
+  const int threads = num_threads_ > 0
+      ? num_threads_ : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+  if (threads > 1 && !steer) return solve_parallel(env, start, goal, threads);
+  if (compact_storage_ && !steer) return solve_serial<CompactRRTTree>(env, start, goal);
+  return solve_serial<RRTTree>(env, start, goal);
+}
+
+template <class Tree>
+Path RRTStarPlanner::solve_serial(const IEnvironment& env, const State& start,
+                                  const State& goal) {
+  double x_min = 0, x_max = 0, y_min = 0, y_max = 0;
+  env.get_bounds(x_min, x_max, y_min, y_max);
+  const ISteering* steer = steering_.get();
+  const bool sample_heading = steer && steer->uses_heading();
+  const double res = steer_res_ > 0 ? steer_res_ : step_size_ * 0.25;
+
+  using Real = typename Tree::Scalar;
+  Tree tree;
+  // Growth beyond this is amortized; a time budget usually comes with a
+  // max_iter far above what the tree reaches.
+  tree.reserve(std::min<size_t>(static_cast<size_t>(max_iter_) + 1, size_t{1} << 16));
+  tree.add(start.x, start.y, start.theta.value_or(0.0), Tree::kNone, 0.0);
+  auto node = [&](size_t i) {
+    return steer ? State(tree.x(i), tree.y(i), tree.theta(i)) : State(tree.x(i), tree.y(i));
+  };
+  // Edge check in the planner's metric: straight segment or steering curve.
+  auto edge_free = [&](const State& a, const State& b) {
+    return steer ? steer->collision_free(env, a, b, res) : env.collision_free(a, b);
+  };
 
-  std::mt19937 rng(42);
-  std::uniform_real_distribution<double> u01(0, 1), ux(x_min, x_max), uy(y_min, y_max);
+  auto sampler = new_sampler();
 
   const double goal_thresh = step_size_ * 1.5;
   double best_cost = 1e99;
   size_t best_goal_idx = SIZE_MAX;
+  double best_goal_dist = 0.0;
+  std::vector<size_t> near;
+  std::vector<double> nx, ny, nth, nd_to, nd_from;
 
-  for (int iter = 0; iter < max_iter_; ++iter) {
-    Point2D sample;
-    if (u01(rng) < goal_bias_) {
-      sample.x = goal.x; sample.y = goal.y;
+  Deadline deadline(time_budget_ms_);
+  for (int iter = 0; iter < max_iter_ && !deadline.expired(); ++iter) {
+    State sample;
+    if (sampler->uniform() < goal_bias_) {
+      sample = State(goal.x, goal.y);
+      sample.theta = goal.theta;
     } else {
-      sample.x = ux(rng); sample.y = uy(rng);
+      double u = 0, v = 0;
+      sampler->next(u, v);
+      sample = State(x_min + u * (x_max - x_min), y_min + v * (y_max - y_min));
+      if (sample_heading) sample.theta = sampler->uniform() * (2 * M_PI);
     }
 
+    const Real* xs = tree.xs();
+    const Real* ys = tree.ys();
+    const Real* ths = tree.thetas();
     size_t near_idx = 0;
-    double near_d2 = 1e99;
-    for (size_t i = 0; i < tree.size(); ++i) {
-      double dx = sample.x - tree[i].x, dy = sample.y - tree[i].y;
-      double d2 = dx * dx + dy * dy;
-      if (d2 < near_d2) { near_d2 = d2; near_idx = i; }
+    if constexpr (std::is_same_v<Real, double>) {
+      if (steer) near_idx = steer->nearest(xs, ys, ths, tree.size(), sample);
+    }
+    if (!steer) {
+      // In the tree's precision, so a float tree streams half the bytes.
+      const Real sx = static_cast<Real>(sample.x), sy = static_cast<Real>(sample.y);
+      Real near_d2 = std::numeric_limits<Real>::max();
+      for (size_t i = 0; i < tree.size(); ++i) {
+        Real dx = sx - xs[i], dy = sy - ys[i];
+        Real d2 = dx * dx + dy * dy;
+        if (d2 < near_d2) { near_d2 = d2; near_idx = i; }
+      }
     }
 
-    double dx = sample.x - tree[near_idx].x, dy = sample.y - tree[near_idx].y;
-    double d = std::sqrt(dx * dx + dy * dy);
-    Point2D new_pt;
-    if (d <= step_size_ || d < 1e-9) {
-      new_pt = sample;
+    State a = node(near_idx);
+    State b;
+    if (steer) {
+      b = steer->extend(a, sample, step_size_);
+      if (!steer->collision_free(env, a, b, res)) continue;
     } else {
-      new_pt.x = tree[near_idx].x + step_size_ * dx / d;
-      new_pt.y = tree[near_idx].y + step_size_ * dy / d;
+      double dx = sample.x - xs[near_idx], dy = sample.y - ys[near_idx];
+      double d = std::sqrt(dx * dx + dy * dy);
+      if (d <= step_size_ || d < 1e-9) {
+        b = State(sample.x, sample.y);
+      } else {
+        b = State(xs[near_idx] + step_size_ * dx / d, ys[near_idx] + step_size_ * dy / d);
+      }
+      // Check the node as it will be stored.
+      b = State(static_cast<Real>(b.x), static_cast<Real>(b.y));
+      if (!env.collision_free(a, b)) continue;
+      if (!env.is_valid(b)) continue;
     }
 
-    State a(tree[near_idx].x, tree[near_idx].y);
-    State b(new_pt.x, new_pt.y);
-    if (!env.collision_free(a, b)) continue;
-    if (!env.is_valid(State(new_pt.x, new_pt.y))) continue;
-
-    double seg_cost = std::hypot(new_pt.x - tree[near_idx].x, new_pt.y - tree[near_idx].y);
-    double c_min = cost[near_idx] + seg_cost;
-    size_t best_parent = near_idx;
-
+    // Near set: Euclidean prefilter (a lower bound on any steering length),
+    // then batched steering costs in both directions.
     double r = rrt_star_radius(tree.size(), gamma_, 2, step_size_);
+    near.clear(); nx.clear(); ny.clear(); nth.clear();
+    const Real bx = static_cast<Real>(b.x), by = static_cast<Real>(b.y);
+    const Real r2 = static_cast<Real>(r * r);
     for (size_t i = 0; i < tree.size(); ++i) {
-      double dist = std::hypot(tree[i].x - new_pt.x, tree[i].y - new_pt.y);
-      if (dist > r) continue;
-      State ai(tree[i].x, tree[i].y);
-      if (!env.collision_free(ai, b)) continue;
-      double c = cost[i] + dist;
-      if (c < c_min) {
-        c_min = c;
-        best_parent = i;
-      }
+      const Real dx = xs[i] - bx, dy = ys[i] - by;
+      if (dx * dx + dy * dy > r2) continue;
+      near.push_back(i);
+      nx.push_back(xs[i]); ny.push_back(ys[i]); nth.push_back(ths[i]);
+    }
+    nd_to.resize(near.size());
+    nd_from.resize(near.size());
+    if (steer) {
+      steer->distances_to(nx.data(), ny.data(), nth.data(), near.size(), b, nd_to.data());
+      steer->distances_from(b, nx.data(), ny.data(), nth.data(), near.size(), nd_from.data());
+    } else {
+      for (size_t k = 0; k < near.size(); ++k)
+        nd_to[k] = nd_from[k] = std::hypot(nx[k] - b.x, ny[k] - b.y);
     }
 
-    tree.push_back(new_pt);
-    parent.push_back(best_parent);
-    cost.push_back(c_min);
-
-    for (size_t i = 0; i < tree.size() - 1; ++i) {
-      double dist = std::hypot(tree[i].x - new_pt.x, tree[i].y - new_pt.y);
-      if (dist > r) continue;
-      State ai(tree[i].x, tree[i].y);
-      if (!env.collision_free(ai, b)) continue;
-      double c_new = cost.back() + dist;
-      if (c_new < cost[i]) {
-        parent[i] = tree.size() - 1;
-        cost[i] = c_new;
-        std::vector<size_t> stack = {i};
-        while (!stack.empty()) {
-          size_t u = stack.back(); stack.pop_back();
-          for (size_t j = 0; j < tree.size() - 1; ++j) {
-            if (parent[j] == u) {
-              double d = std::hypot(tree[j].x - tree[u].x, tree[j].y - tree[u].y);
-              cost[j] = cost[u] + d;
-              stack.push_back(j);
-            }
-          }
-        }
-      }
+    double c_min = tree.cost(near_idx) + (steer ? steer->distance(a, b)
+                                           : std::hypot(b.x - xs[near_idx], b.y - ys[near_idx]));
+    size_t best_parent = near_idx;
+    for (size_t k = 0; k < near.size(); ++k) {
+      size_t i = near[k];
+      if (nd_to[k] > r) continue;
+      double c = tree.cost(i) + nd_to[k];
+      if (c >= c_min) continue;
+      if (!edge_free(node(i), b)) continue;
+      c_min = c;
+      best_parent = i;
+    }
+
+    const size_t new_idx = tree.add(b.x, b.y, b.theta.value_or(0.0), best_parent, c_min);
+
+    for (size_t k = 0; k < near.size(); ++k) {
+      size_t i = near[k];
+      if (nd_from[k] > r) continue;
+      double c_new = tree.cost(new_idx) + nd_from[k];
+      if (c_new >= tree.cost(i)) continue;
+      if (!edge_free(b, node(i))) continue;
+      tree.rewire(i, new_idx, c_new);
     }
 
     nodes_expanded_ = static_cast<int>(tree.size());
 
-    double to_goal = std::hypot(goal.x - new_pt.x, goal.y - new_pt.y);
+    double to_goal = steer ? steer->distance(b, goal)
+                           : std::hypot(goal.x - b.x, goal.y - b.y);
     if (to_goal < goal_thresh) {
-      State sa(new_pt.x, new_pt.y), sg(goal.x, goal.y);
-      if (env.collision_free(sa, sg)) {
-        double c_goal = cost.back() + to_goal;
+      if (edge_free(b, steer ? goal : State(goal.x, goal.y))) {
+        double c_goal = tree.cost(new_idx) + to_goal;
         if (c_goal < best_cost) {
           best_cost = c_goal;
-          best_goal_idx = tree.size() - 1;
+          best_goal_idx = new_idx;
+          best_goal_dist = to_goal;
         }
       }
     }
+
+    if (best_goal_idx != SIZE_MAX) {
+      // Rewiring may have lowered the cost of the goal-connected node.
+      best_cost = std::min(best_cost, tree.cost(best_goal_idx) + best_goal_dist);
+      conv_data_.cost_vs_iteration.push_back({iter + 1, best_cost});
+      if (conv_data_.cost_vs_time.empty() || best_cost < conv_data_.cost_vs_time.back().second)
+        conv_data_.cost_vs_time.push_back({deadline.elapsed_ms(), best_cost});
+    }
+  }
+
+  if (best_goal_idx != SIZE_MAX) {
+    conv_data_.final_cost = best_cost;
+    if (optimal_cost_ > 0)
+      conv_data_.gap_to_optimal = best_cost - optimal_cost_;
   }
 
   if (best_goal_idx == SIZE_MAX) {
@@ -145,14 +220,140 @@ Path RRTStarPlanner::solve(const IEnvironment& env, const State& start,
   }
 
   Path path;
-  std::vector<size_t> trace;
-  for (size_t cur = best_goal_idx; ; cur = parent[cur]) {
-    trace.push_back(cur);
-    if (cur == 0) break;
+  std::vector<size_t> trace = tree.path_to_root(best_goal_idx);
+  if (steer) {
+    path.states.push_back(node(trace[0]));
+    for (size_t k = 1; k <= trace.size(); ++k) {
+      State to = k < trace.size() ? node(trace[k]) : goal;
+      auto seg = steer->interpolate(node(trace[k - 1]), to, res);
+      path.states.insert(path.states.end(), seg.begin() + 1, seg.end());
+    }
+  } else {
+    for (size_t i : trace)
+      path.states.push_back(State(tree.x(i), tree.y(i)));
+    path.states.push_back(State(goal.x, goal.y));
+  }
+  path.success = true;
+  path.compute_length();
+  return path;
+}
+
+// Workers share one ConcurrentRRTTree and an iteration counter. Choose-parent
+// and rewiring read costs without locks; each rewire commits under the
+// rewired node's lock (see ConcurrentRRTTree). Goal connections and the
+// convergence curve are recorded under a mutex, which is rarely contended.
+Path RRTStarPlanner::solve_parallel(const IEnvironment& env, const State& start,
+                                    const State& goal, int threads) {
+  double x_min = 0, x_max = 0, y_min = 0, y_max = 0;
+  env.get_bounds(x_min, x_max, y_min, y_max);
+  // The near radius never exceeds 2 * step_size, so a query spans 3x3 cells.
+  ConcurrentRRTTree tree(static_cast<size_t>(max_iter_) + 1, x_min, x_max, y_min, y_max,
+                         step_size_ * 2.0);
+  tree.add(start.x, start.y, ConcurrentRRTTree::kNone, 0.0);
+
+  const double goal_thresh = step_size_ * 1.5;
+  std::atomic<int> iters{0};
+  std::mutex goal_mu;
+  std::vector<std::pair<uint32_t, double>> goal_nodes;  // (node, distance to goal)
+  double best_cost = 1e99;
+  const Deadline deadline(time_budget_ms_);
+
+  auto work = [&](int tid) {
+    auto sampler = new_sampler(static_cast<uint64_t>(tid));
+    Deadline dl = deadline;
+    std::vector<uint32_t> near;
+    while (!dl.expired() && iters.fetch_add(1, std::memory_order_relaxed) < max_iter_) {
+      double sx = goal.x, sy = goal.y;
+      if (sampler->uniform() >= goal_bias_) {
+        double u = 0, v = 0;
+        sampler->next(u, v);
+        sx = x_min + u * (x_max - x_min);
+        sy = y_min + v * (y_max - y_min);
+      }
+
+      const uint32_t near_idx = tree.nearest(sx, sy);
+      State a(tree.x(near_idx), tree.y(near_idx));
+      double dx = sx - a.x, dy = sy - a.y;
+      double d = std::sqrt(dx * dx + dy * dy);
+      // Zero-length edges would break the strict parent < child cost order.
+      if (d < 1e-9) continue;
+      State b = d <= step_size_ ? State(sx, sy)
+                                : State(a.x + step_size_ * dx / d, a.y + step_size_ * dy / d);
+      if (!env.collision_free(a, b)) continue;
+      if (!env.is_valid(b)) continue;
+
+      double r = rrt_star_radius(tree.size(), gamma_, 2, step_size_);
+      near.clear();
+      tree.near(b.x, b.y, r, near);
+      double c_min = tree.cost(near_idx) + std::hypot(b.x - a.x, b.y - a.y);
+      uint32_t best_parent = near_idx;
+      for (uint32_t i : near) {
+        double dist = std::hypot(tree.x(i) - b.x, tree.y(i) - b.y);
+        if (dist < 1e-9) continue;
+        double c = tree.cost(i) + dist;
+        if (c >= c_min) continue;
+        if (!env.collision_free(State(tree.x(i), tree.y(i)), b)) continue;
+        c_min = c;
+        best_parent = i;
+      }
+
+      const uint32_t new_idx = tree.add(b.x, b.y, best_parent, c_min);
+      if (new_idx == ConcurrentRRTTree::kNone) break;
+
+      for (uint32_t i : near) {
+        double dist = std::hypot(tree.x(i) - b.x, tree.y(i) - b.y);
+        if (dist < 1e-9) continue;
+        if (tree.cost(new_idx) + dist >= tree.cost(i)) continue;
+        if (!env.collision_free(b, State(tree.x(i), tree.y(i)))) continue;
+        tree.rewire(i, new_idx, dist);
+      }
+
+      double to_goal = std::hypot(goal.x - b.x, goal.y - b.y);
+      if (to_goal < goal_thresh && env.collision_free(b, State(goal.x, goal.y))) {
+        std::lock_guard<std::mutex> lk(goal_mu);
+        goal_nodes.push_back({new_idx, to_goal});
+        double c = 1e99;
+        for (auto [g, gd] : goal_nodes) c = std::min(c, tree.cost(g) + gd);
+        if (c < best_cost) {
+          best_cost = c;
+          conv_data_.cost_vs_iteration.push_back(
+              {std::min(iters.load(std::memory_order_relaxed), max_iter_), best_cost});
+          conv_data_.cost_vs_time.push_back({deadline.elapsed_ms(), best_cost});
+        }
+      }
+    }
+  };
+  std::vector<std::thread> workers;
+  for (int t = 1; t < threads; ++t) workers.emplace_back(work, t);
+  work(0);
+  for (auto& w : workers) w.join();
+
+  nodes_expanded_ = static_cast<int>(tree.size());
+  Path path;
+  if (goal_nodes.empty()) {
+    path.success = false;
+    return path;
   }
-  std::reverse(trace.begin(), trace.end());
-  for (size_t i : trace)
-    path.states.push_back(State(tree[i].x, tree[i].y));
+  // Stored costs may still be slightly high where a propagation raced a
+  // rewire, so the final choice uses exact path lengths.
+  std::vector<size_t> best_trace;
+  double best_len = 1e99;
+  for (auto [g, gd] : goal_nodes) {
+    std::vector<size_t> trace = tree.path_to_root(g);
+    double len = gd;
+    for (size_t k = 1; k < trace.size(); ++k)
+      len += std::hypot(tree.x(trace[k]) - tree.x(trace[k - 1]),
+                        tree.y(trace[k]) - tree.y(trace[k - 1]));
+    if (len < best_len) { best_len = len; best_trace = std::move(trace); }
+  }
+  if (best_len < best_cost) {
+    conv_data_.cost_vs_iteration.push_back({std::min(iters.load(), max_iter_), best_len});
+    conv_data_.cost_vs_time.push_back({deadline.elapsed_ms(), best_len});
+  }
+  conv_data_.final_cost = best_len;
+  if (optimal_cost_ > 0) conv_data_.gap_to_optimal = best_len - optimal_cost_;
+
+  for (size_t i : best_trace) path.states.push_back(State(tree.x(i), tree.y(i)));
   path.states.push_back(State(goal.x, goal.y));
   path.success = true;
   path.compute_length();
@@ -0,0 +1,155 @@
+#include "planners/rrt_tree.hpp"
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+namespace pbs {
+
+namespace {
+
+constexpr size_t kAlign = 64;
+
+size_t aligned(size_t bytes) { return (bytes + kAlign - 1) / kAlign * kAlign; }
+
+}  // namespace
+
+template <class Real>
+void BasicRRTTree<Real>::ArenaDelete::operator()(unsigned char* p) const {
+  ::operator delete[](p, std::align_val_t{kAlign});
+}
+
+template <class Real>
+size_t BasicRRTTree<Real>::arena_bytes(size_t capacity) {
+  return 4 * aligned(capacity * sizeof(Real)) + 4 * aligned(capacity * sizeof(uint32_t));
+}
+
+template <class Real>
+void BasicRRTTree<Real>::grow(size_t capacity) {
+  std::unique_ptr<unsigned char[], ArenaDelete> arena(
+      static_cast<unsigned char*>(::operator new[](arena_bytes(capacity),
+                                                   std::align_val_t{kAlign})));
+  unsigned char* at = arena.get();
+  auto carve = [&](auto*& array) {
+    using T = std::remove_reference_t<decltype(*array)>;
+    T* fresh = reinterpret_cast<T*>(at);
+    if (size_ > 0) std::memcpy(fresh, array, size_ * sizeof(T));
+    array = fresh;
+    at += aligned(capacity * sizeof(T));
+  };
+  carve(xs_); carve(ys_); carve(ths_); carve(cost_);
+  carve(parent_); carve(first_child_); carve(next_sibling_); carve(prev_sibling_);
+  arena_ = std::move(arena);
+  capacity_ = capacity;
+}
+
+template <class Real>
+void BasicRRTTree<Real>::reserve(size_t n) {
+  if (n > capacity_) grow(n);
+}
+
+template <class Real>
+size_t BasicRRTTree<Real>::add(double x, double y, double theta, size_t parent, double cost) {
+  if (size_ == capacity_) grow(std::max<size_t>(capacity_ * 2, 64));
+  const size_t i = size_++;
+  xs_[i] = static_cast<Real>(x);
+  ys_[i] = static_cast<Real>(y);
+  ths_[i] = static_cast<Real>(theta);
+  cost_[i] = static_cast<Real>(cost);
+  parent_[i] = first_child_[i] = next_sibling_[i] = prev_sibling_[i] = kNone;
+  if (parent != kNone) link(i, parent);
+  return i;
+}
+
+template <class Real>
+void BasicRRTTree<Real>::unlink(size_t i) {
+  const uint32_t p = parent_[i];
+  if (p == kNone) return;
+  const uint32_t prev = prev_sibling_[i], next = next_sibling_[i];
+  if (prev != kNone) next_sibling_[prev] = next;
+  else first_child_[p] = next;
+  if (next != kNone) prev_sibling_[next] = prev;
+  parent_[i] = prev_sibling_[i] = next_sibling_[i] = kNone;
+}
+
+template <class Real>
+void BasicRRTTree<Real>::link(size_t i, size_t parent) {
+  const uint32_t head = first_child_[parent];
+  parent_[i] = static_cast<uint32_t>(parent);
+  next_sibling_[i] = head;
+  prev_sibling_[i] = kNone;
+  if (head != kNone) prev_sibling_[head] = static_cast<uint32_t>(i);
+  first_child_[parent] = static_cast<uint32_t>(i);
+}
+
+template <class Real>
+void BasicRRTTree<Real>::rewire(size_t i, size_t new_parent, double new_cost) {
+  const Real delta = static_cast<Real>(new_cost) - cost_[i];
+  unlink(i);
+  link(i, new_parent);
+  cost_[i] = static_cast<Real>(new_cost);
+  // Descendants keep their edges, so they shift by the same delta.
+  stack_.clear();
+  for (uint32_t c = first_child_[i]; c != kNone; c = next_sibling_[c]) stack_.push_back(c);
+  while (!stack_.empty()) {
+    uint32_t u = stack_.back();
+    stack_.pop_back();
+    cost_[u] += delta;
+    for (uint32_t c = first_child_[u]; c != kNone; c = next_sibling_[c]) stack_.push_back(c);
+  }
+}
+
+template <class Real>
+std::vector<uint32_t> BasicRRTTree<Real>::prune(const std::vector<char>& keep) {
+  const size_t n = size();
+  // A node survives only if it and all its ancestors are kept; parents may
+  // have higher indices after rewiring, so walk down from the roots.
+  std::vector<char> alive(n, 0);
+  stack_.clear();
+  for (size_t i = 0; i < n; ++i)
+    if (parent_[i] == kNone && keep[i]) stack_.push_back(static_cast<uint32_t>(i));
+  while (!stack_.empty()) {
+    uint32_t u = stack_.back();
+    stack_.pop_back();
+    alive[u] = 1;
+    for (uint32_t c = first_child_[u]; c != kNone; c = next_sibling_[c])
+      if (keep[c]) stack_.push_back(c);
+  }
+
+  std::vector<uint32_t> remap(n, kNone);
+  size_t m = 0;
+  for (size_t i = 0; i < n; ++i)
+    if (alive[i]) remap[i] = static_cast<uint32_t>(m++);
+  // Survivors only move towards the front, so copying in place is safe.
+  std::vector<uint32_t> parents(m);
+  for (size_t i = 0; i < n; ++i) {
+    const uint32_t j = remap[i];
+    if (j == kNone) continue;
+    parents[j] = parent_[i] == kNone ? kNone : remap[parent_[i]];
+    xs_[j] = xs_[i];
+    ys_[j] = ys_[i];
+    ths_[j] = ths_[i];
+    cost_[j] = cost_[i];
+  }
+  size_ = m;
+  std::fill_n(parent_, m, kNone);
+  std::fill_n(first_child_, m, kNone);
+  std::fill_n(next_sibling_, m, kNone);
+  std::fill_n(prev_sibling_, m, kNone);
+  for (size_t i = 0; i < m; ++i)
+    if (parents[i] != kNone) link(i, parents[i]);
+  return remap;
+}
+
+template <class Real>
+std::vector<size_t> BasicRRTTree<Real>::path_to_root(size_t i) const {
+  std::vector<size_t> trace;
+  for (size_t cur = i; cur != kNone; cur = parent_[cur]) trace.push_back(cur);
+  std::reverse(trace.begin(), trace.end());
+  return trace;
+}
+
+template class BasicRRTTree<double>;
+template class BasicRRTTree<float>;
+
+}  // namespace pbs
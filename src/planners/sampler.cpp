@@ -0,0 +1,175 @@
+#include "planners/sampler.hpp"
+#include <bit>
+#include <cmath>
+
+namespace pbs {
+
+namespace {
+
+uint64_t splitmix64(uint64_t& x) {
+  uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+double radical_inverse(uint64_t i, uint32_t base) {
+  const double inv = 1.0 / base;
+  double f = inv, r = 0.0;
+  while (i > 0) {
+    r += f * static_cast<double>(i % base);
+    i /= base;
+    f *= inv;
+  }
+  return r;
+}
+
+double wrap(double x) { return x >= 1.0 ? x - 1.0 : x; }
+
+// Sobol direction numbers: dimension 1 is the van der Corput sequence,
+// dimension 2 uses the primitive polynomial x + 1 (v_k = v_{k-1} ^ v_{k-1} >> 1).
+struct SobolDirections {
+  uint32_t u[32], v[32];
+  SobolDirections() {
+    for (int k = 0; k < 32; ++k) u[k] = 1u << (31 - k);
+    v[0] = 1u << 31;
+    for (int k = 1; k < 32; ++k) v[k] = v[k - 1] ^ (v[k - 1] >> 1);
+  }
+};
+const SobolDirections kSobol;
+
+uint32_t reverse_bits(uint32_t x) {
+  x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+  x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+  x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+  x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+  return (x >> 16) | (x << 16);
+}
+
+// Owen scrambling as a hash on the bit-reversed value (Burley 2020): each
+// output bit depends only on higher input bits and the seed.
+uint32_t nested_uniform_scramble(uint32_t x, uint32_t seed) {
+  x = reverse_bits(x);
+  x ^= x * 0x3d20adeau;
+  x += seed;
+  x *= (seed >> 16) | 1u;
+  x ^= x * 0x05526c56u;
+  x ^= x * 0x53a22864u;
+  return reverse_bits(x);
+}
+
+double u32_to_unit(uint32_t x) { return static_cast<double>(x) * 0x1.0p-32; }
+
+}  // namespace
+
+void ISampler::next_block(double* u, double* v, size_t n) {
+  for (size_t i = 0; i < n; ++i) next(u[i], v[i]);
+}
+
+void MersenneSampler::next(double& u, double& v) {
+  u = u01_(rng_);
+  v = u01_(rng_);
+}
+
+XoshiroSampler::XoshiroSampler(uint64_t seed) {
+  for (auto& s : s_) s = splitmix64(seed);
+}
+
+uint64_t XoshiroSampler::next_u64() {
+  const uint64_t result = rotl(s_[1] * 5, 7) * 9;
+  const uint64_t t = s_[1] << 17;
+  s_[2] ^= s_[0];
+  s_[3] ^= s_[1];
+  s_[1] ^= s_[2];
+  s_[0] ^= s_[3];
+  s_[2] ^= t;
+  s_[3] = rotl(s_[3], 45);
+  return result;
+}
+
+void XoshiroSampler::next(double& u, double& v) {
+  u = to_unit(next_u64());
+  v = to_unit(next_u64());
+}
+
+void XoshiroSampler::next_block(double* u, double* v, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    u[i] = to_unit(next_u64());
+    v[i] = to_unit(next_u64());
+  }
+}
+
+HaltonSampler::HaltonSampler(uint64_t seed) : rng_(seed) {
+  shift_u_ = rng_.uniform();
+  shift_v_ = rng_.uniform();
+}
+
+void HaltonSampler::next(double& u, double& v) {
+  u = wrap(radical_inverse(index_, 2) + shift_u_);
+  v = wrap(radical_inverse(index_, 3) + shift_v_);
+  ++index_;
+}
+
+SobolSampler::SobolSampler(uint64_t seed, bool scrambled) : rng_(seed), scrambled_(scrambled) {
+  seed_u_ = static_cast<uint32_t>(rng_.next_u64());
+  seed_v_ = static_cast<uint32_t>(rng_.next_u64());
+}
+
+void SobolSampler::point(uint32_t& a, uint32_t& b) {
+  // Gray-code update: point i differs from point i-1 by one direction number.
+  if (index_ > 0) {
+    const int c = std::countr_zero(index_);
+    x_ ^= kSobol.u[c];
+    y_ ^= kSobol.v[c];
+  }
+  ++index_;
+  if (scrambled_) {
+    a = nested_uniform_scramble(x_, seed_u_);
+    b = nested_uniform_scramble(y_, seed_v_);
+  } else {
+    a = x_ ^ seed_u_;
+    b = y_ ^ seed_v_;
+  }
+}
+
+void SobolSampler::next(double& u, double& v) {
+  uint32_t a = 0, b = 0;
+  point(a, b);
+  u = u32_to_unit(a);
+  v = u32_to_unit(b);
+}
+
+void SobolSampler::next_block(double* u, double* v, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    uint32_t a = 0, b = 0;
+    point(a, b);
+    u[i] = u32_to_unit(a);
+    v[i] = u32_to_unit(b);
+  }
+}
+
+uint64_t stream_seed(uint64_t base, uint64_t stream) {
+  if (stream == 0) return base;
+  uint64_t x = base ^ (stream * 0xD1B54A32D192ED03ULL);
+  return splitmix64(x);
+}
+
+std::unique_ptr<ISampler> make_sampler(const SamplerConfig& config, uint64_t stream) {
+  const uint64_t seed = stream_seed(config.seed, stream);
+  if (config.type == "mt19937") return std::make_unique<MersenneSampler>(seed);
+  if (config.type == "xoshiro") return std::make_unique<XoshiroSampler>(seed);
+  if (config.type == "halton") return std::make_unique<HaltonSampler>(seed);
+  if (config.type == "sobol") return std::make_unique<SobolSampler>(seed, false);
+  if (config.type == "scrambled_sobol") return std::make_unique<SobolSampler>(seed, true);
+  return nullptr;
+}
+
+std::unique_ptr<ISampler> SamplingPlanner::new_sampler(uint64_t stream) const {
+  auto s = make_sampler(sampler_config_, stream);
+  if (!s) s = make_sampler(SamplerConfig{"mt19937", sampler_config_.seed}, stream);
+  return s;
+}
+
+}  // namespace pbs
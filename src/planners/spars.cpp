@@ -0,0 +1,227 @@
+#include "planners/spars.hpp"
+#include "environment/free_space.hpp"
+#include "environment/ienvironment.hpp"
+#include "geometry/point2d.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace pbs {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double ms_since(Clock::time_point t) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - t).count();
+}
+
+// Guards bucketed on a grid of delta-sized cells; a delta query scans 3x3.
+class GuardGrid {
+ public:
+  GuardGrid(double x_min, double y_min, double cell)
+      : x_min_(x_min), y_min_(y_min), cell_(cell) {}
+
+  void insert(uint32_t id, double x, double y) { cells_[key(cx(x), cy(y))].push_back(id); }
+
+  template <class Fn>
+  void for_each_near(double x, double y, Fn&& fn) const {
+    const int64_t gx = cx(x), gy = cy(y);
+    for (int64_t dx = -1; dx <= 1; ++dx)
+      for (int64_t dy = -1; dy <= 1; ++dy) {
+        auto it = cells_.find(key(gx + dx, gy + dy));
+        if (it == cells_.end()) continue;
+        for (uint32_t id : it->second) fn(id);
+      }
+  }
+
+ private:
+  int64_t cx(double x) const { return static_cast<int64_t>(std::floor((x - x_min_) / cell_)); }
+  int64_t cy(double y) const { return static_cast<int64_t>(std::floor((y - y_min_) / cell_)); }
+  static int64_t key(int64_t gx, int64_t gy) { return (gx << 32) ^ (gy & 0xffffffff); }
+
+  double x_min_, y_min_, cell_;
+  std::unordered_map<int64_t, std::vector<uint32_t>> cells_;
+};
+
+// Sparse graph under construction: adjacency, union-find over components,
+// and a bounded Dijkstra with stamped scratch arrays.
+class SparseGraph {
+ public:
+  uint32_t add_node(const Point2D& p) {
+    const auto id = static_cast<uint32_t>(points.size());
+    points.push_back(p);
+    adj.emplace_back();
+    parent_.push_back(id);
+    dist_.push_back(0.0);
+    stamp_.push_back(0);
+    return id;
+  }
+
+  void add_edge(uint32_t a, uint32_t b) {
+    const double w = std::hypot(points[a].x - points[b].x, points[a].y - points[b].y);
+    adj[a].push_back({b, w});
+    adj[b].push_back({a, w});
+    parent_[find(a)] = find(b);
+  }
+
+  uint32_t find(uint32_t a) {
+    while (parent_[a] != a) a = parent_[a] = parent_[parent_[a]];
+    return a;
+  }
+
+  /// Whether the roadmap distance from a to b is at most bound.
+  bool within(uint32_t a, uint32_t b, double bound) {
+    if (find(a) != find(b)) return false;
+    ++epoch_;
+    using Item = std::pair<double, uint32_t>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> pq;
+    visit(a, 0.0);
+    pq.push({0.0, a});
+    while (!pq.empty()) {
+      auto [d, u] = pq.top();
+      pq.pop();
+      if (u == b) return true;
+      if (d > dist_[u]) continue;
+      for (const auto& [v, w] : adj[u]) {
+        const double nd = d + w;
+        if (nd > bound) continue;
+        if (stamp_[v] != epoch_ || nd < dist_[v]) {
+          visit(v, nd);
+          pq.push({nd, v});
+        }
+      }
+    }
+    return false;
+  }
+
+  std::vector<Point2D> points;
+  std::vector<std::vector<std::pair<uint32_t, double>>> adj;
+
+ private:
+  void visit(uint32_t u, double d) {
+    stamp_[u] = epoch_;
+    dist_[u] = d;
+  }
+
+  std::vector<uint32_t> parent_;
+  std::vector<double> dist_;
+  std::vector<uint32_t> stamp_;
+  uint32_t epoch_ = 0;
+};
+
+}  // namespace
+
+SPARSPlanner::SPARSPlanner(int num_samples, double sparse_delta, double stretch,
+                           int max_failures, int k_neighbors)
+  : PRMPlanner(num_samples, k_neighbors), sparse_delta_(sparse_delta),
+    stretch_(std::max(stretch, 1.0)), max_failures_(max_failures) {}
+
+std::string SPARSPlanner::roadmap_key() const {
+  char key[128];
+  std::snprintf(key, sizeof(key), "spars/roadmap/%d/%.9g/%.9g/%d/%d", num_samples_,
+                sparse_delta_, stretch_, max_failures_, k_neighbors_);
+  return key;
+}
+
+std::shared_ptr<const Roadmap> SPARSPlanner::build_roadmap(const IEnvironment& env,
+                                                           ISampler& sampler,
+                                                           const FreeSpaceSampler* free_space) {
+  Roadmap::BuildTimings timings;
+  timings.threads = 1;
+  double x_min = 0, x_max = 0, y_min = 0, y_max = 0;
+  env.get_bounds(x_min, x_max, y_min, y_max);
+  const double delta = sparse_delta_ * std::hypot(x_max - x_min, y_max - y_min);
+
+  SparseGraph g;
+  GuardGrid grid(x_min, y_min, delta > 0 ? delta : 1.0);
+  auto add_guard = [&](const Point2D& p) {
+    const uint32_t id = g.add_node(p);
+    grid.insert(id, p.x, p.y);
+    return id;
+  };
+  auto dist = [&](const Point2D& a, uint32_t b) {
+    return std::hypot(a.x - g.points[b].x, a.y - g.points[b].y);
+  };
+
+  std::vector<std::pair<double, uint32_t>> near;
+  std::vector<uint32_t> visible;
+  int failures = 0;
+  for (int attempt = 0; attempt < num_samples_ && failures < max_failures_; ++attempt) {
+    auto t = Clock::now();
+    double u = 0, v = 0;
+    sampler.next(u, v);
+    Point2D q;
+    if (free_space) {
+      free_space->map(u, v, q.x, q.y);
+    } else {
+      q = Point2D(x_min + u * (x_max - x_min), y_min + v * (y_max - y_min));
+    }
+    const bool valid = free_space || env.is_valid(State(q.x, q.y));
+    timings.sample_ms += ms_since(t);
+    if (!valid) continue;
+
+    t = Clock::now();
+    near.clear();
+    grid.for_each_near(q.x, q.y, [&](uint32_t id) {
+      const double d = dist(q, id);
+      if (d <= delta) near.push_back({d, id});
+    });
+    std::sort(near.begin(), near.end());
+    timings.knn_ms += ms_since(t);
+
+    t = Clock::now();
+    visible.clear();
+    for (const auto& [d, id] : near)
+      if (env.collision_free(State(q.x, q.y), State(g.points[id].x, g.points[id].y)))
+        visible.push_back(id);
+
+    bool added = false;
+    if (visible.empty()) {
+      add_guard(q);  // coverage
+      added = true;
+    }
+    // Connectivity: q sees guards in different components.
+    for (size_t i = 1; !added && i < visible.size(); ++i) {
+      if (g.find(visible[i]) == g.find(visible[0])) continue;
+      const uint32_t id = add_guard(q);
+      g.add_edge(id, visible[0]);
+      g.add_edge(id, visible[i]);
+      added = true;
+    }
+    // Quality: the roadmap path between two guards q sees must be within
+    // stretch of the direct edge (if free) or of the path through q.
+    for (size_t i = 1; !added && i < visible.size(); ++i) {
+      const uint32_t a = visible[0], b = visible[i];
+      const double direct = std::hypot(g.points[a].x - g.points[b].x,
+                                       g.points[a].y - g.points[b].y);
+      if (g.within(a, b, stretch_ * direct)) continue;
+      if (env.collision_free(State(g.points[a].x, g.points[a].y),
+                             State(g.points[b].x, g.points[b].y))) {
+        g.add_edge(a, b);
+        added = true;
+      } else if (!g.within(a, b, stretch_ * (dist(q, a) + dist(q, b)))) {
+        const uint32_t id = add_guard(q);
+        g.add_edge(id, a);
+        g.add_edge(id, b);
+        added = true;
+      }
+    }
+    timings.connect_ms += ms_since(t);
+    failures = added ? 0 : failures + 1;
+  }
+
+  CSRGraphBuilder builder(static_cast<uint32_t>(g.points.size()));
+  for (uint32_t u = 0; u < g.points.size(); ++u)
+    for (const auto& [v, w] : g.adj[u]) builder.add(0, u, v, static_cast<float>(w));
+  return Roadmap::from_graph(g.points, builder.build(false, true), k_neighbors_, timings);
+}
+
+}  // namespace pbs
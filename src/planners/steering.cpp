@@ -0,0 +1,529 @@
+#include "planners/steering.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace pbs {
+
+namespace {
+
+constexpr double kTwoPi = 2 * M_PI;
+constexpr double kZero = 1e-9;
+
+double heading(const State& s) { return s.theta.value_or(0.0); }
+
+double norm_2pi(double a) {
+  a = std::fmod(a, kTwoPi);
+  if (a < 0) a += kTwoPi;
+  return a >= kTwoPi ? 0.0 : a;
+}
+
+// Wraps to (-pi, pi].
+double wrap_pi(double x) {
+  double v = std::fmod(x, kTwoPi);
+  if (v < -M_PI) v += kTwoPi;
+  else if (v > M_PI) v -= kTwoPi;
+  return v;
+}
+
+// Wraps to [0, 2pi).
+double mod2pi(double x) {
+  if (x < 0 && x > -kZero) return 0;
+  double v = x - kTwoPi * std::floor(x / kTwoPi);
+  return (kTwoPi - v < kZero) ? 0 : v;
+}
+
+void polar(double x, double y, double& r, double& theta) {
+  r = std::hypot(x, y);
+  theta = std::atan2(y, x);
+}
+
+enum SegType : char { kNone = 0, kLeft, kStraight, kRight };
+
+// Up to five arcs/lines in units of the turning radius; negative = reverse.
+struct CurvePath {
+  SegType type[5] = {kNone, kNone, kNone, kNone, kNone};
+  double len[5] = {0, 0, 0, 0, 0};
+  double total = std::numeric_limits<double>::infinity();
+
+  CurvePath() = default;
+  CurvePath(const SegType* t, double l0, double l1, double l2,
+            double l3 = 0, double l4 = 0) {
+    const double l[5] = {l0, l1, l2, l3, l4};
+    total = 0;
+    for (int i = 0; i < 5; ++i) {
+      type[i] = t[i];
+      len[i] = t[i] == kNone ? 0 : l[i];
+      total += std::abs(len[i]);
+    }
+  }
+};
+
+// Pose after travelling arc length s (radius units) from the origin frame of a.
+State curve_state_at(const State& a, const CurvePath& p, double s, double rho) {
+  double x = 0, y = 0, phi = heading(a);
+  for (int i = 0; i < 5 && s > 0 && p.type[i] != kNone; ++i) {
+    double v;
+    if (p.len[i] < 0) { v = std::max(-s, p.len[i]); s += v; }
+    else { v = std::min(s, p.len[i]); s -= v; }
+    switch (p.type[i]) {
+      case kLeft:
+        x += std::sin(phi + v) - std::sin(phi);
+        y += -std::cos(phi + v) + std::cos(phi);
+        phi += v;
+        break;
+      case kRight:
+        x += -std::sin(phi - v) + std::sin(phi);
+        y += std::cos(phi - v) - std::cos(phi);
+        phi -= v;
+        break;
+      case kStraight:
+        x += v * std::cos(phi);
+        y += v * std::sin(phi);
+        break;
+      default:
+        break;
+    }
+  }
+  return State(a.x + x * rho, a.y + y * rho, norm_2pi(phi));
+}
+
+State curve_extend(const State& a, const State& b, const CurvePath& p,
+                   double rho, double max_length) {
+  if (p.total * rho <= max_length)
+    return State(b.x, b.y, norm_2pi(heading(b)));
+  return curve_state_at(a, p, max_length / rho, rho);
+}
+
+std::vector<State> curve_interpolate(const State& a, const State& b,
+                                     const CurvePath& p, double rho,
+                                     double resolution) {
+  int steps = std::max(1, static_cast<int>(std::ceil(p.total * rho / resolution)));
+  std::vector<State> out;
+  out.reserve(steps + 1);
+  out.push_back(State(a.x, a.y, norm_2pi(heading(a))));
+  for (int i = 1; i < steps; ++i)
+    out.push_back(curve_state_at(a, p, p.total * i / steps, rho));
+  out.push_back(State(b.x, b.y, norm_2pi(heading(b))));
+  return out;
+}
+
+// Pruned argmin: every curve is at least as long as the straight segment.
+template <class DistFn>
+size_t nearest_with_lower_bound(const double* xs, const double* ys, const double* ths,
+                                size_t n, const State& to, DistFn dist) {
+  std::vector<double> lb(n);
+  size_t seed = 0;
+  for (size_t i = 0; i < n; ++i) {
+    lb[i] = std::hypot(to.x - xs[i], to.y - ys[i]);
+    if (lb[i] < lb[seed]) seed = i;
+  }
+  size_t best = seed;
+  double best_d = dist(State(xs[seed], ys[seed], ths[seed]));
+  for (size_t i = 0; i < n; ++i) {
+    if (i == seed || lb[i] >= best_d) continue;
+    double d = dist(State(xs[i], ys[i], ths[i]));
+    if (d < best_d) { best_d = d; best = i; }
+  }
+  return best;
+}
+
+// ---- Dubins -----------------------------------------------------------------
+
+const SegType kDubinsWords[6][5] = {
+  {kLeft, kStraight, kLeft}, {kRight, kStraight, kRight},
+  {kRight, kStraight, kLeft}, {kLeft, kStraight, kRight},
+  {kRight, kLeft, kRight}, {kLeft, kRight, kLeft},
+};
+
+CurvePath dubins_path(const State& a, const State& b, double rho) {
+  double dx = b.x - a.x, dy = b.y - a.y;
+  double d = std::hypot(dx, dy) / rho;
+  double th = std::atan2(dy, dx);
+  double alpha = mod2pi(heading(a) - th), beta = mod2pi(heading(b) - th);
+  if (d < kZero && std::abs(wrap_pi(alpha - beta)) < kZero)
+    return CurvePath(kDubinsWords[0], 0, d, 0);
+
+  double ca = std::cos(alpha), sa = std::sin(alpha);
+  double cb = std::cos(beta), sb = std::sin(beta);
+  CurvePath best;
+  auto consider = [&best](int w, double t, double p, double q) {
+    CurvePath c(kDubinsWords[w], t, p, q);
+    if (c.total < best.total) best = c;
+  };
+  double tmp = 2. + d * d - 2. * (ca * cb + sa * sb - d * (sa - sb));  // LSL
+  if (tmp >= 0) {
+    double theta = std::atan2(cb - ca, d + sa - sb);
+    consider(0, mod2pi(-alpha + theta), std::sqrt(tmp), mod2pi(beta - theta));
+  }
+  tmp = 2. + d * d - 2. * (ca * cb + sa * sb - d * (sb - sa));  // RSR
+  if (tmp >= 0) {
+    double theta = std::atan2(ca - cb, d - sa + sb);
+    consider(1, mod2pi(alpha - theta), std::sqrt(tmp), mod2pi(-beta + theta));
+  }
+  tmp = d * d - 2. + 2. * (ca * cb + sa * sb - d * (sa + sb));  // RSL
+  if (tmp >= 0) {
+    double p = std::sqrt(tmp);
+    double theta = std::atan2(ca + cb, d - sa - sb) - std::atan2(2., p);
+    consider(2, mod2pi(alpha - theta), p, mod2pi(beta - theta));
+  }
+  tmp = -2. + d * d + 2. * (ca * cb + sa * sb + d * (sa + sb));  // LSR
+  if (tmp >= 0) {
+    double p = std::sqrt(tmp);
+    double theta = std::atan2(-ca - cb, d + sa + sb) - std::atan2(-2., p);
+    consider(3, mod2pi(-alpha + theta), p, mod2pi(-beta + theta));
+  }
+  tmp = .125 * (6. - d * d + 2. * (ca * cb + sa * sb + d * (sa - sb)));  // RLR
+  if (std::abs(tmp) < 1.) {
+    double p = kTwoPi - std::acos(tmp);
+    double theta = std::atan2(ca - cb, d - sa + sb);
+    double t = mod2pi(alpha - theta + .5 * p);
+    consider(4, t, p, mod2pi(alpha - beta - t + p));
+  }
+  tmp = .125 * (6. - d * d + 2. * (ca * cb + sa * sb - d * (sa - sb)));  // LRL
+  if (std::abs(tmp) < 1.) {
+    double p = kTwoPi - std::acos(tmp);
+    double theta = std::atan2(-ca + cb, d + sa - sb);
+    double t = mod2pi(-alpha + theta + .5 * p);
+    consider(5, t, p, mod2pi(beta - alpha - t + p));
+  }
+  return best;
+}
+
+// ---- Reeds-Shepp ------------------------------------------------------------
+// Formula numbers refer to Reeds & Shepp (1990), with the known typo fixes.
+
+const SegType kRSWords[18][5] = {
+  {kLeft, kRight, kLeft, kNone, kNone},         // 0
+  {kRight, kLeft, kRight, kNone, kNone},        // 1
+  {kLeft, kRight, kLeft, kRight, kNone},        // 2
+  {kRight, kLeft, kRight, kLeft, kNone},        // 3
+  {kLeft, kRight, kStraight, kLeft, kNone},     // 4
+  {kRight, kLeft, kStraight, kRight, kNone},    // 5
+  {kLeft, kStraight, kRight, kLeft, kNone},     // 6
+  {kRight, kStraight, kLeft, kRight, kNone},    // 7
+  {kLeft, kRight, kStraight, kRight, kNone},    // 8
+  {kRight, kLeft, kStraight, kLeft, kNone},     // 9
+  {kRight, kStraight, kRight, kLeft, kNone},    // 10
+  {kLeft, kStraight, kLeft, kRight, kNone},     // 11
+  {kLeft, kStraight, kRight, kNone, kNone},     // 12
+  {kRight, kStraight, kLeft, kNone, kNone},     // 13
+  {kLeft, kStraight, kLeft, kNone, kNone},      // 14
+  {kRight, kStraight, kRight, kNone, kNone},    // 15
+  {kLeft, kRight, kStraight, kLeft, kRight},    // 16
+  {kRight, kLeft, kStraight, kRight, kLeft},    // 17
+};
+
+void tau_omega(double u, double v, double xi, double eta, double phi,
+               double& tau, double& omega) {
+  double delta = wrap_pi(u - v);
+  double A = std::sin(u) - std::sin(delta);
+  double B = std::cos(u) - std::cos(delta) - 1.;
+  double t1 = std::atan2(eta * A - xi * B, xi * A + eta * B);
+  double t2 = 2. * (std::cos(delta) - std::cos(v) - std::cos(u)) + 3;
+  tau = (t2 < 0) ? wrap_pi(t1 + M_PI) : wrap_pi(t1);
+  omega = wrap_pi(tau - u + v - phi);
+}
+
+bool LpSpLp(double x, double y, double phi, double& t, double& u, double& v) {  // 8.1
+  polar(x - std::sin(phi), y - 1. + std::cos(phi), u, t);
+  if (t >= -kZero) {
+    v = wrap_pi(phi - t);
+    return v >= -kZero;
+  }
+  return false;
+}
+
+bool LpSpRp(double x, double y, double phi, double& t, double& u, double& v) {  // 8.2
+  double t1, u1;
+  polar(x + std::sin(phi), y - 1. - std::cos(phi), u1, t1);
+  u1 = u1 * u1;
+  if (u1 >= 4.) {
+    u = std::sqrt(u1 - 4.);
+    t = wrap_pi(t1 + std::atan2(2., u));
+    v = wrap_pi(t - phi);
+    return t >= -kZero && v >= -kZero;
+  }
+  return false;
+}
+
+bool LpRmL(double x, double y, double phi, double& t, double& u, double& v) {  // 8.3
+  double xi = x - std::sin(phi), eta = y - 1. + std::cos(phi), u1, theta;
+  polar(xi, eta, u1, theta);
+  if (u1 <= 4.) {
+    u = -2. * std::asin(.25 * u1);
+    t = wrap_pi(theta + .5 * u + M_PI);
+    v = wrap_pi(phi - t + u);
+    return t >= -kZero && u <= kZero;
+  }
+  return false;
+}
+
+bool LpRupLumRm(double x, double y, double phi, double& t, double& u, double& v) {  // 8.7
+  double xi = x + std::sin(phi), eta = y - 1. - std::cos(phi);
+  double rho = .25 * (2. + std::hypot(xi, eta));
+  if (rho <= 1.) {
+    u = std::acos(rho);
+    tau_omega(u, -u, xi, eta, phi, t, v);
+    return t >= -kZero && v <= kZero;
+  }
+  return false;
+}
+
+bool LpRumLumRp(double x, double y, double phi, double& t, double& u, double& v) {  // 8.8
+  double xi = x + std::sin(phi), eta = y - 1. - std::cos(phi);
+  double rho = (20. - xi * xi - eta * eta) / 16.;
+  if (rho >= 0 && rho <= 1) {
+    u = -std::acos(rho);
+    if (u >= -.5 * M_PI) {
+      tau_omega(u, u, xi, eta, phi, t, v);
+      return t >= -kZero && v >= -kZero;
+    }
+  }
+  return false;
+}
+
+bool LpRmSmLm(double x, double y, double phi, double& t, double& u, double& v) {  // 8.9
+  double xi = x - std::sin(phi), eta = y - 1. + std::cos(phi), rho, theta;
+  polar(xi, eta, rho, theta);
+  if (rho >= 2.) {
+    double r = std::sqrt(rho * rho - 4.);
+    u = 2. - r;
+    t = wrap_pi(theta + std::atan2(r, -2.));
+    v = wrap_pi(phi - .5 * M_PI - t);
+    return t >= -kZero && u <= kZero && v <= kZero;
+  }
+  return false;
+}
+
+bool LpRmSmRm(double x, double y, double phi, double& t, double& u, double& v) {  // 8.10
+  double xi = x + std::sin(phi), eta = y - 1. - std::cos(phi), rho, theta;
+  polar(-eta, xi, rho, theta);
+  if (rho >= 2.) {
+    t = theta;
+    u = 2. - rho;
+    v = wrap_pi(t + .5 * M_PI - phi);
+    return t >= -kZero && u <= kZero && v <= kZero;
+  }
+  return false;
+}
+
+bool LpRmSLmRp(double x, double y, double phi, double& t, double& u, double& v) {  // 8.11
+  double xi = x + std::sin(phi), eta = y - 1. - std::cos(phi), rho, theta;
+  polar(xi, eta, rho, theta);
+  if (rho >= 2.) {
+    u = 4. - std::sqrt(rho * rho - 4.);
+    if (u <= kZero) {
+      t = wrap_pi(std::atan2((4. - u) * xi - 2. * eta, -2. * xi + (u - 4.) * eta));
+      v = wrap_pi(t - phi);
+      return t >= -kZero && v >= -kZero;
+    }
+  }
+  return false;
+}
+
+using RSFormula = bool (*)(double, double, double, double&, double&, double&);
+
+// Tries f on the four symmetric variants (identity, time-flip, reflect, both).
+// make(word, sign, t, u, v) builds the candidate; words[0] is used for
+// identity/time-flip and words[1] for the reflected variants.
+template <class Make>
+void try_symmetries(RSFormula f, double x, double y, double phi,
+                    const int words[2], CurvePath& best, Make make) {
+  double t, u, v;
+  const double xs[4] = {x, -x, x, -x};
+  const double ys[4] = {y, y, -y, -y};
+  const double ps[4] = {phi, -phi, -phi, phi};
+  const double sg[4] = {1, -1, 1, -1};
+  for (int k = 0; k < 4; ++k) {
+    if (!f(xs[k], ys[k], ps[k], t, u, v)) continue;
+    CurvePath c = make(words[k / 2], sg[k], t, u, v);
+    if (c.total < best.total) best = c;
+  }
+}
+
+CurvePath reeds_shepp_path(const State& a, const State& b, double rho) {
+  double dx = b.x - a.x, dy = b.y - a.y;
+  double c = std::cos(heading(a)), s = std::sin(heading(a));
+  double x = (c * dx + s * dy) / rho, y = (-s * dx + c * dy) / rho;
+  double phi = heading(b) - heading(a);
+  double xb = x * std::cos(phi) + y * std::sin(phi);
+  double yb = x * std::sin(phi) - y * std::cos(phi);
+  const double h = .5 * M_PI;
+  CurvePath best;
+
+  auto tuv = [](int word, double g, double t, double u, double v) {
+    return CurvePath(kRSWords[word], g * t, g * u, g * v);
+  };
+  // CSC
+  const int lsl[2] = {14, 15}, lsr[2] = {12, 13};
+  try_symmetries(LpSpLp, x, y, phi, lsl, best, tuv);
+  try_symmetries(LpSpRp, x, y, phi, lsr, best, tuv);
+  // CCC, forwards and backwards
+  const int lrl[2] = {0, 1};
+  try_symmetries(LpRmL, x, y, phi, lrl, best, tuv);
+  try_symmetries(LpRmL, xb, yb, phi, lrl, best,
+                 [](int word, double g, double t, double u, double v) {
+                   return CurvePath(kRSWords[word], g * v, g * u, g * t);
+                 });
+  // CCCC
+  const int lrlr[2] = {2, 3};
+  try_symmetries(LpRupLumRm, x, y, phi, lrlr, best,
+                 [](int word, double g, double t, double u, double v) {
+                   return CurvePath(kRSWords[word], g * t, g * u, -g * u, g * v);
+                 });
+  try_symmetries(LpRumLumRp, x, y, phi, lrlr, best,
+                 [](int word, double g, double t, double u, double v) {
+                   return CurvePath(kRSWords[word], g * t, g * u, g * u, g * v);
+                 });
+  // CCSC, forwards and backwards
+  auto ccsc = [h](int word, double g, double t, double u, double v) {
+    return CurvePath(kRSWords[word], g * t, -g * h, g * u, g * v);
+  };
+  auto cscc = [h](int word, double g, double t, double u, double v) {
+    return CurvePath(kRSWords[word], g * v, g * u, -g * h, g * t);
+  };
+  const int lrsl[2] = {4, 5}, lrsr[2] = {8, 9}, lsrl[2] = {6, 7}, rsrl[2] = {10, 11};
+  try_symmetries(LpRmSmLm, x, y, phi, lrsl, best, ccsc);
+  try_symmetries(LpRmSmRm, x, y, phi, lrsr, best, ccsc);
+  try_symmetries(LpRmSmLm, xb, yb, phi, lsrl, best, cscc);
+  try_symmetries(LpRmSmRm, xb, yb, phi, rsrl, best, cscc);
+  // CCSCC
+  const int lrslr[2] = {16, 17};
+  try_symmetries(LpRmSLmRp, x, y, phi, lrslr, best,
+                 [h](int word, double g, double t, double u, double v) {
+                   return CurvePath(kRSWords[word], g * t, -g * h, g * u, -g * h, g * v);
+                 });
+  return best;
+}
+
+}  // namespace
+
+// ---- ISteering --------------------------------------------------------------
+
+void ISteering::distances_to(const double* xs, const double* ys, const double* ths,
+                             size_t n, const State& to, double* out) const {
+  for (size_t i = 0; i < n; ++i)
+    out[i] = distance(State(xs[i], ys[i], ths[i]), to);
+}
+
+void ISteering::distances_from(const State& from, const double* xs, const double* ys,
+                               const double* ths, size_t n, double* out) const {
+  for (size_t i = 0; i < n; ++i)
+    out[i] = distance(from, State(xs[i], ys[i], ths[i]));
+}
+
+size_t ISteering::nearest(const double* xs, const double* ys, const double* ths,
+                          size_t n, const State& to) const {
+  std::vector<double> d(n);
+  distances_to(xs, ys, ths, n, to, d.data());
+  return static_cast<size_t>(std::min_element(d.begin(), d.end()) - d.begin());
+}
+
+bool ISteering::collision_free(const IEnvironment& env, const State& a,
+                               const State& b, double resolution) const {
+  std::vector<State> states = interpolate(a, b, resolution);
+  for (size_t i = 1; i < states.size(); ++i) {
+    if (!env.is_valid(states[i]) || !env.collision_free(states[i - 1], states[i]))
+      return false;
+  }
+  return true;
+}
+
+// ---- StraightLineSteering ---------------------------------------------------
+
+double StraightLineSteering::distance(const State& a, const State& b) const {
+  return std::hypot(b.x - a.x, b.y - a.y);
+}
+
+void StraightLineSteering::distances_to(const double* xs, const double* ys,
+                                        const double* /*ths*/, size_t n,
+                                        const State& to, double* out) const {
+  for (size_t i = 0; i < n; ++i) {
+    double dx = to.x - xs[i], dy = to.y - ys[i];
+    out[i] = std::sqrt(dx * dx + dy * dy);
+  }
+}
+
+State StraightLineSteering::extend(const State& a, const State& b,
+                                   double max_length) const {
+  double d = distance(a, b);
+  State s = b;
+  s.grid_pos.reset();
+  if (d > max_length && d > 1e-9) {
+    s.x = a.x + max_length * (b.x - a.x) / d;
+    s.y = a.y + max_length * (b.y - a.y) / d;
+  }
+  return s;
+}
+
+std::vector<State> StraightLineSteering::interpolate(const State& a, const State& b,
+                                                     double resolution) const {
+  int steps = std::max(1, static_cast<int>(std::ceil(distance(a, b) / resolution)));
+  std::vector<State> out;
+  out.reserve(steps + 1);
+  for (int i = 0; i <= steps; ++i) {
+    double t = static_cast<double>(i) / steps;
+    State s(a.x + t * (b.x - a.x), a.y + t * (b.y - a.y));
+    s.theta = b.theta;
+    out.push_back(s);
+  }
+  return out;
+}
+
+// ---- DubinsSteering ---------------------------------------------------------
+
+DubinsSteering::DubinsSteering(double turning_radius) : rho_(turning_radius) {}
+
+double DubinsSteering::distance(const State& a, const State& b) const {
+  return dubins_path(a, b, rho_).total * rho_;
+}
+
+size_t DubinsSteering::nearest(const double* xs, const double* ys, const double* ths,
+                               size_t n, const State& to) const {
+  return nearest_with_lower_bound(xs, ys, ths, n, to,
+                                  [&](const State& s) { return distance(s, to); });
+}
+
+State DubinsSteering::extend(const State& a, const State& b, double max_length) const {
+  return curve_extend(a, b, dubins_path(a, b, rho_), rho_, max_length);
+}
+
+std::vector<State> DubinsSteering::interpolate(const State& a, const State& b,
+                                               double resolution) const {
+  return curve_interpolate(a, b, dubins_path(a, b, rho_), rho_, resolution);
+}
+
+// ---- ReedsSheppSteering -----------------------------------------------------
+
+ReedsSheppSteering::ReedsSheppSteering(double turning_radius) : rho_(turning_radius) {}
+
+double ReedsSheppSteering::distance(const State& a, const State& b) const {
+  return reeds_shepp_path(a, b, rho_).total * rho_;
+}
+
+size_t ReedsSheppSteering::nearest(const double* xs, const double* ys,
+                                   const double* ths, size_t n, const State& to) const {
+  return nearest_with_lower_bound(xs, ys, ths, n, to,
+                                  [&](const State& s) { return distance(s, to); });
+}
+
+State ReedsSheppSteering::extend(const State& a, const State& b,
+                                 double max_length) const {
+  return curve_extend(a, b, reeds_shepp_path(a, b, rho_), rho_, max_length);
+}
+
+std::vector<State> ReedsSheppSteering::interpolate(const State& a, const State& b,
+                                                   double resolution) const {
+  return curve_interpolate(a, b, reeds_shepp_path(a, b, rho_), rho_, resolution);
+}
+
+std::shared_ptr<ISteering> make_steering(const std::string& name,
+                                         double turning_radius) {
+  if (name == "straight") return std::make_shared<StraightLineSteering>();
+  if (name == "dubins") return std::make_shared<DubinsSteering>(turning_radius);
+  if (name == "reeds_shepp") return std::make_shared<ReedsSheppSteering>(turning_radius);
+  return nullptr;
+}
+
+}  // namespace pbs
@@ -1,5 +1,6 @@
 #include "planners/thetastar.hpp"
 #include "planners/heuristic.hpp"
+#include "environment/environment_decorator.hpp"
 #include "environment/grid_environment.hpp"
 #include <algorithm>
 #include <queue>
@@ -36,7 +37,7 @@ Path ThetaStarPlanner::solve(const IEnvironment& env, const State& start,
                              const State& goal) {
   nodes_expanded_ = 0;
   Path result;
-  const auto* grid = dynamic_cast<const GridEnvironment*>(&env);
+  const auto* grid = env_cast<GridEnvironment>(env);
   if (!grid) {
     result.success = false;
     return result;
@@ -0,0 +1,102 @@
+#include "planners/visibility_graph_planner.hpp"
+#include "environment/environment_decorator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <vector>
+
+namespace pbs {
+
+std::shared_ptr<const VisibilityGraph> VisibilityGraphPlanner::graph_for(
+    const ContinuousEnvironment& env) {
+  return env.preprocessing_cache().get_or_build<VisibilityGraph>("visibility_graph", [&] {
+    double x_min = 0, x_max = 0, y_min = 0, y_max = 0;
+    env.get_bounds(x_min, x_max, y_min, y_max);
+    return std::make_shared<const VisibilityGraph>(env.obstacles(), x_min, x_max, y_min, y_max);
+  });
+}
+
+Path VisibilityGraphPlanner::solve(const IEnvironment& env, const State& start,
+                                   const State& goal) {
+  nodes_expanded_ = 0;
+  Path result;
+  const auto* scene = env_cast<ContinuousEnvironment>(env);
+  if (!scene || !scene->is_valid(start) || !scene->is_valid(goal)) {
+    result.success = false;
+    return result;
+  }
+  auto graph = graph_for(*scene);
+  const size_t n = graph->num_vertices();
+  const size_t s_id = n, g_id = n + 1;
+  const Point2D ps(start.x, start.y), pg(goal.x, goal.y);
+
+  // Start and goal join the graph per query: one sweep each.
+  auto from_start = graph->visible_from(ps, {pg});
+  auto from_goal = graph->visible_from(pg);
+  std::vector<bool> sees_goal(n, false);
+  for (size_t v : from_goal.vertices) sees_goal[v] = true;
+
+  auto pos = [&](size_t u) -> Point2D {
+    return u < n ? graph->vertex(u) : (u == s_id ? ps : pg);
+  };
+  auto h = [&](size_t u) {
+    Point2D q = pos(u);
+    return std::hypot(pg.x - q.x, pg.y - q.y);
+  };
+
+  std::vector<double> g(n + 2, 1e99);
+  std::vector<size_t> parent(n + 2, SIZE_MAX);
+  std::vector<bool> closed(n + 2, false);
+  using Item = std::pair<double, size_t>;
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> open;
+  g[s_id] = 0;
+  open.push({h(s_id), s_id});
+
+  auto relax = [&](size_t u, size_t v, double w) {
+    if (g[u] + w < g[v]) {
+      g[v] = g[u] + w;
+      parent[v] = u;
+      open.push({g[v] + h(v), v});
+    }
+  };
+
+  while (!open.empty()) {
+    size_t u = open.top().second;
+    open.pop();
+    if (closed[u]) continue;
+    closed[u] = true;
+    ++nodes_expanded_;
+    if (u == g_id) break;
+    Point2D pu = pos(u);
+    if (u == s_id) {
+      if (!from_start.extra.empty())
+        relax(u, g_id, std::hypot(pg.x - ps.x, pg.y - ps.y));
+      for (size_t v : from_start.vertices) {
+        Point2D pv = graph->vertex(v);
+        relax(u, v, std::hypot(pv.x - ps.x, pv.y - ps.y));
+      }
+      continue;
+    }
+    for (const auto& [v, w] : graph->neighbors(u)) relax(u, v, w);
+    if (sees_goal[u]) relax(u, g_id, std::hypot(pg.x - pu.x, pg.y - pu.y));
+  }
+
+  if (parent[g_id] == SIZE_MAX) {
+    result.success = false;
+    return result;
+  }
+  std::vector<size_t> trace;
+  for (size_t cur = g_id; cur != SIZE_MAX; cur = parent[cur]) trace.push_back(cur);
+  std::reverse(trace.begin(), trace.end());
+  for (size_t u : trace) {
+    Point2D q = pos(u);
+    result.states.push_back(State(q.x, q.y));
+  }
+  result.states.front() = start;
+  result.states.back() = goal;
+  result.success = true;
+  result.compute_length();
+  return result;
+}
+
+}  // namespace pbs
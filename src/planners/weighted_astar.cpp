@@ -1,5 +1,6 @@
 #include "planners/weighted_astar.hpp"
 #include "planners/heuristic.hpp"
+#include "environment/environment_decorator.hpp"
 #include "environment/grid_environment.hpp"
 #include <algorithm>
 #include <queue>
@@ -33,7 +34,7 @@ Path WeightedAStarPlanner::solve(const IEnvironment& env, const State& start,
                                  const State& goal) {
   nodes_expanded_ = 0;
   Path result;
-  const auto* grid = dynamic_cast<const GridEnvironment*>(&env);
+  const auto* grid = env_cast<GridEnvironment>(env);
   if (!grid) {
     result.success = false;
     return result;
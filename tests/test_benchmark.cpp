@@ -1,9 +1,26 @@
 #include <gtest/gtest.h>
 #include "benchmark/benchmark_engine.hpp"
+#include "benchmark/environment_cache.hpp"
+#include "benchmark/perf_counters.hpp"
 #include "benchmark/statistics.hpp"
+#include "benchmark/task_scheduler.hpp"
+#include "benchmark/timing.hpp"
+#include "environment/grid_environment.hpp"
 #include "metrics/metrics_collector.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#if defined(__linux__)
+#include <sched.h>
+#endif
 
 namespace {
 
@@ -45,4 +62,302 @@ TEST(BenchmarkTest, RunFromConfig) {
   EXPECT_TRUE(content.find("astar") != std::string::npos);
 }
 
+TEST(BenchmarkTest, SpeedupCurveForParallelPlanners) {
+  const char* config = R"({
+    "version": 1,
+    "experiments": [{
+      "environment": {"type":"continuous","bounds":{"x_min":0,"x_max":20,"y_min":0,"y_max":20},
+        "obstacles": []},
+      "planner": "rrt_star",
+      "planner_params": {"step_size": 1.0, "max_iter": 300, "num_threads": 3},
+      "start": [1, 1],
+      "goal": [19, 19],
+      "repeats": 2
+    }]
+  })";
+  std::ofstream f("/tmp/test_bench_speedup.json");
+  f << config;
+  f.close();
+
+  pbs::BenchmarkEngine engine;
+  engine.run("/tmp/test_bench_speedup.json");
+
+  std::ifstream rf("/tmp/test_bench_speedup_results.json");
+  ASSERT_TRUE(rf.good());
+  auto j = nlohmann::json::parse(rf);
+  const auto& curve = j["results"][0]["speedup"];
+  ASSERT_EQ(curve.size(), 3u);
+  EXPECT_EQ(curve[0]["threads"], 1);
+  EXPECT_EQ(curve[1]["threads"], 2);
+  EXPECT_EQ(curve[2]["threads"], 3);
+  EXPECT_DOUBLE_EQ(curve[0]["speedup"].get<double>(), 1.0);
+}
+
+TEST(BenchmarkTest, PRMBuildsOneRoadmapPerEntry) {
+  nlohmann::json config = {
+      {"version", 1},
+      {"experiments",
+       {{{"environment", {{"type", "grid"}, {"width", 40}, {"height", 40},
+                          {"obstacle_density", 0.1}, {"seed", 3}}},
+         {"planner", "prm"}, {"planner_params", {{"num_samples", 200}}},
+         {"start", {0, 0}}, {"goal", {39, 39}}, {"repeats", 5}}}}};
+  std::ofstream("/tmp/test_bench_prm_once.json") << config.dump();
+
+  pbs::BenchmarkEngine engine;
+  engine.run("/tmp/test_bench_prm_once.json");
+  std::ifstream rf("/tmp/test_bench_prm_once_results.json");
+  ASSERT_TRUE(rf.good());
+  auto j = nlohmann::json::parse(rf);
+  ASSERT_EQ(j["results"].size(), 1u);
+  EXPECT_EQ(j["results"][0]["roadmap_builds"], 1);
+}
+
+TEST(TaskSchedulerTest, RunsEveryTaskOnceAndStealsWork) {
+  pbs::TaskScheduler scheduler(4);
+  std::vector<std::atomic<int>> runs(200);
+  std::vector<int> worker_of(200, -1);
+  scheduler.run(runs.size(), [&](size_t t, int w) {
+    // Worker 0's share is slow, so the others must steal from it.
+    if (t % 4 == 0) std::this_thread::sleep_for(std::chrono::microseconds(200));
+    ++runs[t];
+    worker_of[t] = w;
+  });
+  for (auto& r : runs) EXPECT_EQ(r.load(), 1);
+  int stolen = 0;
+  for (size_t t = 0; t < worker_of.size(); t += 4) stolen += worker_of[t] != 0;
+  EXPECT_GT(stolen, 0);
+
+  EXPECT_THROW(scheduler.run(10, [](size_t t, int) {
+    if (t == 3) throw std::runtime_error("task failed");
+  }), std::runtime_error);
+}
+
+TEST(TaskSchedulerTest, PinsOnlyPinnableTasksAndRestoresTheCaller) {
+#if defined(__linux__)
+  auto allowed = [] {
+    cpu_set_t set;
+    sched_getaffinity(0, sizeof(set), &set);
+    return CPU_COUNT(&set);
+  };
+  const int before = allowed();
+  int pinned_count = before;
+  {
+    pbs::ScopedAffinity probe(0);
+    if (probe.core() >= 0) pinned_count = 1;
+  }
+  std::vector<int> seen(2, -1);
+  pbs::TaskScheduler(1, true).run(
+      seen.size(), [&](size_t t, int) { seen[t] = allowed(); },
+      [](size_t t) { return t == 0; });
+  EXPECT_EQ(seen[0], pinned_count);
+  EXPECT_EQ(seen[1], before);
+  EXPECT_EQ(allowed(), before);
+#else
+  GTEST_SKIP() << "pinning is Linux only";
+#endif
+}
+
+TEST(BenchmarkTest, ParallelJobsKeepConfigOrder) {
+  nlohmann::json config = {{"version", 1}, {"experiments", nlohmann::json::array()}};
+  const char* planners[] = {"astar", "dijkstra", "rrt", "thetastar", "prm", "weighted_astar"};
+  for (const char* p : planners)
+    config["experiments"].push_back(
+        {{"environment", {{"type", "grid"}, {"width", 20}, {"height", 20},
+                          {"generator", "random_uniform"}, {"obstacle_density", 0.1},
+                          {"seed", 7}}},
+         {"planner", p}, {"start", {0, 0}}, {"goal", {19, 19}}, {"repeats", 2}});
+  std::ofstream("/tmp/test_bench_jobs.json") << config.dump();
+
+  pbs::BenchmarkEngine engine;
+  engine.set_jobs(3);
+  engine.run("/tmp/test_bench_jobs.json");
+  std::ifstream rf("/tmp/test_bench_jobs_results.json");
+  ASSERT_TRUE(rf.good());
+  auto j = nlohmann::json::parse(rf);
+  ASSERT_EQ(j["results"].size(), std::size(planners));
+  for (size_t i = 0; i < std::size(planners); ++i)
+    EXPECT_EQ(j["results"][i]["planner"], planners[i]);
+}
+
+TEST(BenchmarkTest, SharedEnvironmentIsGeneratedOnce) {
+  nlohmann::json grid = {{"type", "grid"}, {"width", 20}, {"height", 20},
+                         {"obstacle_density", 0.1}, {"seed", 7}};
+  // Same map with keys reordered and a default spelled out.
+  nlohmann::json same = {{"seed", 7}, {"generator", "random_uniform"},
+                         {"obstacle_density", 0.1}, {"height", 20}, {"width", 20}};
+  nlohmann::json other = grid;
+  other["seed"] = 8;
+  nlohmann::json config = {{"version", 1}, {"experiments", nlohmann::json::array()}};
+  for (const auto& env : {grid, same, other})
+    config["experiments"].push_back({{"environment", env}, {"planner", "astar"},
+                                     {"start", {0, 0}}, {"goal", {19, 19}}, {"repeats", 1}});
+  std::ofstream("/tmp/test_bench_env_cache.json") << config.dump();
+
+  pbs::BenchmarkEngine engine;
+  engine.run("/tmp/test_bench_env_cache.json");
+  std::ifstream rf("/tmp/test_bench_env_cache_results.json");
+  ASSERT_TRUE(rf.good());
+  auto j = nlohmann::json::parse(rf);
+  ASSERT_EQ(j["results"].size(), 3u);
+  EXPECT_FALSE(j["results"][0]["env_cache_hit"].get<bool>());
+  EXPECT_TRUE(j["results"][1]["env_cache_hit"].get<bool>());
+  EXPECT_EQ(j["results"][1]["env_generation_ms"].get<double>(), 0.0);
+  EXPECT_FALSE(j["results"][2]["env_cache_hit"].get<bool>());
+  EXPECT_EQ(j["results"][0]["mean_path_length"], j["results"][1]["mean_path_length"]);
+  EXPECT_EQ(j["environment_cache"]["environments"], 2);
+  EXPECT_EQ(j["environment_cache"]["hits"], 1);
+}
+
+TEST(EnvironmentCacheTest, ConcurrentLookupsGenerateOnce) {
+  pbs::EnvironmentCache cache;
+  std::atomic<int> generated{0};
+  std::vector<std::shared_ptr<const pbs::IEnvironment>> envs(16);
+  pbs::TaskScheduler(4).run(envs.size(), [&](size_t i, int) {
+    envs[i] = cache.get_or_generate("grid/" + std::to_string(i % 2), [&] {
+      ++generated;
+      return std::make_shared<pbs::GridEnvironment>(10, 10);
+    }).env;
+  });
+  EXPECT_EQ(generated.load(), 2);
+  EXPECT_EQ(cache.size(), 2u);
+  EXPECT_EQ(cache.hits(), 14u);
+  for (size_t i = 2; i < envs.size(); ++i) EXPECT_EQ(envs[i], envs[i % 2]);
+}
+
+
+TEST(StatisticsTest, MedianAndMad) {
+  std::vector<double> v = {5, 1, 3, 100, 2, 4};
+  EXPECT_NEAR(pbs::median(v), 3.5, 1e-12);
+  EXPECT_NEAR(pbs::median_abs_deviation(v), 1.5, 1e-12);
+  EXPECT_EQ(pbs::median({}), 0.0);
+}
+
+TEST(TimingTest, TimersMeasureSleepAfterCalibration) {
+  for (auto source : {pbs::TimerSource::SteadyClock, pbs::TimerSource::Tsc}) {
+    pbs::SolveTimer timer(source);
+    EXPECT_GE(timer.overhead_ns(), 0.0);
+    EXPECT_LT(timer.overhead_ns(), 10000.0);
+    timer.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    const double ms = timer.stop_ms();
+    EXPECT_GE(ms, 19.0);
+    EXPECT_LT(ms, 500.0);
+  }
+}
+
+TEST(BenchmarkTest, TimingModeIsRecorded) {
+  nlohmann::json config = {
+      {"version", 1},
+      {"experiments",
+       {{{"environment", {{"type", "grid"}, {"width", 20}, {"height", 20},
+                          {"obstacle_density", 0.1}, {"seed", 7}}},
+         {"planner", "astar"}, {"start", {0, 0}}, {"goal", {19, 19}}, {"repeats", 3},
+         {"timing", {{"warmup", 2}, {"timer", "tsc"}, {"cache", "cold"},
+                     {"flush_bytes", 1 << 20}, {"pin_core", 0}}}}}}};
+  std::ofstream("/tmp/test_bench_timing.json") << config.dump();
+  int expected_core = -1;
+  {
+    pbs::ScopedAffinity probe(0);
+    expected_core = probe.core();
+  }
+
+  pbs::BenchmarkEngine engine;
+  engine.run("/tmp/test_bench_timing.json");
+  std::ifstream rf("/tmp/test_bench_timing_results.json");
+  ASSERT_TRUE(rf.good());
+  auto j = nlohmann::json::parse(rf);
+  ASSERT_EQ(j["results"].size(), 1u);
+  const auto& r = j["results"][0];
+  EXPECT_EQ(r["timing"]["timer"],
+            pbs::to_string(pbs::SolveTimer(pbs::TimerSource::Tsc).source()));
+  EXPECT_EQ(r["timing"]["pinned_core"], expected_core);
+  EXPECT_EQ(r["timing"]["pinned_cores"], expected_core < 0 ? 0 : 1);
+  EXPECT_EQ(r["timing"]["warmup"], 2);
+  EXPECT_EQ(r["timing"]["cache"], "cold");
+  EXPECT_EQ(r["timing"]["flush_bytes"], 1 << 20);
+  EXPECT_TRUE(r["timing"].contains("timer_overhead_ns"));
+  EXPECT_TRUE(r.contains("median_time_ms"));
+  EXPECT_TRUE(r.contains("mad_time_ms"));
+  EXPECT_DOUBLE_EQ(r["success_rate"].get<double>(), 1.0);
+}
+
+TEST(BenchmarkTest, ParallelEntryIsNotSqueezedOntoOneCore) {
+  // One more thread than there are cores: no mask can give each its own.
+  const int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency())) + 1;
+  nlohmann::json config = {
+      {"version", 1},
+      {"experiments",
+       {{{"environment", {{"type", "grid"}, {"width", 20}, {"height", 20},
+                          {"obstacle_density", 0.1}, {"seed", 7}}},
+         {"planner", "prm"},
+         {"planner_params", {{"num_samples", 100}, {"num_threads", threads}}},
+         {"start", {0, 0}}, {"goal", {19, 19}}, {"repeats", 2},
+         {"timing", {{"pin_core", 0}}}}}}};
+  std::ofstream("/tmp/test_bench_pin_parallel.json") << config.dump();
+
+  pbs::BenchmarkEngine engine;
+  engine.run("/tmp/test_bench_pin_parallel.json");
+  std::ifstream rf("/tmp/test_bench_pin_parallel_results.json");
+  ASSERT_TRUE(rf.good());
+  auto j = nlohmann::json::parse(rf);
+  ASSERT_EQ(j["results"].size(), 1u);
+  const auto& timing = j["results"][0]["timing"];
+  EXPECT_EQ(timing["pinned_core"], -1);
+  EXPECT_EQ(timing["pinned_cores"], 0);
+  EXPECT_EQ(j["results"][0]["num_threads"], threads);
+}
+
+TEST(PerfCountersTest, CountsOrReportsWhyNot) {
+  pbs::PerfCounters perf;
+  perf.start();
+  volatile double x = 0;
+  for (int i = 0; i < 100000; ++i) x = x + i * 0.5;
+  const pbs::PerfSample sample = perf.stop();
+  if (!perf.available()) {
+    EXPECT_FALSE(perf.error().empty());
+    for (bool v : sample.valid) {
+      EXPECT_FALSE(v);
+    }
+    GTEST_SKIP() << "perf counters unavailable: " << perf.error();
+  }
+  for (size_t e = 0; e < pbs::kNumPerfEvents; ++e) {
+    EXPECT_EQ(sample.valid[e], perf.has(static_cast<pbs::PerfEvent>(e)));
+  }
+  if (sample.has(pbs::PerfEvent::Instructions)) {
+    EXPECT_GT(sample[pbs::PerfEvent::Instructions], 100000.0);
+  }
+}
+
+TEST(BenchmarkTest, PerfCountersInJsonAndCsv) {
+  nlohmann::json config = {
+      {"version", 1},
+      {"experiments",
+       {{{"environment", {{"type", "grid"}, {"width", 20}, {"height", 20},
+                          {"obstacle_density", 0.1}, {"seed", 7}}},
+         {"planner", "astar"}, {"start", {0, 0}}, {"goal", {19, 19}}, {"repeats", 3},
+         {"perf_counters", true}}}}};
+  std::ofstream("/tmp/test_bench_perf.json") << config.dump();
+
+  pbs::BenchmarkEngine engine;
+  engine.run("/tmp/test_bench_perf.json");
+  std::ifstream rf("/tmp/test_bench_perf_results.json");
+  ASSERT_TRUE(rf.good());
+  auto j = nlohmann::json::parse(rf);
+  ASSERT_EQ(j["results"].size(), 1u);
+  const auto& perf = j["results"][0]["perf"];
+  ASSERT_TRUE(perf.contains("available"));
+  if (perf["available"].get<bool>()) {
+    EXPECT_FALSE(perf.contains("error"));
+  } else {
+    EXPECT_TRUE(perf.contains("error"));
+  }
+
+  std::ifstream cf("/tmp/test_bench_perf_results.csv");
+  std::string header;
+  std::getline(cf, header);
+  EXPECT_NE(header.find(",mean_cycles,mean_instructions,mean_l1d_misses,"
+                        "mean_llc_misses,mean_branch_misses"),
+            std::string::npos);
+}
+
 }  // namespace
@@ -4,6 +4,18 @@
 #include "geometry/point2d.hpp"
 #include "environment/continuous_environment.hpp"
 #include "environment/se2_environment.hpp"
+#include "environment/cached_environment.hpp"
+#include "environment/grid_environment.hpp"
+#include "environment/preprocessing_cache.hpp"
+#include "environment/rasterizer.hpp"
+#include "environment/free_space.hpp"
+#include "planners/astar.hpp"
+#include "planners/path_postprocessor.hpp"
+#include "planners/rrt.hpp"
+#include "metrics/metrics_collector.hpp"
+#include <atomic>
+#include <random>
+#include <thread>
 
 namespace {
 
@@ -64,4 +76,247 @@ TEST(SE2EnvTest, BasicValidation) {
   EXPECT_TRUE(env.is_valid(s));
 }
 
+TEST(SE2EnvTest, RectangleFootprintRespectsHeading) {
+  // Horizontal corridor 2 units high between two walls.
+  std::vector<pbs::Point2D> low = {{0,0},{20,0},{20,4},{0,4}};
+  std::vector<pbs::Point2D> high = {{0,6},{20,6},{20,10},{0,10}};
+  auto base = std::make_shared<pbs::ContinuousEnvironment>(
+      0, 20, 0, 10, std::vector<pbs::Polygon>{pbs::Polygon(low), pbs::Polygon(high)});
+  pbs::Polygon car({{-1.5,-0.5},{1.5,-0.5},{1.5,0.5},{-1.5,0.5}});
+  pbs::SE2Environment env(base, car, 72);
+  EXPECT_TRUE(env.has_footprint());
+  EXPECT_NEAR(env.sweep_resolution(), 0.5, 1e-9);
+  EXPECT_TRUE(env.is_valid(pbs::State(10, 5, 0.0)));
+  EXPECT_FALSE(env.is_valid(pbs::State(10, 5, M_PI / 2)));  // 3 units tall now
+  EXPECT_TRUE(env.collision_free(pbs::State(3, 5, 0.0), pbs::State(17, 5, 0.0)));
+  EXPECT_FALSE(env.collision_free(pbs::State(10, 5, 0.0), pbs::State(10, 5, M_PI / 2)));
+}
+
+TEST(SE2EnvTest, HeadingSnapStaysConservative) {
+  // At 2.4 degrees the car's top edge reaches y = 5.55 under the box, but
+  // the nearest of 72 headings is 0, where the top edge is at y = 5.5.
+  std::vector<pbs::Point2D> box = {{6.3,5.55},{6.45,5.55},{6.45,6},{6.3,6}};
+  auto base = std::make_shared<pbs::ContinuousEnvironment>(
+      0, 10, 0, 10, std::vector<pbs::Polygon>{pbs::Polygon(box)});
+  pbs::Polygon car({{-1.5,-0.5},{1.5,-0.5},{1.5,0.5},{-1.5,0.5}});
+  pbs::SE2Environment env(base, car, 72);
+  EXPECT_NEAR(env.heading_margin(), 2 * std::hypot(1.5, 0.5) * std::sin(M_PI / 144), 1e-12);
+  EXPECT_FALSE(env.is_valid(pbs::State(5, 5, 2.4 * M_PI / 180)));
+  EXPECT_TRUE(env.is_valid(pbs::State(5, 4.9, 0.0)));
+}
+
+TEST(SE2EnvTest, NonConvexObstacleIsTriangulated) {
+  // L-shaped obstacle; the notch at (7,7) is free for a small robot.
+  std::vector<pbs::Point2D> ell = {{4,4},{9,4},{9,6},{6,6},{6,9},{4,9}};
+  auto base = std::make_shared<pbs::ContinuousEnvironment>(
+      0, 10, 0, 10, std::vector<pbs::Polygon>{pbs::Polygon(ell)});
+  pbs::Polygon box({{-0.4,-0.4},{0.4,-0.4},{0.4,0.4},{-0.4,0.4}});
+  pbs::SE2Environment env(base, box, 16);
+  EXPECT_TRUE(env.is_valid(pbs::State(7.5, 7.5, 0.0)));
+  EXPECT_FALSE(env.is_valid(pbs::State(5, 5, 0.0)));
+  EXPECT_FALSE(env.is_valid(pbs::State(6.2, 7.5, 0.0)));  // Overlaps the vertical arm
+}
+
+TEST(SE2EnvTest, SelfIntersectingObstacleIsCovered) {
+  // Ear clipping stops short on this self-intersecting outline; whatever it
+  // cannot split must still block poses, e.g. in the sliver around (5, 2.8).
+  pbs::Polygon knot({{3,5},{3,3},{7,4},{0,6},{8,1},{2,4},{1,5}});
+  const auto pieces = knot.triangulate();
+  for (double x = 0.013; x < 8; x += 0.1)
+    for (double y = 0.007; y < 7; y += 0.1) {
+      if (!knot.contains({x, y})) continue;
+      bool covered = false;
+      for (const auto& piece : pieces) covered = covered || piece.contains({x, y});
+      EXPECT_TRUE(covered) << x << ", " << y;
+    }
+
+  auto base = std::make_shared<pbs::ContinuousEnvironment>(
+      0, 10, 0, 10, std::vector<pbs::Polygon>{knot});
+  pbs::Polygon box({{-0.05,-0.05},{0.05,-0.05},{0.05,0.05},{-0.05,0.05}});
+  pbs::SE2Environment env(base, box, 16);
+  ASSERT_FALSE(base->is_valid(pbs::State(5.0, 2.8)));
+  EXPECT_FALSE(env.is_valid(pbs::State(5, 2.8, 0.0)));
+}
+
+TEST(CollisionCacheTest, StoresFreeAndBlockedResults) {
+  std::vector<pbs::Point2D> sq = {{4,4},{6,4},{6,6},{4,6}};
+  auto base = std::make_shared<pbs::ContinuousEnvironment>(
+      0, 10, 0, 10, std::vector<pbs::Polygon>{pbs::Polygon(sq)});
+  pbs::CachedEnvironment env(base, 64);
+  pbs::State a(1, 5), b(9, 5), c(1, 1);
+  EXPECT_FALSE(env.collision_free(a, b));
+  EXPECT_TRUE(env.collision_free(a, c));
+  EXPECT_FALSE(env.collision_free(b, a));  // Reverse direction hits the same entry
+  EXPECT_TRUE(env.collision_free(a, c));
+  auto st = env.stats();
+  EXPECT_EQ(st.misses, 2u);
+  EXPECT_EQ(st.hits, 2u);
+  EXPECT_NEAR(st.hit_rate(), 0.5, 1e-9);
+  EXPECT_EQ(env.memory_bytes(), 64u * sizeof(uint64_t));
+}
+
+TEST(CollisionCacheTest, GridPlannerSeesThroughDecorator) {
+  auto grid = std::make_shared<pbs::GridEnvironment>(10, 10);
+  pbs::CachedEnvironment env(grid);
+  pbs::AStarPlanner planner;
+  auto p1 = planner.solve(env, pbs::State(0, 0), pbs::State(9, 9));
+  auto p2 = planner.solve(env, pbs::State(0, 0), pbs::State(9, 9));
+  EXPECT_TRUE(p1.success);
+  EXPECT_DOUBLE_EQ(p1.length, p2.length);
+  EXPECT_GT(env.stats().hits, 0u);
+}
+
+TEST(RasterizerTest, ConservativeCellsAreFreeInScene) {
+  std::vector<pbs::Point2D> tri = {{2.2,1.3},{8.6,2.1},{4.1,7.7}};
+  std::vector<pbs::Point2D> sq = {{12.5,12.5},{15.5,12.5},{15.5,15.5},{12.5,15.5}};
+  pbs::ContinuousEnvironment env(0, 20, 0, 20,
+      std::vector<pbs::Polygon>{pbs::Polygon(tri), pbs::Polygon(sq)});
+  auto cons = pbs::rasterize(env, 0.5, pbs::RasterCoverage::Conservative, 1);
+  auto center = pbs::rasterize(env, 0.5, pbs::RasterCoverage::Center);
+  ASSERT_EQ(cons.grid.width(), 40);
+  ASSERT_EQ(cons.grid.height(), 40);
+  int n_cons = 0, n_center = 0;
+  for (int r = 0; r < 40; ++r) {
+    for (int c = 0; c < 40; ++c) {
+      if (center.grid.occupied(r, c)) {
+        ++n_center;
+        EXPECT_TRUE(cons.grid.occupied(r, c));
+      }
+      if (cons.grid.occupied(r, c)) { ++n_cons; continue; }
+      // Corners and center of a free cell must be free in the scene.
+      for (double fy : {0.0, 0.5, 1.0})
+        for (double fx : {0.0, 0.5, 1.0})
+          EXPECT_TRUE(env.is_valid(pbs::State((c + fx) * 0.5, (r + fy) * 0.5)));
+    }
+  }
+  EXPECT_GT(n_cons, n_center);
+
+  // Row-parallel rasterization gives the same grid.
+  auto fine = pbs::rasterize(env, 0.05, pbs::RasterCoverage::Conservative, 1);
+  auto fine_mt = pbs::rasterize(env, 0.05, pbs::RasterCoverage::Conservative, 4);
+  for (int r = 0; r < 400; ++r)
+    for (int c = 0; c < 400; ++c)
+      ASSERT_EQ(fine.grid.occupied(r, c), fine_mt.grid.occupied(r, c));
+  EXPECT_TRUE(center.grid.occupied(25, 25));
+  EXPECT_FALSE(center.grid.occupied(24, 24));
+}
+
+TEST(RasterizerTest, CachedPerResolutionAndPathMapsBack) {
+  std::vector<pbs::Point2D> wall = {{9,0},{11,0},{11,16},{9,16}};
+  pbs::ContinuousEnvironment env(0, 20, 0, 20, std::vector<pbs::Polygon>{pbs::Polygon(wall)});
+  auto r1 = pbs::rasterize_cached(env, 0.5);
+  auto r2 = pbs::rasterize_cached(env, 0.5);
+  auto r3 = pbs::rasterize_cached(env, 1.0);
+  EXPECT_EQ(r1.get(), r2.get());
+  EXPECT_NE(r1.get(), r3.get());
+  EXPECT_EQ(env.preprocessing_cache().size(), 2u);
+
+  pbs::State start(2.1, 3.3), goal(17.8, 2.6);
+  pbs::AStarPlanner planner;
+  auto grid_path = planner.solve(r1->grid, r1->mapping.to_cell(start), r1->mapping.to_cell(goal));
+  ASSERT_TRUE(grid_path.success);
+  auto path = r1->mapping.to_world(grid_path, start, goal);
+  EXPECT_DOUBLE_EQ(path.states.front().x, 2.1);
+  EXPECT_DOUBLE_EQ(path.states.back().y, 2.6);
+  EXPECT_GT(path.length, 2 * 13.0);  // Has to go around the top of the wall
+  for (size_t i = 1; i < path.states.size(); ++i)
+    EXPECT_TRUE(env.collision_free(path.states[i - 1], path.states[i]));
+}
+
+TEST(PreprocessingCacheTest, SlowBuildBlocksOnlyItsKey) {
+  pbs::PreprocessingCache cache;
+  std::atomic<bool> building{false}, release{false};
+  std::thread slow([&] {
+    cache.get_or_build<int>("slow", [&] {
+      building = true;
+      while (!release) std::this_thread::yield();
+      return std::make_shared<const int>(1);
+    });
+  });
+  while (!building) std::this_thread::yield();
+  // Other keys are served while "slow" builds, including nested lookups.
+  auto outer = cache.get_or_build<int>("outer", [&] {
+    auto inner = cache.get_or_build<int>("inner", [] { return std::make_shared<const int>(2); });
+    return std::make_shared<const int>(*inner + 1);
+  });
+  EXPECT_EQ(*outer, 3);
+  EXPECT_FALSE(cache.contains("slow"));
+  release = true;
+  slow.join();
+  EXPECT_TRUE(cache.contains("slow"));
+  EXPECT_EQ(cache.size(), 3u);
+}
+
+TEST(FreeSpaceTest, TrapezoidsCoverFreeAreaAndSamplesAreValid) {
+  // A non-convex L, a triangle overlapping it and a square leaving the bounds.
+  std::vector<pbs::Polygon> obs = {
+      pbs::Polygon({{2, 2}, {6, 2}, {6, 3}, {3, 3}, {3, 7}, {2, 7}}),
+      pbs::Polygon({{5, 1}, {8, 4}, {5, 4}}),
+      pbs::Polygon({{8, 8}, {12, 8}, {12, 12}, {8, 12}})};
+  auto scene = std::make_shared<pbs::ContinuousEnvironment>(0, 10, 0, 10, obs);
+  // Blocked area by inclusion-exclusion: L 8, triangle 4.5, their overlap 1
+  // ([5, 6] x [2, 3]), square 4 inside the bounds.
+  pbs::CachedEnvironment decorated(scene);
+  auto fs = pbs::free_space_sampler(decorated);
+  ASSERT_NE(fs, nullptr);
+  EXPECT_NEAR(fs->free_fraction() * 100, 100 - 8 - 4.5 + 1 - 4, 1e-9);
+  EXPECT_EQ(fs, pbs::free_space_sampler(*scene));  // cached on the scene
+
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<double> u01(0, 1);
+  for (int i = 0; i < 2000; ++i) {
+    double x = 0, y = 0;
+    fs->map(u01(rng), u01(rng), x, y);
+    EXPECT_TRUE(scene->is_valid(pbs::State(x, y))) << x << ", " << y;
+  }
+
+  pbs::GridEnvironment grid(4, 3, {{0, 1, 0, 0}, {1, 1, 0, 1}, {0, 0, 0, 1}});
+  auto cells = pbs::free_space_sampler(grid);
+  ASSERT_NE(cells, nullptr);
+  EXPECT_NEAR(cells->free_fraction(), 7.0 / 12.0, 1e-12);
+  for (int i = 0; i < 500; ++i) {
+    double x = 0, y = 0;
+    cells->map(u01(rng), u01(rng), x, y);
+    EXPECT_TRUE(grid.is_valid(pbs::State(x, y))) << x << ", " << y;
+  }
+}
+
+TEST(PathPostprocessorTest, ShortcutsAndSplineStayCollisionFree) {
+  pbs::ContinuousEnvironment env(0, 20, 0, 20, {
+      pbs::Polygon({{8, 0}, {10, 0}, {10, 14}, {8, 14}})});
+  const pbs::State start(2.0, 2.0), goal(18.0, 2.0);
+  pbs::RRTPlanner rrt(1.0, 0.1, 5000);
+  pbs::Path raw = rrt.solve(env, start, goal);
+  ASSERT_TRUE(raw.success);
+  pbs::MetricsCollector collector;
+  const pbs::Metrics before = collector.collect(raw, 0, 0);
+
+  auto check = [&](const pbs::Path& p) {
+    ASSERT_TRUE(p.success);
+    EXPECT_EQ(p.states.front(), raw.states.front());
+    EXPECT_EQ(p.states.back(), raw.states.back());
+    for (size_t i = 1; i < p.states.size(); ++i)
+      EXPECT_TRUE(env.collision_free(p.states[i - 1], p.states[i]));
+  };
+
+  pbs::PathPostprocessOptions greedy;
+  greedy.shortcut = pbs::ShortcutMode::Greedy;
+  pbs::PathPostprocessor g(greedy);
+  pbs::Path shortcut = g.process(env, raw);
+  check(shortcut);
+  EXPECT_LT(shortcut.length, raw.length);
+  EXPECT_GT(g.stats().shortcuts, 0);
+
+  pbs::PathPostprocessOptions full;
+  full.shortcut = pbs::ShortcutMode::Random;
+  full.partial = true;
+  full.bspline = true;
+  pbs::PathPostprocessor r(full);
+  pbs::Path smooth = r.process(env, raw);
+  check(smooth);
+  EXPECT_LT(smooth.length, raw.length);
+  EXPECT_LT(collector.collect(smooth, 0, 0).energy, before.energy);
+  EXPECT_GT(r.stats().collision_checks, 0);
+}
+
 }  // namespace
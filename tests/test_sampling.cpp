@@ -2,11 +2,32 @@
 #include "geometry/kdtree2d.hpp"
 #include "geometry/point2d.hpp"
 #include "environment/continuous_environment.hpp"
+#include "environment/environment_decorator.hpp"
+#include "environment/grid_environment.hpp"
 #include "planners/prm.hpp"
+#include "planners/csr_graph.hpp"
 #include "planners/lazy_prm.hpp"
+#include "planners/roadmap.hpp"
+#include "planners/spars.hpp"
+#include "planners/fmt_star.hpp"
 #include "planners/rrt.hpp"
 #include "planners/rrt_star.hpp"
+#include "planners/rrt_connect.hpp"
+#include "planners/rrt_tree.hpp"
+#include "planners/concurrent_rrt_tree.hpp"
 #include "planners/informed_rrt_star.hpp"
+#include "planners/bit_star.hpp"
+#include "planners/sampler.hpp"
+#include "planners/steering.hpp"
+#include "planners/visibility_graph_planner.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <set>
+#include <thread>
+#include <tuple>
 
 namespace {
 
@@ -49,6 +70,325 @@ TEST(LazyPRMTest, SameResultAsPRM) {
   EXPECT_NEAR(p1.length, p2.length, 2.0);
 }
 
+TEST(LazyPRMTest, ChecksOnlyCandidatePathEdges) {
+  std::vector<pbs::Polygon> obs;
+  for (int i = 0; i < 4; ++i)
+    for (int j = 0; j < 4; ++j) {
+      const double x = 1.5 + 2.0 * i, y = 1.5 + 2.0 * j;
+      obs.push_back(pbs::Polygon({{x, y}, {x + 1, y}, {x + 1, y + 1}, {x, y + 1}}));
+    }
+  pbs::ContinuousEnvironment env(0, 10, 0, 10, obs);
+  pbs::PRMPlanner prm(400, 10);
+  pbs::LazyPRMPlanner lazy(400, 10);
+  pbs::Path p1 = prm.solve(env, pbs::State(0.5, 0.5), pbs::State(9.5, 9.5));
+  pbs::Path p2 = lazy.solve(env, pbs::State(0.5, 0.5), pbs::State(9.5, 9.5));
+  ASSERT_TRUE(p1.success);
+  ASSERT_TRUE(p2.success);
+  for (size_t i = 1; i < p2.states.size(); ++i)
+    EXPECT_TRUE(env.collision_free(p2.states[i - 1], p2.states[i]));
+  EXPECT_NEAR(p1.length, p2.length, 1.0);
+  // PRM checks all ~4000 candidate edges; lazy checks a few paths' worth.
+  EXPECT_GT(lazy.edges_checked(), 0);
+  EXPECT_LT(lazy.edges_checked(), 400);
+}
+
+TEST(PRMTest, FreeSpaceSamplingSkipsRejection) {
+  // Counts validity queries reaching the grid.
+  struct Counting : pbs::EnvironmentDecorator {
+    using EnvironmentDecorator::EnvironmentDecorator;
+    bool is_valid(const pbs::State& s) const override {
+      ++checks;
+      return inner_->is_valid(s);
+    }
+    mutable int checks = 0;
+  };
+  std::vector<std::vector<int>> occ(30, std::vector<int>(30, 1));
+  for (int i = 0; i < 30; ++i) occ[15][i] = occ[i][3] = 0;  // a cross of free cells
+  auto grid = std::make_shared<pbs::GridEnvironment>(30, 30, occ);
+  Counting env(grid);
+  pbs::PRMPlanner prm(200, 10);
+  EXPECT_TRUE(prm.solve(env, pbs::State(0.5, 15.5), pbs::State(29.5, 15.5)).success);
+  const int free_checks = env.checks;
+  prm.set_free_space_sampling(false);
+  env.checks = 0;
+  prm.solve(env, pbs::State(0.5, 15.5), pbs::State(29.5, 15.5));
+  // 59 of 900 cells are free: rejection burns its whole attempt budget.
+  EXPECT_GT(env.checks, 1000);
+  EXPECT_LT(free_checks, 10);
+}
+
+TEST(PRMTest, SampleValidPointsAppendsInDrawOrder) {
+  pbs::ContinuousEnvironment env(0, 10, 0, 10, {
+      pbs::Polygon({{0, 0}, {10, 0}, {10, 7.5}, {0, 7.5}})});  // 25% free
+  std::vector<pbs::Point2D> serial = {pbs::Point2D(-1, -1)}, parallel;
+  pbs::XoshiroSampler a(5), b(5);
+  pbs::sample_valid_points(env, a, nullptr, 50, serial);
+  pbs::sample_valid_points(env, b, nullptr, 50, parallel, 4);
+  ASSERT_EQ(serial.size(), 51u);  // Appended after the existing point
+  ASSERT_EQ(parallel.size(), 50u);
+  for (size_t i = 0; i < parallel.size(); ++i) {
+    EXPECT_TRUE(env.is_valid(pbs::State(parallel[i].x, parallel[i].y)));
+    EXPECT_EQ(serial[i + 1].x, parallel[i].x);
+    EXPECT_EQ(serial[i + 1].y, parallel[i].y);
+  }
+  // Fully blocked: gives up after 10 * n draws with nothing added.
+  pbs::ContinuousEnvironment blocked(0, 10, 0, 10, {
+      pbs::Polygon({{0, 0}, {10, 0}, {10, 10}, {0, 10}})});
+  std::vector<pbs::Point2D> none;
+  pbs::sample_valid_points(blocked, a, nullptr, 50, none);
+  EXPECT_TRUE(none.empty());
+}
+
+TEST(PRMTest, RoadmapIsCachedAcrossQueries) {
+  std::vector<pbs::Point2D> sq = {{4,3},{5,3},{5,7},{4,7}};
+  pbs::ContinuousEnvironment env(0, 10, 0, 10, {pbs::Polygon(sq)});
+  pbs::PRMPlanner prm(300, 10);
+  pbs::Path p1 = prm.solve(env, pbs::State(2.0, 5.0), pbs::State(8.0, 5.0));
+  EXPECT_TRUE(p1.success);
+  EXPECT_GT(prm.last_build_ms(), 0.0);
+  pbs::Path p2 = prm.solve(env, pbs::State(2.0, 2.0), pbs::State(8.0, 8.0));
+  EXPECT_TRUE(p2.success);
+  EXPECT_EQ(prm.last_build_ms(), 0.0);
+  EXPECT_EQ(prm.roadmap(env).get(), prm.roadmap(env).get());
+  // A different seed is a different roadmap.
+  prm.set_sampler({"mt19937", 7});
+  prm.solve(env, pbs::State(2.0, 5.0), pbs::State(8.0, 5.0));
+  EXPECT_GT(prm.last_build_ms(), 0.0);
+}
+
+TEST(PRMTest, RoadmapFileRoundTrip) {
+  std::vector<pbs::Point2D> sq = {{4,3},{5,3},{5,7},{4,7}};
+  pbs::ContinuousEnvironment env(0, 10, 0, 10, {pbs::Polygon(sq)});
+  pbs::PRMPlanner prm(300, 10);
+  auto built = prm.roadmap(env);
+  const auto provenance = prm.roadmap_provenance(env);
+  const std::string file = ::testing::TempDir() + "prm_roadmap.bin";
+  ASSERT_TRUE(built->save(file, provenance));
+  auto loaded = pbs::Roadmap::load(file, provenance);
+  std::remove(file.c_str());
+  ASSERT_NE(loaded, nullptr);
+  EXPECT_TRUE(loaded->provenance() == provenance);
+  EXPECT_EQ(loaded->num_nodes(), built->num_nodes());
+  EXPECT_EQ(loaded->num_edges(), built->num_edges());
+  EXPECT_EQ(loaded->data_bytes(), built->data_bytes());
+
+  pbs::Path a = prm.query(*built, env, pbs::State(2.0, 5.0), pbs::State(8.0, 5.0));
+  pbs::Path b = prm.query(*loaded, env, pbs::State(2.0, 5.0), pbs::State(8.0, 5.0));
+  ASSERT_TRUE(a.success);
+  ASSERT_TRUE(b.success);
+  EXPECT_DOUBLE_EQ(a.length, b.length);
+  EXPECT_EQ(a.states.size(), b.states.size());
+  EXPECT_EQ(pbs::Roadmap::load(file + ".missing"), nullptr);
+}
+
+TEST(PRMTest, RoadmapFileRejectsOtherMapsAndCorruptData) {
+  std::vector<pbs::Point2D> sq = {{4,3},{5,3},{5,7},{4,7}};
+  pbs::ContinuousEnvironment env(0, 10, 0, 10, {pbs::Polygon(sq)});
+  std::vector<pbs::Point2D> wall = {{4.5,0},{5.5,0},{5.5,10},{4.5,10}};
+  pbs::ContinuousEnvironment other(0, 10, 0, 10, {pbs::Polygon(wall)});
+  pbs::PRMPlanner prm(300, 10);
+  auto built = prm.roadmap(env);
+  const auto provenance = prm.roadmap_provenance(env);
+  const std::string file = ::testing::TempDir() + "prm_roadmap_checked.bin";
+  ASSERT_TRUE(built->save(file, provenance));
+  EXPECT_NE(pbs::Roadmap::load(file, provenance), nullptr);
+  // Another map, seed or sample count is a different roadmap.
+  EXPECT_EQ(pbs::Roadmap::load(file, prm.roadmap_provenance(other)), nullptr);
+  prm.set_sampler({"mt19937", 7});
+  EXPECT_EQ(pbs::Roadmap::load(file, prm.roadmap_provenance(env)), nullptr);
+  EXPECT_EQ(pbs::Roadmap::load(file, pbs::PRMPlanner(400, 10).roadmap_provenance(env)), nullptr);
+
+  // An edge target past the last node.
+  std::vector<char> bytes(built->data_bytes());
+  {
+    std::ifstream in(file, std::ios::binary);
+    in.read(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  }
+  const size_t n = built->num_nodes();
+  const size_t targets = 64 + 2 * n * sizeof(double) + (n + 1) * sizeof(uint64_t);
+  const uint32_t bad = static_cast<uint32_t>(n);
+  std::memcpy(bytes.data() + targets, &bad, sizeof(bad));
+  std::ofstream(file, std::ios::binary | std::ios::trunc)
+      .write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  EXPECT_EQ(pbs::Roadmap::load(file, provenance), nullptr);
+  std::remove(file.c_str());
+}
+
+TEST(PRMTest, ParallelRoadmapMatchesSerial) {
+  std::vector<pbs::Point2D> sq = {{4,3},{5,3},{5,7},{4,7}};
+  pbs::ContinuousEnvironment env(0, 10, 0, 10, {pbs::Polygon(sq)});
+  auto s1 = pbs::make_sampler({"xoshiro", 9});
+  auto s4 = pbs::make_sampler({"xoshiro", 9});
+  // Rejection sampling, so validation is part of the parallel work.
+  auto serial = pbs::Roadmap::build(env, 700, 10, *s1, nullptr, 1);
+  auto parallel = pbs::Roadmap::build(env, 700, 10, *s4, nullptr, 4);
+  ASSERT_EQ(serial->num_nodes(), parallel->num_nodes());
+  ASSERT_EQ(serial->num_edges(), parallel->num_edges());
+  EXPECT_EQ(parallel->timings().threads, 4);
+  const pbs::CSRGraph& gs = serial->graph();
+  const pbs::CSRGraph& gp = parallel->graph();
+  for (uint32_t i = 0; i < gs.num_nodes(); ++i) {
+    EXPECT_EQ(serial->xs()[i], parallel->xs()[i]);
+    EXPECT_EQ(gs.end(i), gp.end(i));
+  }
+  for (size_t e = 0; e < gs.num_edges(); ++e) {
+    EXPECT_EQ(gs.target(e), gp.target(e));
+    EXPECT_EQ(gs.weight(e), gp.weight(e));
+  }
+}
+
+TEST(SPARSTest, SparseRoadmapWithBoundedStretch) {
+  std::vector<pbs::Polygon> obs = {
+      pbs::Polygon({{3, 0}, {4, 0}, {4, 7}, {3, 7}}),
+      pbs::Polygon({{6, 3}, {7, 3}, {7, 10}, {6, 10}})};
+  pbs::ContinuousEnvironment env(0, 10, 0, 10, obs);
+  pbs::VisibilityGraphPlanner vg;
+  const double optimal = vg.solve(env, pbs::State(1.0, 1.0), pbs::State(9.0, 9.0)).length;
+
+  pbs::PRMPlanner prm(3000, 10);
+  pbs::SPARSPlanner spars(3000, 0.1, 1.5, 300, 10);
+  pbs::Path dense = prm.solve(env, pbs::State(1.0, 1.0), pbs::State(9.0, 9.0));
+  pbs::Path sparse = spars.solve(env, pbs::State(1.0, 1.0), pbs::State(9.0, 9.0));
+  ASSERT_TRUE(dense.success);
+  ASSERT_TRUE(sparse.success);
+  EXPECT_LT(sparse.length, 1.5 * optimal);
+  EXPECT_LT(spars.last_roadmap()->num_nodes() * 5, prm.last_roadmap()->num_nodes());
+  EXPECT_LT(spars.last_roadmap()->data_bytes() * 5, prm.last_roadmap()->data_bytes());
+  EXPECT_GT(spars.last_build_ms(), 0.0);
+  // Cached like PRM roadmaps.
+  spars.solve(env, pbs::State(9.0, 1.0), pbs::State(1.0, 9.0));
+  EXPECT_EQ(spars.last_build_ms(), 0.0);
+}
+
+TEST(CSRGraphTest, BuilderMergesThreadBuffersDeterministically) {
+  // The same edges split differently across buffers give the same graph.
+  pbs::CSRGraphBuilder one(4), two(4, 2);
+  const std::vector<std::tuple<uint32_t, uint32_t, float>> edges = {
+      {0, 2, 2.0f}, {0, 1, 1.0f}, {2, 0, 2.0f}, {3, 1, 1.5f}, {1, 2, 1.2f}};
+  for (size_t i = 0; i < edges.size(); ++i) {
+    const auto [a, b, w] = edges[i];
+    one.add(0, a, b, w);
+    two.add(static_cast<int>(i % 2), a, b, w);
+  }
+  pbs::CSRGraph g1 = one.build(true, false);
+  pbs::CSRGraph g2 = two.build(true, false);
+  // 0-2 appears in both directions and is kept once per row.
+  ASSERT_EQ(g1.num_edges(), 8u);
+  ASSERT_EQ(g2.num_edges(), g1.num_edges());
+  for (size_t e = 0; e < g1.num_edges(); ++e) {
+    EXPECT_EQ(g1.target(e), g2.target(e));
+    EXPECT_EQ(g1.weight(e), g2.weight(e));
+  }
+  EXPECT_EQ(g1.end(0) - g1.begin(0), 2u);
+  EXPECT_EQ(g1.target(g1.begin(0)), 1u);  // rows sorted by target
+
+  const uint64_t e = g1.find_edge(3, 1);
+  ASSERT_NE(e, g1.end(3));
+  EXPECT_FLOAT_EQ(g1.weight(e), 1.5f);
+  EXPECT_EQ(g1.find_edge(3, 0), g1.end(3));
+  EXPECT_FALSE(g1.checked(e));
+  EXPECT_TRUE(g1.valid(e));
+  g1.set_checked(e, false);
+  EXPECT_TRUE(g1.checked(e));
+  EXPECT_FALSE(g1.valid(e));
+  EXPECT_TRUE(g2.valid(e));  // bits are per copy
+  EXPECT_LT(g1.memory_bytes(), g1.num_edges() * 9 + 8 * 5 + 16);
+}
+
+TEST(KdTreeTest, RadiusSearchMatchesBruteForce) {
+  std::mt19937 rng(3);
+  std::uniform_real_distribution<double> u(0, 10);
+  std::vector<pbs::Point2D> pts;
+  for (int i = 0; i < 500; ++i) pts.push_back(pbs::Point2D(u(rng), u(rng)));
+  pbs::KdTree2D tree;
+  tree.build(pts);
+  for (int q = 0; q < 50; ++q) {
+    pbs::Point2D p(u(rng), u(rng));
+    auto found = tree.radius_search(p, 1.3);
+    std::set<size_t> expected;
+    for (size_t i = 0; i < pts.size(); ++i)
+      if (std::hypot(pts[i].x - p.x, pts[i].y - p.y) <= 1.3) expected.insert(i);
+    EXPECT_EQ(std::set<size_t>(found.begin(), found.end()), expected);
+  }
+}
+
+TEST(FMTStarTest, NearOptimalWithOneCheckPerConnection) {
+  pbs::ContinuousEnvironment env(0, 20, 0, 20, {
+      pbs::Polygon({{8, 0}, {10, 0}, {10, 14}, {8, 14}})});
+  const pbs::State start(2.0, 2.0), goal(18.0, 2.0);
+  pbs::FMTStarPlanner fmt(1500);
+  pbs::Path path = fmt.solve(env, start, goal);
+  ASSERT_TRUE(path.success);
+  for (size_t i = 1; i < path.states.size(); ++i)
+    EXPECT_TRUE(env.collision_free(path.states[i - 1], path.states[i]));
+  pbs::VisibilityGraphPlanner vg;
+  EXPECT_LT(path.length, vg.solve(env, start, goal).length * 1.1);
+  // One check per connection plus retries of failed ones, far below the
+  // n * k edges PRM checks.
+  EXPECT_LT(fmt.edges_checked(), 2 * 1502);
+}
+
+TEST(SamplerTest, StreamsAreDeterministicAndBlocksMatchSingleDraws) {
+  for (const char* type : {"mt19937", "xoshiro", "halton", "sobol", "scrambled_sobol"}) {
+    const pbs::SamplerConfig config{type, 7};
+    auto a = pbs::make_sampler(config), b = pbs::make_sampler(config);
+    auto other = pbs::make_sampler(config, 1);
+    ASSERT_TRUE(a && b && other) << type;
+    std::vector<double> u(64), v(64);
+    b->next_block(u.data(), v.data(), u.size());
+    bool differs = false;
+    for (size_t i = 0; i < u.size(); ++i) {
+      double x = 0, y = 0, ox = 0, oy = 0;
+      a->next(x, y);
+      other->next(ox, oy);
+      EXPECT_EQ(x, u[i]) << type;
+      EXPECT_EQ(y, v[i]) << type;
+      EXPECT_TRUE(x >= 0 && x < 1 && y >= 0 && y < 1) << type;
+      differs |= x != ox || y != oy;
+    }
+    EXPECT_TRUE(differs) << type << " stream 1 repeats stream 0";
+  }
+  EXPECT_EQ(pbs::stream_seed(42, 0), 42u);
+  EXPECT_EQ(pbs::make_sampler({"unknown", 42}), nullptr);
+
+  // The mt19937 sampler keeps the legacy mt19937(42) sequence.
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> ux(0, 10);
+  auto mt = pbs::make_sampler({"mt19937", 42});
+  double u0 = 0, v0 = 0;
+  mt->next(u0, v0);
+  EXPECT_EQ(ux(rng), 10 * u0);
+}
+
+TEST(SamplerTest, SobolIsStratifiedAndPlannersAcceptQmc) {
+  // 256 Sobol points (shifted or scrambled) put exactly one point in each
+  // cell of a 16 x 16 grid; pseudo-random points leave cells empty.
+  auto occupied = [](const char* type) {
+    auto s = pbs::make_sampler({type, 3});
+    std::set<int> cells;
+    for (int i = 0; i < 256; ++i) {
+      double u = 0, v = 0;
+      s->next(u, v);
+      cells.insert(static_cast<int>(u * 16) * 16 + static_cast<int>(v * 16));
+    }
+    return cells.size();
+  };
+  EXPECT_EQ(occupied("sobol"), 256u);
+  EXPECT_EQ(occupied("scrambled_sobol"), 256u);
+  EXPECT_LT(occupied("xoshiro"), 256u);
+
+  std::vector<pbs::Point2D> sq = {{4,3},{5,3},{5,7},{4,7}};
+  pbs::ContinuousEnvironment env(0, 10, 0, 10, {pbs::Polygon(sq)});
+  for (const char* type : {"halton", "scrambled_sobol"}) {
+    pbs::PRMPlanner prm(300, 10);
+    prm.set_sampler({type, 42});
+    EXPECT_TRUE(prm.solve(env, pbs::State(2.0, 5.0), pbs::State(8.0, 5.0)).success) << type;
+    pbs::RRTStarPlanner rrt_star(0.5, 0.1, 3000);
+    rrt_star.set_sampler({type, 42});
+    EXPECT_TRUE(rrt_star.solve(env, pbs::State(2.0, 5.0), pbs::State(8.0, 5.0)).success) << type;
+  }
+}
+
 TEST(RRTTest, EmptySpace) {
   pbs::ContinuousEnvironment env(0, 10, 0, 10, {});
   pbs::RRTPlanner rrt(1.0, 0.15, 3000);
@@ -57,6 +397,28 @@ TEST(RRTTest, EmptySpace) {
   EXPECT_GT(rrt.nodes_expanded(), 0);
 }
 
+TEST(RRTConnectTest, NarrowPassageWithFewerNodesThanRRT) {
+  // Wall with a one-unit gap between start and goal.
+  pbs::ContinuousEnvironment env(0, 30, 0, 30, {
+      pbs::Polygon({{14, 0}, {16, 0}, {16, 14.5}, {14, 14.5}}),
+      pbs::Polygon({{14, 15.5}, {16, 15.5}, {16, 30}, {14, 30}})});
+  pbs::RRTConnectPlanner connect(1.0, 0.1, 20000);
+  pbs::Path path = connect.solve(env, pbs::State(3.0, 5.0), pbs::State(27.0, 25.0));
+  ASSERT_TRUE(path.success);
+  EXPECT_EQ(path.states.front().x, 3.0);
+  EXPECT_EQ(path.states.back().y, 25.0);
+  for (size_t i = 1; i < path.states.size(); ++i) {
+    EXPECT_TRUE(env.collision_free(path.states[i - 1], path.states[i]));
+    EXPECT_LE(std::hypot(path.states[i].x - path.states[i - 1].x,
+                         path.states[i].y - path.states[i - 1].y), 1.0 + 1e-9);
+  }
+
+  pbs::RRTPlanner rrt(1.0, 0.1, 20000);
+  pbs::Path p_rrt = rrt.solve(env, pbs::State(3.0, 5.0), pbs::State(27.0, 25.0));
+  ASSERT_TRUE(p_rrt.success);
+  EXPECT_LT(connect.nodes_expanded(), rrt.nodes_expanded());
+}
+
 TEST(RRTStarTest, ShorterThanRRT) {
   pbs::ContinuousEnvironment env(0, 10, 0, 10, {});
   pbs::RRTPlanner rrt(0.8, 0.1, 2000);
@@ -67,6 +429,205 @@ TEST(RRTStarTest, ShorterThanRRT) {
     EXPECT_LE(p2.length, p1.length + 2.0) << "RRT* should be no worse than RRT";
 }
 
+TEST(RRTTreeTest, RewireShiftsWholeSubtree) {
+  pbs::RRTTree tree;
+  tree.add(0, 0, 0, pbs::RRTTree::kNone, 0.0);  // 0
+  tree.add(1, 0, 0, 0, 1.0);                     // 1
+  tree.add(2, 0, 0, 1, 2.0);                     // 2
+  tree.add(3, 0, 0, 2, 3.0);                     // 3
+  tree.add(2, 1, 0, 1, 2.5);                     // 4
+  tree.add(0, 1, 0, 0, 1.0);                     // 5
+
+  tree.rewire(2, 5, 1.5);
+  EXPECT_EQ(tree.parent(2), 5u);
+  EXPECT_DOUBLE_EQ(tree.cost(2), 1.5);
+  EXPECT_DOUBLE_EQ(tree.cost(3), 2.5);
+  EXPECT_DOUBLE_EQ(tree.cost(4), 2.5) << "Sibling subtree must be untouched";
+  EXPECT_EQ(tree.first_child(1), 4u);
+  EXPECT_EQ(tree.next_sibling(4), pbs::RRTTree::kNone);
+  EXPECT_EQ(tree.first_child(5), 2u);
+  EXPECT_EQ(tree.path_to_root(3), (std::vector<size_t>{0, 5, 2, 3}));
+}
+
+TEST(RRTTreeTest, PruneDropsSubtreesAndCompacts) {
+  pbs::RRTTree tree;
+  tree.add(0, 0, 0, pbs::RRTTree::kNone, 0.0);  // 0
+  tree.add(1, 0, 0, 0, 1.0);                     // 1
+  tree.add(2, 0, 0, 1, 2.0);                     // 2
+  tree.add(0, 1, 0, 0, 1.0);                     // 3
+  tree.add(0, 2, 0, 3, 2.0);                     // 4
+  tree.add(0, 3, 0, 3, 2.0);                     // 5
+  tree.rewire(1, 5, 3.0);  // parent behind its child
+
+  // Dropping 3 takes 4, 5 and (through 5) 1 and 2 with it.
+  auto remap = tree.prune({1, 1, 1, 0, 1, 1});
+  EXPECT_EQ(tree.size(), 1u);
+  EXPECT_EQ(remap[0], 0u);
+  EXPECT_EQ(remap[1], pbs::RRTTree::kNone);
+  EXPECT_EQ(tree.first_child(0), pbs::RRTTree::kNone);
+
+  pbs::RRTTree t2;
+  t2.add(0, 0, 0, pbs::RRTTree::kNone, 0.0);  // 0
+  t2.add(1, 0, 0, 0, 1.0);                     // 1
+  t2.add(2, 0, 0, 0, 2.0);                     // 2
+  t2.add(3, 0, 0, 2, 3.0);                     // 3
+  t2.add(4, 0, 0, 0, 4.0);                     // 4
+  t2.rewire(2, 4, 5.0);
+  remap = t2.prune({1, 0, 1, 1, 1});
+  ASSERT_EQ(t2.size(), 4u);
+  EXPECT_EQ(remap, (std::vector<uint32_t>{0, pbs::RRTTree::kNone, 1, 2, 3}));
+  EXPECT_DOUBLE_EQ(t2.x(3), 4.0);
+  EXPECT_DOUBLE_EQ(t2.cost(2), 6.0);
+  EXPECT_EQ(t2.path_to_root(2), (std::vector<size_t>{0, 3, 1, 2}));
+  EXPECT_EQ(t2.first_child(0), 3u);
+  EXPECT_EQ(t2.next_sibling(3), pbs::RRTTree::kNone);
+}
+
+TEST(RRTTreeTest, CompactTreeGrowsAlignedArena) {
+  pbs::CompactRRTTree compact;
+  pbs::RRTTree wide;
+  compact.reserve(10);
+  compact.add(0, 0, 0, pbs::CompactRRTTree::kNone, 0.0);
+  wide.add(0, 0, 0, pbs::RRTTree::kNone, 0.0);
+  for (int i = 1; i < 1000; ++i) {  // several arena regrowths
+    compact.add(i, -i, 0.5, i - 1, i * 0.25);
+    wide.add(i, -i, 0.5, i - 1, i * 0.25);
+  }
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(compact.xs()) % 64, 0u);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(compact.ys()) % 64, 0u);
+  EXPECT_LT(compact.memory_bytes(), wide.memory_bytes());
+  EXPECT_FLOAT_EQ(compact.x(999), 999.0f);
+  EXPECT_FLOAT_EQ(compact.y(500), -500.0f);
+  EXPECT_EQ(compact.parent(999), 998u);
+  compact.rewire(999, 0, 1.0);
+  EXPECT_FLOAT_EQ(compact.cost(999), 1.0f);
+  EXPECT_EQ(compact.path_to_root(999), (std::vector<size_t>{0, 999}));
+}
+
+TEST(RRTStarTest, CompactStorageFindsCollisionFreePath) {
+  pbs::ContinuousEnvironment env(0, 20, 0, 20, {
+      pbs::Polygon({{8, 0}, {10, 0}, {10, 14}, {8, 14}})});
+  pbs::RRTStarPlanner rrtstar(1.0, 0.1, 3000, 15.0);
+  rrtstar.set_compact_storage(true);
+  pbs::Path path = rrtstar.solve(env, pbs::State(2.0, 2.0), pbs::State(18.0, 2.0));
+  ASSERT_TRUE(path.success);
+  for (size_t i = 1; i < path.states.size(); ++i)
+    EXPECT_TRUE(env.collision_free(path.states[i - 1], path.states[i]));
+  // Float costs drift from the recomputed length by rounding only.
+  EXPECT_NEAR(rrtstar.convergence_data().final_cost, path.length, 1e-3);
+}
+
+TEST(RRTStarTest, FinalCostMatchesPathAfterRewiring) {
+  pbs::ContinuousEnvironment env(0, 20, 0, 20, {
+      pbs::Polygon({{8, 0}, {10, 0}, {10, 14}, {8, 14}})});
+  pbs::RRTStarPlanner rrtstar(1.0, 0.1, 3000, 15.0);
+  pbs::Path path = rrtstar.solve(env, pbs::State(2.0, 2.0), pbs::State(18.0, 2.0));
+  ASSERT_TRUE(path.success);
+  EXPECT_NEAR(rrtstar.convergence_data().final_cost, path.length, 1e-6)
+      << "Propagated subtree costs must stay consistent with edge lengths";
+}
+
+TEST(ConcurrentRRTTreeTest, ParallelInsertMatchesBruteForceQueries) {
+  const int per_thread = 500, threads = 4;
+  pbs::ConcurrentRRTTree tree(per_thread * threads + 1, 0, 50, 0, 50, 1.0);
+  tree.add(25, 25, pbs::ConcurrentRRTTree::kNone, 0.0);
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t)
+    workers.emplace_back([&, t] {
+      std::mt19937 rng(t);
+      std::uniform_real_distribution<double> u(0, 50);
+      for (int i = 0; i < per_thread; ++i) tree.add(u(rng), u(rng), 0, 1.0);
+    });
+  for (auto& w : workers) w.join();
+  ASSERT_EQ(tree.size(), static_cast<size_t>(per_thread * threads + 1));
+  EXPECT_EQ(tree.add(1, 1, 0, 1.0), pbs::ConcurrentRRTTree::kNone) << "Tree is full";
+
+  std::mt19937 rng(99);
+  std::uniform_real_distribution<double> u(0, 50);
+  std::vector<uint32_t> near;
+  for (int q = 0; q < 200; ++q) {
+    double x = u(rng), y = u(rng);
+    size_t best = 0;
+    std::set<uint32_t> within;
+    for (size_t i = 0; i < tree.size(); ++i) {
+      double d = std::hypot(tree.x(i) - x, tree.y(i) - y);
+      if (d < std::hypot(tree.x(best) - x, tree.y(best) - y)) best = i;
+      if (d <= 2.5) within.insert(static_cast<uint32_t>(i));
+    }
+    EXPECT_NEAR(std::hypot(tree.x(tree.nearest(x, y)) - x, tree.y(tree.nearest(x, y)) - y),
+                std::hypot(tree.x(best) - x, tree.y(best) - y), 1e-12);
+    near.clear();
+    tree.near(x, y, 2.5, near);
+    EXPECT_EQ(std::set<uint32_t>(near.begin(), near.end()), within);
+  }
+}
+
+TEST(ConcurrentRRTTreeTest, AllocatesBlocksOnDemand) {
+  pbs::ConcurrentRRTTree tree(200001, 0, 50, 0, 50, 1.0);
+  EXPECT_EQ(tree.blocks_allocated(), 0u);
+  tree.add(25, 25, pbs::ConcurrentRRTTree::kNone, 0.0);
+  const size_t n = pbs::ConcurrentRRTTree::kBlockSize + 10;
+  for (size_t i = 1; i < n; ++i) tree.add(25 + 0.001 * i, 25, 0, 0.001 * i);
+  EXPECT_EQ(tree.blocks_allocated(), 2u);
+  EXPECT_EQ(tree.nearest(25 + 0.001 * (n - 1), 25), n - 1);
+  EXPECT_DOUBLE_EQ(tree.cost(n - 1), 0.001 * (n - 1));
+}
+
+TEST(ConcurrentRRTTreeTest, RewireOnlyLowersCost) {
+  pbs::ConcurrentRRTTree tree(8, 0, 10, 0, 10, 1.0);
+  tree.add(0, 0, pbs::ConcurrentRRTTree::kNone, 0.0);  // 0
+  tree.add(3, 0, 0, 3.0);                              // 1
+  tree.add(3, 4, 1, 7.0);                              // 2
+  tree.add(6, 4, 2, 10.0);                             // 3
+  EXPECT_FALSE(tree.rewire(1, 3, 5.0)) << "Own descendant must never be accepted";
+  EXPECT_TRUE(tree.rewire(2, 0, 5.0));
+  EXPECT_EQ(tree.parent(2), 0u);
+  EXPECT_DOUBLE_EQ(tree.cost(2), 5.0);
+  EXPECT_DOUBLE_EQ(tree.cost(3), 8.0);
+  EXPECT_EQ(tree.path_to_root(3), (std::vector<size_t>{0, 2, 3}));
+}
+
+TEST(ParallelRRTTest, MultiThreadedPlannersFindPaths) {
+  pbs::ContinuousEnvironment env(0, 20, 0, 20, {
+      pbs::Polygon({{8, 0}, {10, 0}, {10, 14}, {8, 14}})});
+  pbs::RRTPlanner rrt(1.0, 0.1, 5000);
+  rrt.set_num_threads(4);
+  pbs::Path p1 = rrt.solve(env, pbs::State(2.0, 2.0), pbs::State(18.0, 2.0));
+  ASSERT_TRUE(p1.success);
+  EXPECT_EQ(p1.states.back().x, 18.0);
+
+  pbs::RRTStarPlanner rrtstar(1.0, 0.1, 3000, 15.0);
+  rrtstar.set_num_threads(4);
+  pbs::Path p2 = rrtstar.solve(env, pbs::State(2.0, 2.0), pbs::State(18.0, 2.0));
+  ASSERT_TRUE(p2.success);
+  EXPECT_GT(rrtstar.nodes_expanded(), 100);
+  EXPECT_NEAR(rrtstar.convergence_data().final_cost, p2.length, 1e-6);
+  for (size_t i = 1; i < p2.states.size(); ++i)
+    EXPECT_TRUE(env.collision_free(p2.states[i - 1], p2.states[i]));
+}
+
+TEST(RRTStarTest, TimeBudgetReturnsBestPathSoFar) {
+  std::vector<pbs::Point2D> sq = {{4,3},{5,3},{5,7},{4,7}};
+  pbs::ContinuousEnvironment env(0, 10, 0, 10, {pbs::Polygon(sq)});
+  pbs::RRTStarPlanner rrt_star(0.5, 0.1, 100000000);
+  rrt_star.set_time_budget_ms(40);
+  auto t0 = std::chrono::steady_clock::now();
+  pbs::Path path = rrt_star.solve(env, pbs::State(2.0, 5.0), pbs::State(8.0, 5.0));
+  double ms = std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - t0).count();
+  ASSERT_TRUE(path.success);
+  // Overrun is bounded by a few iterations plus path extraction.
+  EXPECT_LT(ms, 40 + 100);
+  const auto& curve = rrt_star.convergence_data().cost_vs_time;
+  ASSERT_FALSE(curve.empty());
+  for (size_t i = 1; i < curve.size(); ++i) {
+    EXPECT_GE(curve[i].first, curve[i - 1].first);
+    EXPECT_LT(curve[i].second, curve[i - 1].second);
+  }
+  EXPECT_LE(curve.back().first, ms);
+  EXPECT_NEAR(curve.back().second, rrt_star.convergence_data().final_cost, 1e-9);
+}
+
 TEST(InformedRRTStarTest, ConvergenceTracking) {
   pbs::ContinuousEnvironment env(0, 10, 0, 10, {});
   pbs::InformedRRTStarPlanner irrt(0.8, 0.1, 2000, 15.0);
@@ -81,6 +642,30 @@ TEST(InformedRRTStarTest, ConvergenceTracking) {
   }
 }
 
+TEST(InformedRRTStarTest, PruningKeepsTreeInsideBound) {
+  pbs::ContinuousEnvironment env(0, 20, 0, 20, {
+      pbs::Polygon({{8, 0}, {10, 0}, {10, 14}, {8, 14}})});
+  const pbs::State start(2.0, 2.0), goal(18.0, 2.0);
+  pbs::InformedRRTStarPlanner pruned(1.0, 0.1, 4000, 15.0);
+  pbs::InformedRRTStarPlanner full(1.0, 0.1, 4000, 15.0);
+  full.set_pruning(false);
+  pbs::Path a = pruned.solve(env, start, goal);
+  pbs::Path b = full.solve(env, start, goal);
+  ASSERT_TRUE(a.success);
+  ASSERT_TRUE(b.success);
+  EXPECT_NEAR(pruned.convergence_data().final_cost, a.length, 1e-6);
+
+  const auto& sizes = pruned.convergence_data().tree_size_vs_time;
+  const auto& full_sizes = full.convergence_data().tree_size_vs_time;
+  ASSERT_FALSE(sizes.empty());
+  ASSERT_FALSE(full_sizes.empty());
+  EXPECT_GT(pruned.nodes_pruned(), 0);
+  EXPECT_EQ(full.nodes_pruned(), 0);
+  EXPECT_LT(sizes.back().second, full_sizes.back().second);
+  for (size_t i = 1; i < sizes.size(); ++i)
+    EXPECT_GE(sizes[i].first, sizes[i - 1].first);
+}
+
 TEST(InformedRRTStarTest, FindsPath) {
   pbs::ContinuousEnvironment env(0, 10, 0, 10, {});
   pbs::InformedRRTStarPlanner irrt(0.8, 0.2, 2500, 12.0);
@@ -88,4 +673,169 @@ TEST(InformedRRTStarTest, FindsPath) {
   EXPECT_TRUE(path.success) << "Informed RRT* should find path";
 }
 
+TEST(BITStarTest, BatchesConvergeTowardsOptimum) {
+  pbs::ContinuousEnvironment env(0, 20, 0, 20, {
+      pbs::Polygon({{8, 0}, {10, 0}, {10, 14}, {8, 14}})});
+  const pbs::State start(2.0, 2.0), goal(18.0, 2.0);
+  pbs::BITStarPlanner bit(100, 15);
+  pbs::Path path = bit.solve(env, start, goal);
+  ASSERT_TRUE(path.success);
+  for (size_t i = 1; i < path.states.size(); ++i)
+    EXPECT_TRUE(env.collision_free(path.states[i - 1], path.states[i]));
+
+  const auto& cd = bit.convergence_data();
+  ASSERT_FALSE(cd.cost_vs_iteration.empty());
+  EXPECT_LE(cd.cost_vs_iteration.size(), 15u) << "One record per batch";
+  for (size_t i = 1; i < cd.cost_vs_iteration.size(); ++i) {
+    EXPECT_GT(cd.cost_vs_iteration[i].first, cd.cost_vs_iteration[i - 1].first);
+    EXPECT_LE(cd.cost_vs_iteration[i].second, cd.cost_vs_iteration[i - 1].second);
+  }
+  EXPECT_NEAR(cd.final_cost, path.length, 1e-9);
+
+  pbs::VisibilityGraphPlanner vg;
+  double opt = vg.solve(env, start, goal).length;
+  EXPECT_LT(path.length, opt * 1.1);
+  EXPECT_GT(bit.edges_checked(), 0);
+}
+
+TEST(BITStarTest, ConvergenceCountsAcceptedSamples) {
+  // Only a 2-unit strip along the bottom is free, so most draws are rejected.
+  pbs::ContinuousEnvironment env(0, 100, 0, 100, {
+      pbs::Polygon({{0, 2}, {100, 2}, {100, 100}, {0, 100}})});
+  pbs::BITStarPlanner bit(100, 10);
+  pbs::Path path = bit.solve(env, pbs::State(1.0, 1.0), pbs::State(99.0, 1.0));
+  ASSERT_TRUE(path.success);
+  const auto& cd = bit.convergence_data();
+  ASSERT_FALSE(cd.cost_vs_iteration.empty());
+  EXPECT_LT(cd.cost_vs_iteration.back().first, 10 * 100);
+}
+
+TEST(SteeringTest, DubinsAndReedsSheppKnownLengths) {
+  pbs::DubinsSteering dubins(2.0);
+  pbs::ReedsSheppSteering rs(2.0);
+  pbs::State a(0, 0, 0.0);
+  EXPECT_NEAR(dubins.distance(a, pbs::State(5, 0, 0.0)), 5.0, 1e-9);
+  EXPECT_NEAR(dubins.distance(a, pbs::State(0, 4, M_PI)), 2.0 * M_PI, 1e-9);  // U-turn
+  EXPECT_NEAR(rs.distance(a, pbs::State(-3, 0, 0.0)), 3.0, 1e-9);             // Reverse
+  pbs::State b(3, -2, 1.0);
+  EXPECT_LE(rs.distance(a, b), dubins.distance(a, b) + 1e-9);
+  EXPECT_NEAR(rs.distance(a, b), rs.distance(b, a), 1e-9);
+}
+
+TEST(SteeringTest, ExtendFollowsCurve) {
+  pbs::DubinsSteering dubins(1.0);
+  pbs::State a(0, 0, 0.0), b(0, 2, M_PI);
+  pbs::State mid = dubins.extend(a, b, M_PI / 2);  // Quarter of the left U-turn
+  EXPECT_NEAR(mid.x, 1.0, 1e-9);
+  EXPECT_NEAR(mid.y, 1.0, 1e-9);
+  EXPECT_NEAR(*mid.theta, M_PI / 2, 1e-9);
+  auto pts = dubins.interpolate(a, b, 0.1);
+  EXPECT_GE(pts.size(), 32u);
+  EXPECT_NEAR(pts.back().x, 0.0, 1e-9);
+}
+
+TEST(SteeringTest, RRTWithDubinsProducesDrivablePath) {
+  pbs::ContinuousEnvironment env(0, 10, 0, 10, {});
+  pbs::RRTPlanner rrt(1.0, 0.1, 4000);
+  rrt.set_steering(std::make_shared<pbs::DubinsSteering>(1.0), 0.1);
+  pbs::Path path = rrt.solve(env, pbs::State(2, 2, 0.0), pbs::State(8, 8, M_PI / 2));
+  ASSERT_TRUE(path.success);
+  for (size_t i = 1; i < path.states.size(); ++i) {
+    double step = pbs::distance(path.states[i - 1], path.states[i]);
+    double turn = std::remainder(*path.states[i].theta - *path.states[i - 1].theta, 2 * M_PI);
+    // Chord length slightly underestimates the arc, hence the 1% slack.
+    EXPECT_LE(std::abs(turn), step / 1.0 * 1.01 + 1e-6) << "curvature above 1/turning_radius";
+  }
+}
+
+TEST(VisibilityGraphTest, KnownShortestPaths) {
+  std::vector<pbs::Point2D> sq = {{4,4},{6,4},{6,6},{4,6}};
+  pbs::ContinuousEnvironment env(0, 10, 0, 10, std::vector<pbs::Polygon>{pbs::Polygon(sq)});
+  pbs::VisibilityGraphPlanner vg;
+  auto around = vg.solve(env, pbs::State(1.0, 5.0), pbs::State(9.0, 5.0));
+  ASSERT_TRUE(around.success);
+  EXPECT_NEAR(around.length, 2 * std::sqrt(10.0) + 2, 1e-9);
+  EXPECT_EQ(around.states.size(), 4u);
+  // Grazing the top edge: start, both corners and goal are collinear.
+  auto graze = vg.solve(env, pbs::State(1.0, 6.0), pbs::State(9.0, 6.0));
+  ASSERT_TRUE(graze.success);
+  EXPECT_NEAR(graze.length, 8.0, 1e-9);
+  // The graph is cached on the environment.
+  EXPECT_EQ(pbs::VisibilityGraphPlanner::graph_for(env).get(),
+            pbs::VisibilityGraphPlanner::graph_for(env).get());
+  EXPECT_EQ(pbs::VisibilityGraphPlanner::graph_for(env)->num_edges(), 4u);
+
+  // A wall touching the boundary leaves no gap beneath it.
+  std::vector<pbs::Point2D> wall = {{4,0},{6,0},{6,6},{4,6}};
+  pbs::ContinuousEnvironment walled(0, 10, 0, 10, std::vector<pbs::Polygon>{pbs::Polygon(wall)});
+  auto over = vg.solve(walled, pbs::State(1.0, 1.0), pbs::State(9.0, 1.0));
+  ASSERT_TRUE(over.success);
+  EXPECT_NEAR(over.length, 2 * std::sqrt(34.0) + 2, 1e-9);
+}
+
+TEST(VisibilityGraphTest, SweepMatchesPairwiseCheck) {
+  std::mt19937 rng(3);
+  std::uniform_real_distribution<double> jitter(-1.5, 1.5);
+  std::vector<pbs::Polygon> obstacles;
+  for (int gx = 0; gx < 5; ++gx)
+    for (int gy = 0; gy < 5; ++gy) {
+      double cx = 10 + 20 * gx, cy = 10 + 20 * gy;
+      obstacles.emplace_back(std::vector<pbs::Point2D>{
+          {cx - 5 + jitter(rng), cy - 4 + jitter(rng)},
+          {cx + 5 + jitter(rng), cy - 3 + jitter(rng)},
+          {cx + jitter(rng), cy + 5 + jitter(rng)}});
+    }
+  pbs::VisibilityGraph graph(obstacles);
+  ASSERT_EQ(graph.num_vertices(), 75u);
+
+  auto cross = [](pbs::Point2D o, pbs::Point2D a, pbs::Point2D b) {
+    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+  };
+  // Vertices u, v of the same triangle are joined by an obstacle edge.
+  auto visible = [&](size_t u, size_t v) {
+    if (u / 3 == v / 3) return true;
+    pbs::Point2D p = graph.vertex(u), q = graph.vertex(v);
+    for (const auto& poly : obstacles) {
+      const auto& v = poly.vertices();
+      for (size_t i = 0; i < v.size(); ++i) {
+        pbs::Point2D a = v[i], b = v[(i + 1) % v.size()];
+        if (cross(p, q, a) * cross(p, q, b) < -1e-12 &&
+            cross(a, b, p) * cross(a, b, q) < -1e-12)
+          return false;
+      }
+      if (poly.contains(pbs::Point2D((p.x + q.x) / 2, (p.y + q.y) / 2))) return false;
+    }
+    return true;
+  };
+
+  size_t expected = 0;
+  for (size_t u = 0; u < graph.num_vertices(); ++u) {
+    std::set<size_t> adj;
+    for (const auto& e : graph.neighbors(u)) adj.insert(e.first);
+    for (size_t v = 0; v < graph.num_vertices(); ++v) {
+      if (v == u) continue;
+      bool vis = visible(u, v);
+      EXPECT_EQ(adj.count(v) == 1, vis) << u << " -> " << v;
+      if (vis && u < v) ++expected;
+    }
+  }
+  EXPECT_EQ(graph.num_edges(), expected);
+}
+
+TEST(VisibilityGraphTest, RRTStarGapToOptimal) {
+  std::vector<pbs::Point2D> sq = {{4,4},{6,4},{6,6},{4,6}};
+  pbs::ContinuousEnvironment env(0, 10, 0, 10, std::vector<pbs::Polygon>{pbs::Polygon(sq)});
+  pbs::State start(1.0, 5.0), goal(9.0, 5.0);
+  double opt = pbs::VisibilityGraphPlanner().solve(env, start, goal).length;
+  pbs::RRTStarPlanner rrtstar(0.5, 0.1, 2000, 10.0);
+  rrtstar.set_optimal_cost(opt);
+  auto path = rrtstar.solve(env, start, goal);
+  ASSERT_TRUE(path.success);
+  const auto& cd = rrtstar.convergence_data();
+  ASSERT_FALSE(cd.cost_vs_iteration.empty());
+  EXPECT_GE(cd.gap_to_optimal, 0.0);
+  EXPECT_NEAR(cd.final_cost, path.length, 1e-6);
+  EXPECT_NEAR(cd.gap_to_optimal, path.length - opt, 1e-6);
+}
+
 }  // namespace